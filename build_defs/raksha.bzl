@@ -45,13 +45,32 @@ def raksha_policy_check(name, src, visibility = None):
         visibility = visibility
     )
 
-def policy_check(name, dataflow_graph, auth_logic, expect_failure = False, visibility = None):
+def policy_check(
+        name,
+        dataflow_graph,
+        auth_logic,
+        expect_failure = False,
+        midpoint_default_derivation = False,
+        profile = False,
+        openmp = False,
+        jobs = 0,
+        visibility = None):
     """ Generates a cc_test rule for verifying policy compliance.
 
     Args:
       name: String; Name of the check.
       dataflow_graph: String; The arcs manifest describing the dataflow graph.
       auth_logic: String; The file with authorization logic facts.
+      expect_failure: Boolean; Whether the policy check is expected to fail.
+      midpoint_default_derivation: Boolean; Whether to route the default
+                   dataflow of each particle through a single midpoint.
+      profile: Boolean; Whether to run the check with Souffle's profiling
+                   enabled. The profile log is written to the undeclared
+                   outputs of the test as `<name>_dl_cpp.profile.log`.
+      openmp: Boolean; Whether to evaluate the check with a parallel program
+                   compiled with OpenMP.
+      jobs: Integer; The number of threads of a check with `openmp`. 0 uses
+                   all cores.
       visibility: List; List of visibilities.
     """
     # Parse .arcs into proto
@@ -64,21 +83,28 @@ def policy_check(name, dataflow_graph, auth_logic, expect_failure = False, visib
     invert_arg = ""
     if expect_failure:
       invert_arg = "invert"
+    generator_args = ""
+    if midpoint_default_derivation:
+      generator_args += " --midpoint_default_derivation "
     # Generate datalog
     datalog_target_name = "%s_datalog" % name
     datalog_target = ":%s" % datalog_target_name
     datalog_file = "%s.dl" % name
+    # Maps the check labels in the failures of the test back to the manifest.
+    check_sources_file = "%s_check_sources.tsv" % name
     native.genrule(
         name = datalog_target_name,
         srcs = [
            auth_logic,
            proto_target,
         ],
-        outs = [datalog_file],
+        outs = [datalog_file, check_sources_file],
         cmd = "$(location //src/xform_to_datalog:generate_datalog_program) " +
                " --auth_logic_file=\"$(location %s)\" " % auth_logic +
                " --manifest_proto=\"$(location %s)\" " % proto_target +
-               " --datalog_file=\"$@\" ",
+               " --datalog_file=\"$(location %s)\" " % datalog_file +
+               " --check_sources_file=\"$(location %s)\" " % check_sources_file +
+               generator_args,
         tools = ["//src/xform_to_datalog:generate_datalog_program"],
     )
     # Generate souffle C++ library
@@ -87,6 +113,8 @@ def policy_check(name, dataflow_graph, auth_logic, expect_failure = False, visib
     souffle_cc_library(
         name = souffle_dl_cpp_target_name,
         src = datalog_target,
+        profile = profile,
+        openmp = openmp,
         included_dl_scripts = [
             "//src/analysis/souffle:authorization_logic.dl",
             "//src/analysis/souffle:dataflow_graph.dl",
@@ -101,14 +129,163 @@ def policy_check(name, dataflow_graph, auth_logic, expect_failure = False, visib
         srcs = ["//src/analysis/souffle/tests/arcs_fact_tests:fact_test_driver.cc"],
         args = [
             datalog_file.replace(".dl", "_datalog"),
-            invert_arg
+            invert_arg,
+            "profile" if profile else "",
+            "--jobs=%d" % jobs if openmp and jobs > 0 else "",
+            "--check_sources=$(location %s)" % check_sources_file,
         ],
+        data = [check_sources_file],
         copts = [
             "-Iexternal/souffle/src/include/souffle",
         ],
         linkopts = ["-pthread"],
         deps = [
+            "//src/analysis/souffle/results:findings_writer",
+            "//src/analysis/souffle/results:souffle_findings",
+            "//src/xform_to_datalog:check_sources",
             "@souffle//:souffle_include_lib",
             souffle_dl_cpp_target,
         ],
     )
+
+def _batch_analysis_programs(name, auth_logic, openmp):
+    """ Generates one Souffle program per authorization logic file.
+
+    Returns:
+      A pair of the program names and the targets of their cc libraries.
+    """
+    program_names = []
+    program_targets = []
+    for index, auth_logic_file in enumerate(auth_logic):
+        # Souffle names the program after the generated datalog target.
+        datalog_target_name = "%s_analysis_%d" % (name, index)
+        native.genrule(
+            name = datalog_target_name,
+            srcs = [auth_logic_file],
+            outs = ["%s.dl" % datalog_target_name],
+            cmd = "$(location //src/analysis/souffle/batch:generate_batch_analysis) " +
+                  " --auth_logic_file=\"$(location %s)\" " % auth_logic_file +
+                  " --datalog_file=\"$@\" ",
+            tools = ["//src/analysis/souffle/batch:generate_batch_analysis"],
+        )
+        souffle_cc_library(
+            name = "%s_dl_cpp" % datalog_target_name,
+            src = ":%s" % datalog_target_name,
+            openmp = openmp,
+            included_dl_scripts = [
+                "//src/analysis/souffle/batch:batch_analysis.dl",
+                "//src/analysis/souffle:authorization_logic.dl",
+                "//src/analysis/souffle:dataflow_graph.dl",
+                "//src/analysis/souffle:operations.dl",
+                "//src/analysis/souffle:taint.dl",
+                "//src/analysis/souffle:tags.dl",
+                "//src/analysis/souffle:may_will.dl",
+            ],
+        )
+        program_names.append(datalog_target_name)
+        program_targets.append(":%s_dl_cpp" % datalog_target_name)
+    return program_names, program_targets
+
+def _batch_analysis_args(auth_logic, program_names):
+    return [
+        "--auth_logic=" + ",".join([
+            "$(location %s)" % auth_logic_file
+            for auth_logic_file in auth_logic
+        ]),
+        "--programs=" + ",".join(program_names),
+    ]
+
+def batch_policy_check(
+        name,
+        auth_logic,
+        openmp = False,
+        visibility = None):
+    """ Generates a cc_binary that checks many manifests in one process.
+
+    The binary runs //src/analysis/souffle/batch:batch_policy_check.cc with
+    one program per authorization logic. Unlike policy_check, the manifests
+    are not compiled into the programs: the binary takes pairs of manifest
+    protos and authorization logic at runtime and reuses one instance of the
+    program of the authorization logic for all manifests checked against it.
+
+    Args:
+      name: String; Name of the binary.
+      auth_logic: List; The authorization logic files that manifests can be
+                   checked against.
+      openmp: Boolean; Whether to evaluate each program with several threads.
+      visibility: List; List of visibilities.
+    """
+    program_names, program_targets = _batch_analysis_programs(
+        name,
+        auth_logic,
+        openmp,
+    )
+    native.cc_binary(
+        name = name,
+        srcs = ["//src/analysis/souffle/batch:batch_policy_check.cc"],
+        args = _batch_analysis_args(auth_logic, program_names),
+        data = auth_logic,
+        copts = [
+            "-Iexternal/souffle/src/include/souffle",
+        ],
+        linkopts = ["-pthread"],
+        deps = [
+            "//src/analysis/souffle/batch:batch_policy_checker",
+            "//src/common/logging",
+            "@absl//absl/container:flat_hash_map",
+            "@absl//absl/flags:flag",
+            "@absl//absl/flags:parse",
+            "@absl//absl/flags:usage",
+            "@absl//absl/strings",
+        ] + program_targets,
+        visibility = visibility,
+    )
+
+def policy_check_daemon(
+        name,
+        auth_logic,
+        openmp = False,
+        visibility = None):
+    """ Generates a cc_binary that answers policy checks over a socket.
+
+    The binary runs //src/analysis/souffle/batch:policy_check_daemon.cc with
+    the same programs as batch_policy_check. It loads them and the particle
+    specs once and then checks the manifests of the requests it receives on
+    a Unix domain socket, so that each check pays neither for starting a
+    process nor for constructing a program. The particle specs are reloaded
+    on SIGHUP.
+
+    Args:
+      name: String; Name of the binary.
+      auth_logic: List; The authorization logic files that manifests can be
+                   checked against.
+      openmp: Boolean; Whether to evaluate each program with several threads.
+      visibility: List; List of visibilities.
+    """
+    program_names, program_targets = _batch_analysis_programs(
+        name,
+        auth_logic,
+        openmp,
+    )
+    native.cc_binary(
+        name = name,
+        srcs = ["//src/analysis/souffle/batch:policy_check_daemon.cc"],
+        args = _batch_analysis_args(auth_logic, program_names),
+        data = auth_logic,
+        copts = [
+            "-Iexternal/souffle/src/include/souffle",
+        ],
+        linkopts = ["-pthread"],
+        deps = [
+            "//src/analysis/souffle/batch:batch_policy_checker",
+            "//src/analysis/souffle/batch:policy_check_server",
+            "//src/common/logging",
+            "//src/ir/proto:system_spec_registry",
+            "//third_party/arcs/proto:manifest_cc_proto",
+            "@absl//absl/container:flat_hash_map",
+            "@absl//absl/flags:flag",
+            "@absl//absl/flags:parse",
+            "@absl//absl/flags:usage",
+        ] + program_targets,
+        visibility = visibility,
+    )
@@ -18,6 +18,9 @@ def souffle_cc_library(
         name,
         src,
         all_principals_own_all_tags = False,
+        precomputed_paths = False,
+        profile = False,
+        openmp = False,
         included_dl_scripts = [],
         testonly = None,
         visibility = None):
@@ -26,14 +29,41 @@ def souffle_cc_library(
     Args:
       name: String; Name of the library.
       src: String; The datalog program.
+      all_principals_own_all_tags: bool; Whether to consider all principals
+        as owning all tags. Only for tests.
+      precomputed_paths: bool; Whether to leave the path relation of
+        dataflow_graph.dl to be loaded from a precomputed closure rather
+        than deriving it (see src/xform_to_datalog/transitive_closure.h).
+      profile: bool; Whether to compile the program with profiling enabled.
+        When run, the program writes the profile log to `<name>.profile.log`
+        in its working directory. Use
+        //src/analysis/souffle/profile:rank_souffle_profile to rank its rules
+        and relations.
+      openmp: bool; Whether to generate a parallel program that is compiled
+        with OpenMP. Its number of threads is set with
+        `SouffleProgram::setNumThreads` and defaults to all cores.
       included_dl_scripts: List; List of labels indicating datalog files included by src.
       testonly: bool; Whether the generated rules should be testonly.
       visibility: List; List of visibilities.
     """
+    variant_suffix = ""
     if all_principals_own_all_tags:
-        cc_file = src + "_no_owners.cpp"
+        variant_suffix += "_no_owners"
+    if precomputed_paths:
+        variant_suffix += "_paths"
+    if profile:
+        variant_suffix += "_profile"
+    if openmp:
+        variant_suffix += "_omp"
+
+    # Souffle names the program after the generated file, up to its
+    # extension. Keep the variant suffixes in the extension, so that all
+    # variants of a program have the same name, also when `src` is the label
+    # of a generated file rather than a `.dl` file.
+    if variant_suffix and "." not in src:
+        cc_file = src + ".dl" + variant_suffix + ".cpp"
     else:
-        cc_file = src + ".cpp"
+        cc_file = src + variant_suffix + ".cpp"
 
     # If testonly was not explicitly set by the caller, set it based upon the
     # value of all_principals_own_all_tags. If the caller tried to explicitly
@@ -52,9 +82,27 @@ def souffle_cc_library(
 
     include_opts_str = " ".join(include_dir_opts)
 
-    tag_ownership_str = ""
+    macros = []
     if all_principals_own_all_tags:
-        tag_ownership_str = "--macro='ALL_PRINCIPALS_OWN_ALL_TAGS=1'"
+        macros.append("ALL_PRINCIPALS_OWN_ALL_TAGS=1")
+    if precomputed_paths:
+        macros.append("RAKSHA_PRECOMPUTED_PATHS=1")
+
+    macro_str = ""
+    if macros:
+        macro_str = "--macro='{}'".format(" ".join(macros))
+
+    profile_str = ""
+    if profile:
+        profile_str = "--profile={}.profile.log".format(name)
+
+    # Souffle only emits the OpenMP pragmas of parallel loops if it is asked
+    # for more than one job. The number of threads is chosen at runtime.
+    jobs_str = ""
+    openmp_opts = []
+    if openmp:
+        jobs_str = "--jobs=auto"
+        openmp_opts = ["-fopenmp"]
 
     native.genrule(
         name = name + "_cpp",
@@ -62,7 +110,7 @@ def souffle_cc_library(
         outs = [cc_file],
         testonly = testonly,
         cmd =
-            "$(location @souffle//:souffle) {include_str} {tag_ownership} -g $@ $(location {src_rule})".format(include_str = include_opts_str, tag_ownership = tag_ownership_str, src_rule = src),
+            "$(location @souffle//:souffle) {include_str} {macros} {profile} {jobs} -g $@ $(location {src_rule})".format(include_str = include_opts_str, macros = macro_str, profile = profile_str, jobs = jobs_str, src_rule = src),
         tools = ["@souffle//:souffle"],
         visibility = visibility,
     )
@@ -76,7 +124,8 @@ def souffle_cc_library(
             # We didn't author this C++ file, it is generated by Souffle. We
             # don't care about non-critical issues in it. Turn off warnings.
             "-w",
-        ],
+        ] + openmp_opts,
+        linkopts = openmp_opts,
         defines = [
             "__EMBEDDED_SOUFFLE__",
         ],
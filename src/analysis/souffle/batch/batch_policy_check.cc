@@ -0,0 +1,193 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Tool that checks many manifests against authorization logic in one
+// process, with the programs generated by a batch_policy_check rule. It
+// writes the result of each check as `<name>.json` to the output directory.
+//
+// The manifests and authorization logic are given either as a file with one
+// pair per line:
+//   <manifest proto> <authorization logic> [<name>]
+// or as a directory in which each `<name>.binarypb` manifest proto is
+// checked against `<name>.authlogic`. The authorization logic of each pair
+// must be identical to one that the rule generated a program for.
+//
+// Example:
+//   bazel run -c opt
+//     //src/analysis/souffle/examples/multimic:multimic_batch --
+//     --pairs_file=/tmp/pairs.txt --output_dir=/tmp/results --threads=8
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "src/analysis/souffle/batch/batch_policy_checker.h"
+#include "src/common/logging/logging.h"
+
+ABSL_FLAG(std::vector<std::string>, auth_logic, {},
+          "The authorization logic files that programs were generated for.");
+ABSL_FLAG(std::vector<std::string>, programs, {},
+          "The names of the programs generated for each of --auth_logic.");
+ABSL_FLAG(std::string, pairs_file, "",
+          "A file with one `<manifest proto> <authorization logic> [<name>]` "
+          "pair to check per line.");
+ABSL_FLAG(std::string, pairs_dir, "",
+          "A directory in which to check each `<name>.binarypb` manifest "
+          "proto against `<name>.authlogic`.");
+ABSL_FLAG(std::string, output_dir, "",
+          "The directory to write the `<name>.json` results to.");
+ABSL_FLAG(int, threads, std::thread::hardware_concurrency(),
+          "The number of manifests to check in parallel.");
+ABSL_FLAG(bool, midpoint_default_derivation, false,
+          "Route the default dataflow of each particle through a single "
+          "midpoint access path instead of drawing an edge from every input "
+          "to every output.");
+
+constexpr char kUsageMessage[] =
+    "This tool checks many manifests against authorization logic in one "
+    "process.";
+
+namespace {
+
+using raksha::analysis::batch::PolicyCheckPair;
+using raksha::analysis::batch::PolicyCheckResult;
+
+std::optional<std::string> ReadFile(const std::filesystem::path &path) {
+  std::ifstream stream(path, std::ios::in | std::ios::binary);
+  if (!stream) {
+    LOG(ERROR) << "Error reading " << path << ":" << strerror(errno);
+    return std::nullopt;
+  }
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+std::optional<std::vector<PolicyCheckPair>> ReadPairsFile(
+    const std::filesystem::path &pairs_file) {
+  std::optional<std::string> contents = ReadFile(pairs_file);
+  if (!contents.has_value()) return std::nullopt;
+  std::vector<PolicyCheckPair> pairs;
+  for (absl::string_view line : absl::StrSplit(*contents, '\n')) {
+    std::vector<std::string> fields =
+        absl::StrSplit(line, ' ', absl::SkipWhitespace());
+    if (fields.empty() || fields.front().front() == '#') continue;
+    if (fields.size() < 2 || fields.size() > 3) {
+      LOG(ERROR) << "Malformed line in " << pairs_file << ": " << line;
+      return std::nullopt;
+    }
+    std::filesystem::path manifest_proto(fields[0]);
+    std::filesystem::path auth_logic(fields[1]);
+    std::string name = (fields.size() == 3)
+                           ? fields[2]
+                           : absl::StrCat(manifest_proto.stem().string(), "-",
+                                          auth_logic.stem().string());
+    pairs.push_back({.name = std::move(name),
+                     .manifest_proto = std::move(manifest_proto),
+                     .auth_logic = std::move(auth_logic)});
+  }
+  return pairs;
+}
+
+std::vector<PolicyCheckPair> ReadPairsDir(
+    const std::filesystem::path &pairs_dir) {
+  std::vector<PolicyCheckPair> pairs;
+  for (const auto &entry : std::filesystem::directory_iterator(pairs_dir)) {
+    if (entry.path().extension() != ".binarypb") continue;
+    std::filesystem::path auth_logic = entry.path();
+    auth_logic.replace_extension(".authlogic");
+    pairs.push_back({.name = entry.path().stem().string(),
+                     .manifest_proto = entry.path(),
+                     .auth_logic = std::move(auth_logic)});
+  }
+  std::sort(pairs.begin(), pairs.end(),
+            [](const PolicyCheckPair &lhs, const PolicyCheckPair &rhs) {
+              return lhs.name < rhs.name;
+            });
+  return pairs;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("batch_policy_check");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::vector<std::string> auth_logic_files = absl::GetFlag(FLAGS_auth_logic);
+  std::vector<std::string> programs = absl::GetFlag(FLAGS_programs);
+  if (auth_logic_files.size() != programs.size()) {
+    LOG(ERROR) << "--auth_logic and --programs must have the same length.";
+    return 1;
+  }
+  absl::flat_hash_map<std::string, std::string> programs_by_auth_logic;
+  for (size_t i = 0; i < programs.size(); ++i) {
+    std::optional<std::string> auth_logic = ReadFile(auth_logic_files[i]);
+    if (!auth_logic.has_value()) return 1;
+    programs_by_auth_logic[*auth_logic] = programs[i];
+  }
+
+  std::string pairs_file = absl::GetFlag(FLAGS_pairs_file);
+  std::string pairs_dir = absl::GetFlag(FLAGS_pairs_dir);
+  if (pairs_file.empty() == pairs_dir.empty()) {
+    LOG(ERROR) << "Exactly one of --pairs_file and --pairs_dir must be given.";
+    return 1;
+  }
+  std::optional<std::vector<PolicyCheckPair>> pairs =
+      pairs_file.empty() ? ReadPairsDir(pairs_dir) : ReadPairsFile(pairs_file);
+  if (!pairs.has_value()) return 1;
+
+  std::filesystem::path output_dir(absl::GetFlag(FLAGS_output_dir));
+  if (output_dir.empty()) {
+    LOG(ERROR) << "--output_dir must be given.";
+    return 1;
+  }
+  std::filesystem::create_directories(output_dir);
+
+  raksha::analysis::batch::BatchPolicyChecker checker(
+      std::move(programs_by_auth_logic),
+      absl::GetFlag(FLAGS_midpoint_default_derivation)
+          ? raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint
+          : raksha::ir::ParticleSpec::DefaultDerivationMode::kCartesian,
+      absl::GetFlag(FLAGS_threads));
+  bool all_checked = true;
+  checker.CheckAll(*pairs, [&](PolicyCheckResult result) {
+    std::filesystem::path result_path =
+        output_dir / absl::StrCat(result.name, ".json");
+    std::ofstream result_file(result_path, std::ios::out | std::ios::trunc);
+    result_file << result.ToJson() << "\n";
+    if (!result_file) {
+      LOG(ERROR) << "Error writing " << result_path << ":" << strerror(errno);
+      all_checked = false;
+    }
+    if (result.status == PolicyCheckResult::Status::kError) {
+      LOG(ERROR) << result.name << ": " << result.error;
+      all_checked = false;
+    }
+    std::cout << result.name << " "
+              << raksha::analysis::batch::PolicyCheckStatusName(result.status)
+              << std::endl;
+  });
+  return all_checked ? 0 : 1;
+}
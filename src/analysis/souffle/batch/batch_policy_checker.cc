@@ -0,0 +1,206 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/batch_policy_checker.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <thread>
+
+#include "absl/strings/str_cat.h"
+#include "souffle/SouffleInterface.h"
+#include "src/analysis/souffle/batch/check_evaluation.h"
+#include "src/analysis/souffle/batch/policy_facts.h"
+#include "src/analysis/souffle/results/souffle_findings.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+
+namespace raksha::analysis::batch {
+
+namespace {
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+std::optional<std::string> ReadFile(const std::filesystem::path &path) {
+  std::ifstream stream(path, std::ios::in | std::ios::binary);
+  if (!stream) return std::nullopt;
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+void InsertFacts(const PolicyFacts &facts, souffle::SouffleProgram &prog) {
+  for (const auto &[relation_name, tuples] : facts.relations()) {
+    souffle::Relation *relation =
+        CHECK_NOTNULL(prog.getRelation(relation_name));
+    for (const PolicyFacts::Tuple &fact : tuples) {
+      souffle::tuple tuple(relation);
+      for (const std::string &argument : fact) tuple << argument;
+      relation->insert(tuple);
+    }
+  }
+}
+
+// Reads the tuples of a relation of symbols, calling `add` with the
+// arguments of each of them.
+template <size_t kArity, typename Add>
+void ReadRelation(const souffle::SouffleProgram &prog,
+                  absl::string_view relation_name, Add add) {
+  souffle::Relation *relation =
+      CHECK_NOTNULL(prog.getRelation(std::string(relation_name)));
+  CHECK_EQ(relation->getArity(), kArity);
+  std::array<std::string, kArity> arguments;
+  for (souffle::tuple &tuple : *relation) {
+    for (std::string &argument : arguments) tuple >> argument;
+    add(arguments);
+  }
+}
+
+}  // namespace
+
+void BatchPolicyChecker::CheckAll(
+    const std::vector<PolicyCheckPair> &pairs,
+    const std::function<void(PolicyCheckResult)> &on_result) const {
+  std::atomic<size_t> next_pair = 0;
+  std::mutex on_result_mutex;
+  auto work = [&]() {
+    ProgramCache programs;
+    for (size_t index = next_pair++; index < pairs.size();
+         index = next_pair++) {
+      PolicyCheckResult result = Check(pairs[index], programs);
+      std::lock_guard<std::mutex> lock(on_result_mutex);
+      on_result(std::move(result));
+    }
+  };
+  std::vector<std::thread> workers;
+  for (int i = 1; i < num_threads_; ++i) workers.emplace_back(work);
+  work();
+  for (std::thread &worker : workers) worker.join();
+}
+
+PolicyCheckResult BatchPolicyChecker::Check(const PolicyCheckPair &pair,
+                                            ProgramCache &programs) const {
+  PolicyCheckResult result{.name = pair.name,
+                           .manifest_proto = pair.manifest_proto.string(),
+                           .auth_logic = pair.auth_logic.string()};
+
+  std::optional<std::string> auth_logic = ReadFile(pair.auth_logic);
+  if (!auth_logic.has_value()) {
+    result.error = absl::StrCat("Cannot read ", pair.auth_logic.string());
+    return result;
+  }
+  std::unique_ptr<ir::proto::ManifestFile> manifest_file =
+      ir::proto::ManifestFile::Load(pair.manifest_proto);
+  if (manifest_file == nullptr) {
+    result.error = absl::StrCat("Cannot parse the manifest proto ",
+                                pair.manifest_proto.string());
+    return result;
+  }
+  const arcs::ManifestProto &manifest_proto = manifest_file->manifest_proto();
+  std::unique_ptr<ir::SystemSpec> system_spec =
+      ir::proto::Decode(manifest_proto, default_derivation_mode_);
+  if (system_spec == nullptr) {
+    result.error = "Cannot decode the particle specs of the manifest";
+    return result;
+  }
+  CheckManifest(manifest_proto, *system_spec, *auth_logic, programs, result);
+  return result;
+}
+
+void BatchPolicyChecker::CheckManifest(
+    const arcs::ManifestProto &manifest_proto,
+    const ir::SystemSpec &system_spec, absl::string_view auth_logic,
+    ProgramCache &programs, PolicyCheckResult &result) const {
+  result.status = PolicyCheckResult::Status::kError;
+  auto find_result = programs_by_auth_logic_.find(auth_logic);
+  if (find_result == programs_by_auth_logic_.end()) {
+    result.error = "No program was generated for the authorization logic";
+    return;
+  }
+  result.program = find_result->second;
+
+  // CreateFromManifestProto expects the spec of every particle to exist.
+  for (const arcs::RecipeProto &recipe : manifest_proto.recipes()) {
+    for (const arcs::ParticleProto &particle : recipe.particles()) {
+      if (system_spec.GetParticleSpec(particle.spec_name()) == nullptr) {
+        result.error = absl::StrCat("Unknown particle spec ",
+                                    particle.spec_name(), " in recipe ",
+                                    recipe.name());
+        return;
+      }
+    }
+  }
+
+  PolicyFacts facts = PolicyFacts::Create(
+      xform_to_datalog::ManifestDatalogFacts::CreateFromManifestProto(
+          system_spec, manifest_proto));
+  result.num_facts = facts.NumFacts();
+  result.num_checks = facts.checks().size();
+
+  // The relations of a reused instance still hold the tuples of its last
+  // run. Output relations are kept by the run, and so may be others if the
+  // program was compiled with a different purging strategy.
+  std::unique_ptr<souffle::SouffleProgram> &prog = programs[result.program];
+  if (prog == nullptr) {
+    prog.reset(souffle::ProgramFactory::newInstance(result.program));
+    if (prog == nullptr) {
+      result.error = absl::StrCat("Program ", result.program,
+                                  " is not linked into this binary");
+      return;
+    }
+  } else {
+    prog->purgeInputRelations();
+    prog->purgeInternalRelations();
+    prog->purgeOutputRelations();
+  }
+
+  auto load_start = std::chrono::steady_clock::now();
+  InsertFacts(facts, *prog);
+  result.load_ms = MillisecondsSince(load_start);
+
+  auto run_start = std::chrono::steady_clock::now();
+  prog->run();
+  result.run_ms = MillisecondsSince(run_start);
+
+  auto evaluate_start = std::chrono::steady_clock::now();
+  CheckedAccessPaths checked_access_paths(facts.checks());
+  ReadRelation<2>(*prog, "ownsAccessPath", [&](const auto &arguments) {
+    checked_access_paths.AddOwner(arguments[0], arguments[1]);
+  });
+  ReadRelation<3>(*prog, "mayHaveTag", [&](const auto &arguments) {
+    checked_access_paths.AddMayHaveTag(arguments[0], arguments[1],
+                                       arguments[2]);
+  });
+  result.check_failures = checked_access_paths.Evaluate(facts.checks());
+  results::ForEachDisallowedUsage(*prog, [&](const DisallowedUsage &usage) {
+    result.disallowed_usages.push_back(usage);
+  });
+  result.evaluate_ms = MillisecondsSince(evaluate_start);
+  result.SetStatusFromFindings();
+}
+
+}  // namespace raksha::analysis::batch
@@ -0,0 +1,104 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_BATCH_BATCH_POLICY_CHECKER_H_
+#define SRC_ANALYSIS_SOUFFLE_BATCH_BATCH_POLICY_CHECKER_H_
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "src/analysis/souffle/batch/policy_check_result.h"
+#include "src/ir/particle_spec.h"
+#include "src/ir/system_spec.h"
+#include "third_party/arcs/proto/manifest.pb.h"
+
+namespace souffle {
+class SouffleProgram;
+}  // namespace souffle
+
+namespace raksha::analysis::batch {
+
+// A manifest to check against an authorization logic.
+struct PolicyCheckPair {
+  // Names the result of the check.
+  std::string name;
+  std::filesystem::path manifest_proto;
+  std::filesystem::path auth_logic;
+};
+
+// Checks many manifests in one process. It runs programs generated from
+// batch_analysis.dl, one per authorization logic, on the facts of each
+// manifest. Each worker thread keeps one instance of each program it has
+// used and purges its relations between runs, rather than constructing a
+// new one per manifest.
+class BatchPolicyChecker {
+ public:
+  // The program instances of one thread, by name. An instance may only be
+  // used by one thread at a time. Code that destroys a cache must include
+  // souffle/SouffleInterface.h.
+  using ProgramCache =
+      absl::flat_hash_map<std::string,
+                          std::unique_ptr<souffle::SouffleProgram>>;
+
+  // `programs_by_auth_logic` maps the contents of each authorization logic
+  // file to the name of the program generated from it.
+  BatchPolicyChecker(
+      absl::flat_hash_map<std::string, std::string> programs_by_auth_logic,
+      ir::ParticleSpec::DefaultDerivationMode default_derivation_mode,
+      int num_threads)
+      : programs_by_auth_logic_(std::move(programs_by_auth_logic)),
+        default_derivation_mode_(default_derivation_mode),
+        num_threads_(std::max(num_threads, 1)) {}
+
+  // Checks all pairs on the worker threads. `on_result` is called once per
+  // pair as soon as it is checked, from one thread at a time but in no
+  // particular order.
+  void CheckAll(const std::vector<PolicyCheckPair> &pairs,
+                const std::function<void(PolicyCheckResult)> &on_result) const;
+
+  // Checks one pair with the programs of a worker, which are created as
+  // needed.
+  PolicyCheckResult Check(const PolicyCheckPair &pair,
+                          ProgramCache &programs) const;
+
+  // Checks the recipes of `manifest_proto`, whose particle specs are those
+  // of `system_spec`, against the authorization logic with the contents
+  // `auth_logic`. Sets the fields of `result` other than the name and
+  // paths.
+  void CheckManifest(const arcs::ManifestProto &manifest_proto,
+                     const ir::SystemSpec &system_spec,
+                     absl::string_view auth_logic, ProgramCache &programs,
+                     PolicyCheckResult &result) const;
+
+  ir::ParticleSpec::DefaultDerivationMode default_derivation_mode() const {
+    return default_derivation_mode_;
+  }
+
+ private:
+  absl::flat_hash_map<std::string, std::string> programs_by_auth_logic_;
+  ir::ParticleSpec::DefaultDerivationMode default_derivation_mode_;
+  int num_threads_;
+};
+
+}  // namespace raksha::analysis::batch
+
+#endif  // SRC_ANALYSIS_SOUFFLE_BATCH_BATCH_POLICY_CHECKER_H_
@@ -0,0 +1,70 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/check_evaluation.h"
+
+#include <algorithm>
+
+namespace raksha::analysis::batch {
+
+CheckedAccessPaths::CheckedAccessPaths(
+    const std::vector<PolicyFacts::Check> &checks) {
+  for (const PolicyFacts::Check &check : checks) {
+    access_paths_[check.access_path];
+  }
+}
+
+void CheckedAccessPaths::AddOwner(absl::string_view owner,
+                                  absl::string_view path) {
+  auto find_result = access_paths_.find(path);
+  if (find_result == access_paths_.end()) return;
+  find_result->second.owners.push_back(std::string(owner));
+}
+
+void CheckedAccessPaths::AddMayHaveTag(absl::string_view path,
+                                       absl::string_view owner,
+                                       absl::string_view tag) {
+  auto find_result = access_paths_.find(path);
+  if (find_result == access_paths_.end()) return;
+  find_result->second.owned_tags.insert(
+      {std::string(owner), std::string(tag)});
+}
+
+std::vector<CheckFailure> CheckedAccessPaths::Evaluate(
+    const std::vector<PolicyFacts::Check> &checks) const {
+  std::vector<CheckFailure> failures;
+  for (const PolicyFacts::Check &check : checks) {
+    const AccessPathResults &results = access_paths_.at(check.access_path);
+    // Relations are sets, so the owners are sorted and deduplicated to make
+    // the failures independent of the order they were read in.
+    std::vector<std::string> owners = results.owners;
+    std::sort(owners.begin(), owners.end());
+    owners.erase(std::unique(owners.begin(), owners.end()), owners.end());
+    for (const std::string &owner : owners) {
+      auto tag_may_be_present = [&](absl::string_view tag) {
+        return results.owned_tags.contains(
+            std::make_pair(owner, std::string(tag)));
+      };
+      if (check.predicate->IsSatisfied(tag_may_be_present)) continue;
+      failures.push_back(CheckFailure{.check_label = check.label,
+                                      .owner = owner,
+                                      .access_path = check.access_path});
+    }
+  }
+  return failures;
+}
+
+}  // namespace raksha::analysis::batch
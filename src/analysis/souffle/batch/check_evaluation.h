@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_BATCH_CHECK_EVALUATION_H_
+#define SRC_ANALYSIS_SOUFFLE_BATCH_CHECK_EVALUATION_H_
+
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "src/analysis/souffle/batch/policy_facts.h"
+#include "src/analysis/souffle/results/policy_check_findings.h"
+
+namespace raksha::analysis::batch {
+
+// The checks are evaluated here rather than by the program, but their
+// failures are those of its checkFailure relation.
+using CheckFailure = results::CheckFailure;
+
+// The parts of the results of the analysis that checks depend on, limited to
+// the access paths of the checks.
+class CheckedAccessPaths {
+ public:
+  explicit CheckedAccessPaths(const std::vector<PolicyFacts::Check> &checks);
+
+  // Whether `path` is the access path of a check. The results of other
+  // access paths need not be added.
+  bool IsChecked(absl::string_view path) const {
+    return access_paths_.contains(path);
+  }
+
+  // Adds an ownsAccessPath tuple.
+  void AddOwner(absl::string_view owner, absl::string_view path);
+  // Adds a mayHaveTag tuple.
+  void AddMayHaveTag(absl::string_view path, absl::string_view owner,
+                     absl::string_view tag);
+
+  // Returns the failures of `checks` in the order of the checks and, for
+  // each check, of the owners.
+  std::vector<CheckFailure> Evaluate(
+      const std::vector<PolicyFacts::Check> &checks) const;
+
+ private:
+  struct AccessPathResults {
+    std::vector<std::string> owners;
+    absl::flat_hash_set<std::pair<std::string, std::string>> owned_tags;
+  };
+
+  absl::flat_hash_map<std::string, AccessPathResults> access_paths_;
+};
+
+}  // namespace raksha::analysis::batch
+
+#endif  // SRC_ANALYSIS_SOUFFLE_BATCH_CHECK_EVALUATION_H_
@@ -0,0 +1,70 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/check_evaluation.h"
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::analysis::batch {
+
+class CheckedAccessPathsTest : public testing::Test {
+ public:
+  CheckedAccessPathsTest()
+      : tag_present_("tag"),
+        tag_absent_(std::make_unique<ir::TagPresence>("tag")),
+        checks_({{.label = "check_num_0",
+                  .access_path = "R.P#0.in",
+                  .predicate = &tag_present_},
+                 {.label = "check_num_1",
+                  .access_path = "R.P#0.in",
+                  .predicate = &tag_absent_}}),
+        results_(checks_) {}
+
+ protected:
+  ir::TagPresence tag_present_;
+  ir::Not tag_absent_;
+  std::vector<PolicyFacts::Check> checks_;
+  CheckedAccessPaths results_;
+};
+
+TEST_F(CheckedAccessPathsTest, KnowsCheckedAccessPaths) {
+  EXPECT_TRUE(results_.IsChecked("R.P#0.in"));
+  EXPECT_FALSE(results_.IsChecked("R.P#0.out"));
+}
+
+TEST_F(CheckedAccessPathsTest, ChecksWithoutOwnersCannotFail) {
+  EXPECT_THAT(results_.Evaluate(checks_), testing::IsEmpty());
+}
+
+TEST_F(CheckedAccessPathsTest, EvaluatesPredicatesPerOwner) {
+  results_.AddOwner("UserB", "R.P#0.in");
+  results_.AddOwner("UserA", "R.P#0.in");
+  results_.AddOwner("UserA", "R.P#0.in");
+  results_.AddOwner("UserC", "R.P#0.out");
+  results_.AddMayHaveTag("R.P#0.in", "UserA", "tag");
+  results_.AddMayHaveTag("R.P#0.in", "UserB", "other_tag");
+  results_.AddMayHaveTag("R.P#0.out", "UserB", "tag");
+  EXPECT_THAT(results_.Evaluate(checks_),
+              testing::ElementsAre(
+                  CheckFailure{.check_label = "check_num_0",
+                               .owner = "UserB",
+                               .access_path = "R.P#0.in"},
+                  CheckFailure{.check_label = "check_num_1",
+                               .owner = "UserA",
+                               .access_path = "R.P#0.in"}));
+}
+
+}  // namespace raksha::analysis::batch
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Tool that generates the Souffle program that the batch policy checker runs
+// for one authorization logic: batch_analysis.dl followed by the Datalog
+// compiled from the authorization logic.
+
+#include <filesystem>
+#include <fstream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/common/logging/logging.h"
+#include "src/xform_to_datalog/authorization_logic_datalog_facts.h"
+
+ABSL_FLAG(std::string, auth_logic_file, "",
+          "The file with authorization logic facts.");
+ABSL_FLAG(std::string, datalog_file, "", "The datalog file to write.");
+
+constexpr char kUsageMessage[] =
+    "This tool generates the program of the batch policy checker for an "
+    "authorization logic.";
+
+constexpr char kDatalogFileFormat[] = R"(// GENERATED FILE, DO NOT EDIT!
+
+#include "batch_analysis.dl"
+
+// Authorization Logic
+)";
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("generate_batch_analysis");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::filesystem::path auth_logic_filepath(
+      absl::GetFlag(FLAGS_auth_logic_file));
+  if (!std::filesystem::exists(auth_logic_filepath)) {
+    LOG(ERROR) << "Authorization logic file " << auth_logic_filepath
+               << " does not exist!";
+    return 1;
+  }
+  std::filesystem::path auth_logic_filename = auth_logic_filepath.filename();
+  auth_logic_filepath.remove_filename();
+  std::optional<raksha::xform_to_datalog::AuthorizationLogicDatalogFacts>
+      auth_logic_datalog_facts =
+          raksha::xform_to_datalog::AuthorizationLogicDatalogFacts::create(
+              auth_logic_filepath.c_str(), auth_logic_filename.c_str());
+  if (!auth_logic_datalog_facts.has_value()) {
+    LOG(ERROR) << "Unable to parse authorization logic file.\n";
+    return 1;
+  }
+
+  std::filesystem::path datalog_filepath(absl::GetFlag(FLAGS_datalog_file));
+  std::ofstream datalog_file(datalog_filepath, std::ios::out | std::ios::trunc |
+                                                   std::ios::binary);
+  if (!datalog_file) {
+    LOG(ERROR) << "Error creating " << datalog_filepath << " :"
+               << strerror(errno);
+    return 1;
+  }
+  datalog_file << kDatalogFileFormat << auth_logic_datalog_facts->ToDatalog();
+  return 0;
+}
@@ -0,0 +1,150 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Daemon that answers policy checks over a Unix domain socket, with the
+// programs generated by a policy_check_daemon rule. Each request carries a
+// manifest proto and the contents of an authorization logic that the rule
+// generated a program for; see policy_check_service.proto. Manifests without
+// particle specs are checked against those of --particle_specs. The daemon
+// reloads them when it receives SIGHUP, decoding only the particle specs that
+// changed, while it keeps answering requests.
+//
+// Example:
+//   bazel run -c opt
+//     //src/analysis/souffle/examples/multimic:multimic_daemon --
+//     --socket=/tmp/raksha.sock --particle_specs=/tmp/specs.binarypb
+
+#include <signal.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/analysis/souffle/batch/batch_policy_checker.h"
+#include "src/analysis/souffle/batch/policy_check_server.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/system_spec_registry.h"
+#include "third_party/arcs/proto/manifest.pb.h"
+
+ABSL_FLAG(std::vector<std::string>, auth_logic, {},
+          "The authorization logic files that programs were generated for.");
+ABSL_FLAG(std::vector<std::string>, programs, {},
+          "The names of the programs generated for each of --auth_logic.");
+ABSL_FLAG(std::string, particle_specs, "",
+          "A manifest proto with the particle specs of requests whose "
+          "manifests have none. It is read again on SIGHUP.");
+ABSL_FLAG(std::string, socket, "", "The Unix domain socket to listen on.");
+ABSL_FLAG(int, workers, std::thread::hardware_concurrency(),
+          "The number of connections to serve in parallel.");
+ABSL_FLAG(bool, midpoint_default_derivation, false,
+          "Route the default dataflow of each particle through a single "
+          "midpoint access path instead of drawing an edge from every input "
+          "to every output.");
+
+constexpr char kUsageMessage[] =
+    "This tool answers policy checks over a Unix domain socket.";
+
+namespace {
+
+std::optional<std::string> ReadFile(const std::filesystem::path &path) {
+  std::ifstream stream(path, std::ios::in | std::ios::binary);
+  if (!stream) {
+    LOG(ERROR) << "Error reading " << path << ":" << strerror(errno);
+    return std::nullopt;
+  }
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+bool ReloadParticleSpecs(const std::filesystem::path &path,
+                         raksha::ir::proto::SystemSpecRegistry &registry) {
+  std::optional<std::string> contents = ReadFile(path);
+  if (!contents.has_value()) return false;
+  arcs::ManifestProto manifest_proto;
+  if (!manifest_proto.ParseFromString(*contents)) {
+    LOG(ERROR) << "Error parsing the manifest proto " << path;
+    return false;
+  }
+  std::optional<raksha::ir::proto::SystemSpecReloadStats> stats =
+      registry.Reload(manifest_proto);
+  if (!stats.has_value()) return false;
+  LOG(INFO) << "Loaded version " << stats->version << " of the particle specs: "
+            << stats->num_decoded << " decoded, " << stats->num_reused
+            << " reused, " << stats->num_removed << " removed.";
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("policy_check_daemon");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::vector<std::string> auth_logic_files = absl::GetFlag(FLAGS_auth_logic);
+  std::vector<std::string> programs = absl::GetFlag(FLAGS_programs);
+  if (auth_logic_files.size() != programs.size()) {
+    LOG(ERROR) << "--auth_logic and --programs must have the same length.";
+    return 1;
+  }
+  absl::flat_hash_map<std::string, std::string> programs_by_auth_logic;
+  for (size_t i = 0; i < programs.size(); ++i) {
+    std::optional<std::string> auth_logic = ReadFile(auth_logic_files[i]);
+    if (!auth_logic.has_value()) return 1;
+    programs_by_auth_logic[*auth_logic] = programs[i];
+  }
+
+  std::string socket_path = absl::GetFlag(FLAGS_socket);
+  if (socket_path.empty()) {
+    LOG(ERROR) << "--socket must be given.";
+    return 1;
+  }
+
+  raksha::ir::ParticleSpec::DefaultDerivationMode default_derivation_mode =
+      absl::GetFlag(FLAGS_midpoint_default_derivation)
+          ? raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint
+          : raksha::ir::ParticleSpec::DefaultDerivationMode::kCartesian;
+  raksha::ir::proto::SystemSpecRegistry registry(default_derivation_mode);
+  std::string particle_specs = absl::GetFlag(FLAGS_particle_specs);
+  if (!particle_specs.empty()) {
+    if (!ReloadParticleSpecs(particle_specs, registry)) return 1;
+    // SIGHUP is blocked in all threads and handled by this one, which keeps
+    // running until the process exits.
+    sigset_t reload_signals;
+    sigemptyset(&reload_signals);
+    sigaddset(&reload_signals, SIGHUP);
+    pthread_sigmask(SIG_BLOCK, &reload_signals, nullptr);
+    std::thread([reload_signals, particle_specs, &registry]() {
+      int signal;
+      while (sigwait(&reload_signals, &signal) == 0) {
+        // A failed reload keeps the particle specs that are being served.
+        ReloadParticleSpecs(particle_specs, registry);
+      }
+    }).detach();
+  }
+
+  raksha::analysis::batch::BatchPolicyChecker checker(
+      std::move(programs_by_auth_logic), default_derivation_mode,
+      /*num_threads=*/1);
+  raksha::analysis::batch::PolicyCheckServer server(
+      checker, registry, absl::GetFlag(FLAGS_workers));
+  LOG(INFO) << "Serving policy checks on " << socket_path;
+  return server.Serve(socket_path) ? 0 : 1;
+}
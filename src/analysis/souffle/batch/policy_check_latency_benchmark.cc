@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Measures the latency of a running policy check daemon. It sends the same
+// request --requests times over --concurrency connections and prints a
+// JSON object with the latency percentiles and the throughput. Comparing
+// the latency with the run time of a policy_check test of the same manifest
+// shows what the daemon saves on startup and program construction.
+//
+// Example:
+//   bazel run -c opt
+//     //src/analysis/souffle/batch:policy_check_latency_benchmark --
+//     --socket=/tmp/raksha.sock --manifest_proto=/tmp/multimic.binarypb
+//     --auth_logic=/tmp/multimic.authlogic --requests=1000 --concurrency=4
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/analysis/souffle/batch/policy_check_protocol.h"
+#include "src/analysis/souffle/batch/policy_check_service.pb.h"
+#include "src/common/logging/logging.h"
+
+ABSL_FLAG(std::string, socket, "", "The socket of the daemon.");
+ABSL_FLAG(std::string, manifest_proto, "", "The manifest proto to check.");
+ABSL_FLAG(std::string, auth_logic, "",
+          "The authorization logic to check the manifest against.");
+ABSL_FLAG(int, requests, 100, "The number of requests to send.");
+ABSL_FLAG(int, concurrency, 1, "The number of connections to send over.");
+
+constexpr char kUsageMessage[] =
+    "This tool measures the latency of a running policy check daemon.";
+
+namespace {
+
+using raksha::analysis::batch::MessageStream;
+using raksha::analysis::batch::PolicyCheckRequest;
+using raksha::analysis::batch::PolicyCheckResponse;
+
+std::optional<std::string> ReadFile(const std::filesystem::path &path) {
+  std::ifstream stream(path, std::ios::in | std::ios::binary);
+  if (!stream) {
+    LOG(ERROR) << "Error reading " << path << ":" << strerror(errno);
+    return std::nullopt;
+  }
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+// Returns the `percentile` of the sorted `latencies_ms`.
+double Percentile(const std::vector<double> &latencies_ms, double percentile) {
+  if (latencies_ms.empty()) return 0;
+  size_t index = static_cast<size_t>(percentile / 100 * latencies_ms.size());
+  return latencies_ms[std::min(index, latencies_ms.size() - 1)];
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("policy_check_latency_benchmark");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  PolicyCheckRequest request;
+  request.set_name("latency_benchmark");
+  std::optional<std::string> manifest =
+      ReadFile(absl::GetFlag(FLAGS_manifest_proto));
+  std::optional<std::string> auth_logic =
+      ReadFile(absl::GetFlag(FLAGS_auth_logic));
+  if (!manifest.has_value() || !auth_logic.has_value()) return 1;
+  if (!request.mutable_manifest()->ParseFromString(*manifest)) {
+    LOG(ERROR) << "Error parsing the manifest proto.";
+    return 1;
+  }
+  request.set_auth_logic(*auth_logic);
+
+  int num_requests = absl::GetFlag(FLAGS_requests);
+  int concurrency = std::max(absl::GetFlag(FLAGS_concurrency), 1);
+  std::vector<std::vector<double>> latencies_ms(concurrency);
+  std::atomic<int> next_request = 0;
+  std::atomic<int> num_errors = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> clients;
+  for (int i = 0; i < concurrency; ++i) {
+    clients.emplace_back([&, i]() {
+      int fd = raksha::analysis::batch::ConnectToUnixSocket(
+          absl::GetFlag(FLAGS_socket));
+      if (fd < 0) {
+        ++num_errors;
+        return;
+      }
+      MessageStream stream(fd);
+      PolicyCheckResponse response;
+      bool clean_eof;
+      while (next_request++ < num_requests) {
+        auto request_start = std::chrono::steady_clock::now();
+        if (!stream.Write(request) || !stream.Read(response, clean_eof)) {
+          ++num_errors;
+          return;
+        }
+        latencies_ms[i].push_back(
+            std::chrono::duration<double, std::milli>(
+                std::chrono::steady_clock::now() - request_start)
+                .count());
+        if (response.status() == PolicyCheckResponse::STATUS_ERROR) {
+          LOG(ERROR) << "The check failed: " << response.error();
+          ++num_errors;
+        }
+      }
+    });
+  }
+  for (std::thread &client : clients) client.join();
+  double total_s = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+
+  std::vector<double> all_latencies_ms;
+  for (const std::vector<double> &client_latencies_ms : latencies_ms) {
+    all_latencies_ms.insert(all_latencies_ms.end(),
+                            client_latencies_ms.begin(),
+                            client_latencies_ms.end());
+  }
+  std::sort(all_latencies_ms.begin(), all_latencies_ms.end());
+  std::cout << "{\"requests\": " << all_latencies_ms.size()
+            << ", \"concurrency\": " << concurrency
+            << ", \"errors\": " << num_errors
+            << ", \"p50_ms\": " << Percentile(all_latencies_ms, 50)
+            << ", \"p90_ms\": " << Percentile(all_latencies_ms, 90)
+            << ", \"p99_ms\": " << Percentile(all_latencies_ms, 99)
+            << ", \"max_ms\": "
+            << (all_latencies_ms.empty() ? 0 : all_latencies_ms.back())
+            << ", \"requests_per_s\": " << all_latencies_ms.size() / total_s
+            << "}" << std::endl;
+  return num_errors == 0 ? 0 : 1;
+}
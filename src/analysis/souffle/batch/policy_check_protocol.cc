@@ -0,0 +1,138 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/policy_check_protocol.h"
+
+#include <google/protobuf/util/delimited_message_util.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "src/common/logging/logging.h"
+
+namespace raksha::analysis::batch {
+
+namespace {
+
+// Fills `address` with the Unix domain socket address of `path`. Returns
+// false if the path is too long for it.
+bool MakeUnixSocketAddress(const std::filesystem::path &path,
+                           sockaddr_un &address) {
+  std::memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  const std::string &path_string = path.native();
+  if (path_string.size() >= sizeof(address.sun_path)) {
+    LOG(ERROR) << "The socket path " << path << " is too long.";
+    return false;
+  }
+  std::memcpy(address.sun_path, path_string.c_str(), path_string.size());
+  return true;
+}
+
+PolicyCheckResponse::Status ToProto(PolicyCheckResult::Status status) {
+  switch (status) {
+    case PolicyCheckResult::Status::kPass:
+      return PolicyCheckResponse::STATUS_PASS;
+    case PolicyCheckResult::Status::kFail:
+      return PolicyCheckResponse::STATUS_FAIL;
+    case PolicyCheckResult::Status::kError:
+      return PolicyCheckResponse::STATUS_ERROR;
+  }
+  return PolicyCheckResponse::STATUS_UNSPECIFIED;
+}
+
+}  // namespace
+
+MessageStream::~MessageStream() { close(fd_); }
+
+bool MessageStream::Write(const google::protobuf::MessageLite &message) {
+  return google::protobuf::util::SerializeDelimitedToFileDescriptor(message,
+                                                                    fd_);
+}
+
+bool MessageStream::Read(google::protobuf::MessageLite &message,
+                         bool &clean_eof) {
+  return google::protobuf::util::ParseDelimitedFromZeroCopyStream(
+      &message, &input_, &clean_eof);
+}
+
+int ListenOnUnixSocket(const std::filesystem::path &path) {
+  sockaddr_un address;
+  if (!MakeUnixSocketAddress(path, address)) return -1;
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    LOG(ERROR) << "Cannot create a socket: " << strerror(errno);
+    return -1;
+  }
+  std::error_code ignored;
+  std::filesystem::remove(path, ignored);
+  if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0 ||
+      listen(fd, SOMAXCONN) != 0) {
+    LOG(ERROR) << "Cannot listen on " << path << ": " << strerror(errno);
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+int ConnectToUnixSocket(const std::filesystem::path &path) {
+  sockaddr_un address;
+  if (!MakeUnixSocketAddress(path, address)) return -1;
+  int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    LOG(ERROR) << "Cannot create a socket: " << strerror(errno);
+    return -1;
+  }
+  if (connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) !=
+      0) {
+    LOG(ERROR) << "Cannot connect to " << path << ": " << strerror(errno);
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+PolicyCheckResponse ToProto(const PolicyCheckResult &result) {
+  PolicyCheckResponse response;
+  response.set_name(result.name);
+  response.set_status(ToProto(result.status));
+  response.set_error(result.error);
+  response.set_program(result.program);
+  response.set_num_facts(result.num_facts);
+  response.set_num_checks(result.num_checks);
+  for (const CheckFailure &failure : result.check_failures) {
+    CheckFailureProto &failure_proto = *response.add_check_failures();
+    failure_proto.set_check_label(failure.check_label);
+    failure_proto.set_owner(failure.owner);
+    failure_proto.set_access_path(failure.access_path);
+  }
+  for (const DisallowedUsage &usage : result.disallowed_usages) {
+    DisallowedUsageProto &usage_proto = *response.add_disallowed_usages();
+    usage_proto.set_consumer(usage.consumer);
+    usage_proto.set_usage(usage.usage);
+    usage_proto.set_owner(usage.owner);
+    usage_proto.set_tag(usage.tag);
+  }
+  response.set_load_ms(result.load_ms);
+  response.set_run_ms(result.run_ms);
+  response.set_evaluate_ms(result.evaluate_ms);
+  return response;
+}
+
+}  // namespace raksha::analysis::batch
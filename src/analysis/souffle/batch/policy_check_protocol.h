@@ -0,0 +1,66 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_PROTOCOL_H_
+#define SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_PROTOCOL_H_
+
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+#include <google/protobuf/message_lite.h>
+
+#include <filesystem>
+
+#include "src/analysis/souffle/batch/policy_check_result.h"
+#include "src/analysis/souffle/batch/policy_check_service.pb.h"
+
+namespace raksha::analysis::batch {
+
+// One end of a connection to or from the policy check daemon, over which
+// messages are exchanged with a varint size prefix.
+class MessageStream {
+ public:
+  // Takes ownership of the file descriptor `fd`.
+  explicit MessageStream(int fd) : fd_(fd), input_(fd) {}
+  ~MessageStream();
+
+  MessageStream(const MessageStream &) = delete;
+  MessageStream &operator=(const MessageStream &) = delete;
+
+  // Writes `message`. Returns false if it could not be written.
+  bool Write(const google::protobuf::MessageLite &message);
+
+  // Reads the next message into `message`. Returns false at the end of the
+  // stream, in which case `clean_eof` is set if it did not end within a
+  // message.
+  bool Read(google::protobuf::MessageLite &message, bool &clean_eof);
+
+ private:
+  int fd_;
+  google::protobuf::io::FileInputStream input_;
+};
+
+// Returns a socket listening on the Unix domain socket at `path`, replacing
+// any file there, or -1 on error.
+int ListenOnUnixSocket(const std::filesystem::path &path);
+
+// Returns a socket connected to the Unix domain socket at `path` or -1 on
+// error.
+int ConnectToUnixSocket(const std::filesystem::path &path);
+
+PolicyCheckResponse ToProto(const PolicyCheckResult &result);
+
+}  // namespace raksha::analysis::batch
+
+#endif  // SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_PROTOCOL_H_
@@ -0,0 +1,123 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/policy_check_protocol.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <thread>
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::analysis::batch {
+
+TEST(MessageStreamTest, ExchangesSizePrefixedMessages) {
+  int fds[2];
+  ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  MessageStream client(fds[0]);
+  MessageStream server(fds[1]);
+
+  PolicyCheckRequest first_request;
+  first_request.set_name("first");
+  first_request.mutable_manifest()->add_recipes()->set_name("R");
+  PolicyCheckRequest second_request;
+  second_request.set_name("second");
+  second_request.set_auth_logic("\"UserA\" says ownsTag(\"UserA\", \"tag\").");
+  ASSERT_TRUE(client.Write(first_request));
+  ASSERT_TRUE(client.Write(second_request));
+  shutdown(fds[0], SHUT_WR);
+
+  // Both messages are read, although they may arrive in a single read.
+  PolicyCheckRequest request;
+  bool clean_eof = false;
+  ASSERT_TRUE(server.Read(request, clean_eof));
+  EXPECT_EQ(request.name(), "first");
+  EXPECT_EQ(request.manifest().recipes(0).name(), "R");
+  ASSERT_TRUE(server.Read(request, clean_eof));
+  EXPECT_EQ(request.name(), "second");
+  EXPECT_EQ(request.auth_logic(), second_request.auth_logic());
+  EXPECT_FALSE(server.Read(request, clean_eof));
+  EXPECT_TRUE(clean_eof);
+}
+
+TEST(UnixSocketTest, ConnectsToListeningSocket) {
+  std::filesystem::path socket_path =
+      std::filesystem::temp_directory_path() /
+      ("policy_check_protocol_test." + std::to_string(getpid()));
+  int listen_fd = ListenOnUnixSocket(socket_path);
+  ASSERT_GE(listen_fd, 0);
+  std::thread server_thread([listen_fd]() {
+    MessageStream server(accept(listen_fd, nullptr, nullptr));
+    PolicyCheckRequest request;
+    bool clean_eof = false;
+    ASSERT_TRUE(server.Read(request, clean_eof));
+    PolicyCheckResponse response;
+    response.set_name(request.name());
+    ASSERT_TRUE(server.Write(response));
+  });
+
+  int fd = ConnectToUnixSocket(socket_path);
+  ASSERT_GE(fd, 0);
+  MessageStream client(fd);
+  PolicyCheckRequest request;
+  request.set_name("ping");
+  ASSERT_TRUE(client.Write(request));
+  PolicyCheckResponse response;
+  bool clean_eof = false;
+  ASSERT_TRUE(client.Read(response, clean_eof));
+  EXPECT_EQ(response.name(), "ping");
+
+  server_thread.join();
+  close(listen_fd);
+  std::filesystem::remove(socket_path);
+}
+
+TEST(ToProtoTest, ConvertsResult) {
+  PolicyCheckResult result{
+      .name = "multimic",
+      .manifest_proto = "",
+      .auth_logic = "",
+      .status = PolicyCheckResult::Status::kFail,
+      .error = "",
+      .program = "multimic_daemon_analysis_0",
+      .num_facts = 12,
+      .num_checks = 1,
+      .check_failures = {{.check_label = "check_num_0",
+                          .owner = "UserC",
+                          .access_path = "R.P#0.in",
+                          .source = nullptr}},
+      .disallowed_usages = {{.consumer = "C",
+                             .usage = "store",
+                             .owner = "UserA",
+                             .tag = "private"}},
+      .load_ms = 0,
+      .run_ms = 1.5,
+      .evaluate_ms = 0};
+  PolicyCheckResponse response = ToProto(result);
+  EXPECT_EQ(response.name(), "multimic");
+  EXPECT_EQ(response.status(), PolicyCheckResponse::STATUS_FAIL);
+  EXPECT_EQ(response.program(), "multimic_daemon_analysis_0");
+  EXPECT_EQ(response.num_facts(), 12);
+  EXPECT_EQ(response.num_checks(), 1);
+  ASSERT_EQ(response.check_failures_size(), 1);
+  EXPECT_EQ(response.check_failures(0).owner(), "UserC");
+  ASSERT_EQ(response.disallowed_usages_size(), 1);
+  EXPECT_EQ(response.disallowed_usages(0).tag(), "private");
+  EXPECT_DOUBLE_EQ(response.run_ms(), 1.5);
+}
+
+}  // namespace raksha::analysis::batch
@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/policy_check_result.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
+namespace raksha::analysis::batch {
+
+absl::string_view PolicyCheckStatusName(PolicyCheckResult::Status status) {
+  switch (status) {
+    case PolicyCheckResult::Status::kPass:
+      return "pass";
+    case PolicyCheckResult::Status::kFail:
+      return "fail";
+    case PolicyCheckResult::Status::kError:
+      return "error";
+  }
+  return "error";
+}
+
+std::string PolicyCheckResult::ToJson() const {
+  using results::JsonString;
+  auto formatter = [](std::string *out, const auto &finding) {
+    absl::StrAppend(out, results::ToJson(finding));
+  };
+  return absl::StrCat(
+      "{\"name\": ", JsonString(name),
+      ", \"manifest_proto\": ", JsonString(manifest_proto),
+      ", \"auth_logic\": ", JsonString(auth_logic),
+      ", \"status\": ", JsonString(PolicyCheckStatusName(status)),
+      ", \"error\": ", JsonString(error), ", \"program\": ", JsonString(program),
+      ", \"num_facts\": ", num_facts, ", \"num_checks\": ", num_checks,
+      ", \"check_failures\": [",
+      absl::StrJoin(check_failures, ", ", formatter),
+      "], \"disallowed_usages\": [",
+      absl::StrJoin(disallowed_usages, ", ", formatter),
+      "], \"load_ms\": ", load_ms, ", \"run_ms\": ", run_ms,
+      ", \"evaluate_ms\": ", evaluate_ms, "}");
+}
+
+}  // namespace raksha::analysis::batch
@@ -0,0 +1,77 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_RESULT_H_
+#define SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_RESULT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/analysis/souffle/batch/check_evaluation.h"
+#include "src/analysis/souffle/results/policy_check_findings.h"
+
+namespace raksha::analysis::batch {
+
+using DisallowedUsage = results::DisallowedUsage;
+
+// The outcome of checking one manifest against one authorization logic.
+struct PolicyCheckResult {
+  enum class Status {
+    // All checks hold and all usages are allowed.
+    kPass,
+    // Some check failed or some usage is disallowed.
+    kFail,
+    // The policy could not be checked. `error` says why.
+    kError,
+  };
+
+  std::string name;
+  std::string manifest_proto;
+  std::string auth_logic;
+  Status status = Status::kError;
+  std::string error;
+  // The program that checked the policy.
+  std::string program;
+  uint64_t num_facts = 0;
+  uint64_t num_checks = 0;
+  std::vector<CheckFailure> check_failures;
+  std::vector<DisallowedUsage> disallowed_usages;
+  // The time taken to load the facts into the program, to run it and to
+  // read and evaluate its results.
+  double load_ms = 0;
+  double run_ms = 0;
+  double evaluate_ms = 0;
+
+  // Sets the status from the failures and disallowed usages.
+  void SetStatusFromFindings() {
+    status = (check_failures.empty() && disallowed_usages.empty())
+                 ? Status::kPass
+                 : Status::kFail;
+  }
+
+  // Returns the result as a JSON object.
+  std::string ToJson() const;
+};
+
+// The name of a status, as used in the JSON output: "pass", "fail" or
+// "error".
+absl::string_view PolicyCheckStatusName(PolicyCheckResult::Status status);
+
+}  // namespace raksha::analysis::batch
+
+#endif  // SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_RESULT_H_
@@ -0,0 +1,68 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/policy_check_result.h"
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::analysis::batch {
+
+TEST(PolicyCheckResultTest, SetsStatusFromFindings) {
+  PolicyCheckResult result;
+  result.SetStatusFromFindings();
+  EXPECT_EQ(result.status, PolicyCheckResult::Status::kPass);
+  result.disallowed_usages.push_back({.consumer = "C",
+                                      .usage = "store",
+                                      .owner = "UserA",
+                                      .tag = "private"});
+  result.SetStatusFromFindings();
+  EXPECT_EQ(result.status, PolicyCheckResult::Status::kFail);
+}
+
+TEST(PolicyCheckResultTest, WritesJson) {
+  PolicyCheckResult result{
+      .name = "multimic",
+      .manifest_proto = "multimic.binarypb",
+      .auth_logic = "multimic.authlogic",
+      .status = PolicyCheckResult::Status::kFail,
+      .error = "",
+      .program = "multimic_batch_analysis_0",
+      .num_facts = 12,
+      .num_checks = 1,
+      .check_failures = {{.check_label = "check_num_0",
+                          .owner = "UserC",
+                          .access_path = "R.P#0.in",
+                          .source = nullptr}},
+      .disallowed_usages = {{.consumer = "C",
+                             .usage = "store",
+                             .owner = "UserA",
+                             .tag = "say \"hi\""}},
+      .load_ms = 0,
+      .run_ms = 0,
+      .evaluate_ms = 0};
+  EXPECT_EQ(
+      result.ToJson(),
+      R"({"name": "multimic", "manifest_proto": "multimic.binarypb", )"
+      R"("auth_logic": "multimic.authlogic", "status": "fail", "error": "", )"
+      R"("program": "multimic_batch_analysis_0", "num_facts": 12, )"
+      R"("num_checks": 1, "check_failures": [{"check": "check_num_0", )"
+      R"("owner": "UserC", "access_path": "R.P#0.in"}], )"
+      R"("disallowed_usages": [{"consumer": "C", "usage": "store", )"
+      R"("owner": "UserA", "tag": "say \"hi\""}], "load_ms": 0, )"
+      R"("run_ms": 0, "evaluate_ms": 0})");
+}
+
+}  // namespace raksha::analysis::batch
@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/policy_check_server.h"
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "souffle/SouffleInterface.h"
+#include "src/analysis/souffle/batch/policy_check_protocol.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/system_spec.h"
+
+namespace raksha::analysis::batch {
+
+bool PolicyCheckServer::Serve(const std::filesystem::path &socket_path) {
+  int listen_fd = ListenOnUnixSocket(socket_path);
+  if (listen_fd < 0) return false;
+  listen_fd_ = listen_fd;
+  std::vector<std::thread> workers;
+  for (int i = 0; i < num_workers_; ++i) {
+    workers.emplace_back([this]() { Work(); });
+  }
+  while (!stopped_) {
+    int fd = accept4(listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0) {
+      if (errno == EINTR || errno == ECONNABORTED) continue;
+      if (!stopped_) LOG(ERROR) << "Cannot accept: " << strerror(errno);
+      break;
+    }
+    std::lock_guard<std::mutex> lock(connections_mutex_);
+    connections_.push_back(fd);
+    connections_ready_.notify_one();
+  }
+  Stop();
+  for (std::thread &worker : workers) worker.join();
+  close(listen_fd);
+  std::error_code ignored;
+  std::filesystem::remove(socket_path, ignored);
+  return true;
+}
+
+void PolicyCheckServer::Stop() {
+  stopped_ = true;
+  // Wakes up the accept call of Serve.
+  int listen_fd = listen_fd_;
+  if (listen_fd >= 0) shutdown(listen_fd, SHUT_RDWR);
+  std::lock_guard<std::mutex> lock(connections_mutex_);
+  connections_ready_.notify_all();
+}
+
+void PolicyCheckServer::Work() {
+  BatchPolicyChecker::ProgramCache programs;
+  while (true) {
+    int fd;
+    {
+      std::unique_lock<std::mutex> lock(connections_mutex_);
+      connections_ready_.wait(
+          lock, [this]() { return stopped_ || !connections_.empty(); });
+      if (connections_.empty()) return;
+      fd = connections_.front();
+      connections_.pop_front();
+    }
+    MessageStream stream(fd);
+    PolicyCheckRequest request;
+    bool clean_eof = false;
+    while (stream.Read(request, clean_eof)) {
+      if (!stream.Write(Handle(request, programs))) break;
+    }
+    if (!clean_eof) LOG(WARNING) << "Dropped a connection after a bad request.";
+  }
+}
+
+PolicyCheckResponse PolicyCheckServer::Handle(
+    const PolicyCheckRequest &request,
+    BatchPolicyChecker::ProgramCache &programs) const {
+  PolicyCheckResult result{.name = request.name()};
+  // Pins the particle specs for the duration of the check.
+  std::shared_ptr<const ir::proto::SystemSpecSnapshot> snapshot;
+  const ir::SystemSpec *system_spec = nullptr;
+  std::unique_ptr<ir::SystemSpec> request_system_spec;
+  if (request.manifest().particle_specs_size() > 0) {
+    request_system_spec = ir::proto::Decode(
+        request.manifest(), checker_.default_derivation_mode());
+    system_spec = request_system_spec.get();
+  } else {
+    snapshot = registry_.Current();
+    system_spec = &snapshot->system_spec();
+  }
+  if (system_spec == nullptr) {
+    result.error = "Cannot decode the particle specs of the manifest";
+  } else {
+    checker_.CheckManifest(request.manifest(), *system_spec,
+                           request.auth_logic(), programs, result);
+  }
+  PolicyCheckResponse response = ToProto(result);
+  if (snapshot != nullptr) {
+    response.set_particle_specs_version(snapshot->version());
+  }
+  return response;
+}
+
+}  // namespace raksha::analysis::batch
@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_SERVER_H_
+#define SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_SERVER_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+
+#include "src/analysis/souffle/batch/batch_policy_checker.h"
+#include "src/analysis/souffle/batch/policy_check_service.pb.h"
+#include "src/ir/proto/system_spec_registry.h"
+
+namespace raksha::analysis::batch {
+
+// Serves policy checks over a Unix domain socket. The particle specs and
+// the programs of the checker are loaded once, and each of a fixed number of
+// worker threads keeps its own program instances. A worker serves one
+// connection at a time, answering its requests in order, so concurrent
+// requests should be sent over separate connections.
+class PolicyCheckServer {
+ public:
+  // `registry` holds the particle specs of requests whose manifests have
+  // none. It may be reloaded while the server runs; each request is checked
+  // against the snapshot that is current when it is received.
+  PolicyCheckServer(const BatchPolicyChecker &checker,
+                    const ir::proto::SystemSpecRegistry &registry,
+                    int num_workers)
+      : checker_(checker),
+        registry_(registry),
+        num_workers_(std::max(num_workers, 1)) {}
+
+  // Accepts connections on `socket_path` until Stop is called. Returns false
+  // if the socket could not be created.
+  bool Serve(const std::filesystem::path &socket_path);
+
+  // Makes Serve return once the connections being served are closed. May be
+  // called from any thread.
+  void Stop();
+
+  // Answers a single request with the programs of the calling worker.
+  PolicyCheckResponse Handle(const PolicyCheckRequest &request,
+                             BatchPolicyChecker::ProgramCache &programs) const;
+
+ private:
+  // Serves the connections accepted by Serve until Stop is called.
+  void Work();
+
+  const BatchPolicyChecker &checker_;
+  const ir::proto::SystemSpecRegistry &registry_;
+  int num_workers_;
+
+  std::atomic<bool> stopped_ = false;
+  std::atomic<int> listen_fd_ = -1;
+  std::mutex connections_mutex_;
+  std::condition_variable connections_ready_;
+  // The accepted connections that no worker serves yet.
+  std::deque<int> connections_;
+};
+
+}  // namespace raksha::analysis::batch
+
+#endif  // SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_CHECK_SERVER_H_
@@ -0,0 +1,67 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/policy_facts.h"
+
+#include "src/ir/datalog_print_context.h"
+
+namespace raksha::analysis::batch {
+
+PolicyFacts PolicyFacts::Create(
+    const xform_to_datalog::ManifestDatalogFacts &manifest_datalog_facts) {
+  PolicyFacts result;
+  for (absl::string_view relation : kInputRelations) {
+    result.relations_[std::string(relation)];
+  }
+  std::vector<Tuple> &edges = result.relations_["edge"];
+  std::vector<Tuple> &is_checks = result.relations_["isCheck"];
+
+  // The labels of the checks must match those that ToDatalog gives them, so
+  // that results can be compared with those of a policy_check.
+  ir::DatalogPrintContext ctxt;
+  for (const auto &particle : manifest_datalog_facts.particle_instances()) {
+    ctxt.set_instantiation_map(&particle.instantiation_map());
+    for (const ir::TagClaim &claim : particle.spec()->tag_claims()) {
+      result
+          .relations_[claim.claim_tag_is_present() ? "claimHasTag"
+                                                   : "claimRemoveTag"]
+          .push_back({claim.claiming_particle_name(),
+                      claim.access_path().ToDatalog(ctxt), claim.tag()});
+    }
+    for (const ir::TagCheck &check : particle.spec()->checks()) {
+      Check &batch_check = result.checks_.emplace_back(
+          Check{.label = ctxt.GetUniqueCheckLabel(),
+                .access_path = check.access_path().ToDatalog(ctxt),
+                .predicate = &check.predicate()});
+      is_checks.push_back({batch_check.label, batch_check.access_path});
+    }
+    for (const ir::Edge &edge : particle.edges()) {
+      edges.push_back({edge.from().ToDatalog(ctxt), edge.to().ToDatalog(ctxt)});
+    }
+    for (const ir::Edge &edge : particle.spec()->edges()) {
+      edges.push_back({edge.from().ToDatalog(ctxt), edge.to().ToDatalog(ctxt)});
+    }
+  }
+  return result;
+}
+
+uint64_t PolicyFacts::NumFacts() const {
+  uint64_t num_facts = 0;
+  for (const auto &[relation, tuples] : relations_) num_facts += tuples.size();
+  return num_facts;
+}
+
+}  // namespace raksha::analysis::batch
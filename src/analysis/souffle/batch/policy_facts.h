@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_FACTS_H_
+#define SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_FACTS_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/ir/predicate.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+
+namespace raksha::analysis::batch {
+
+// The facts of a manifest as tuples of the input relations of
+// batch_analysis.dl, for inserting into a reused program through the
+// relation API rather than compiling them into a new one.
+class PolicyFacts {
+ public:
+  // The symbol arguments of a fact.
+  using Tuple = std::vector<std::string>;
+
+  // A check of the manifest. It has the label and access path of its
+  // isCheck fact and the predicate that the generated check rule would have.
+  struct Check {
+    std::string label;
+    std::string access_path;
+    // Owned by the ParticleSpec of the check, which must outlive this.
+    const ir::Predicate *predicate;
+  };
+
+  // The relations whose tuples this holds, all of them inputs of
+  // batch_analysis.dl.
+  static constexpr absl::string_view kInputRelations[] = {
+      "edge", "claimHasTag", "claimRemoveTag", "isCheck"};
+
+  static PolicyFacts Create(
+      const xform_to_datalog::ManifestDatalogFacts &manifest_datalog_facts);
+
+  // The tuples of each input relation, in the order ToDatalog prints them.
+  const std::map<std::string, std::vector<Tuple>> &relations() const {
+    return relations_;
+  }
+  const std::vector<Check> &checks() const { return checks_; }
+
+  // The total number of tuples in all relations.
+  uint64_t NumFacts() const;
+
+ private:
+  std::map<std::string, std::vector<Tuple>> relations_;
+  std::vector<Check> checks_;
+};
+
+}  // namespace raksha::analysis::batch
+
+#endif  // SRC_ANALYSIS_SOUFFLE_BATCH_POLICY_FACTS_H_
@@ -0,0 +1,102 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/batch/policy_facts.h"
+
+#include <google/protobuf/text_format.h>
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/proto/system_spec.h"
+
+namespace raksha::analysis::batch {
+
+// A Source particle claims a tag on its output, which a Sink particle checks
+// on its input. Both particles are instantiated in recipe R and share h1.
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Source" connections: [
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: { particle_spec: "Source", handle_connection: "out" } }
+            predicate: { label: { semantic_tag: "tag"} } } } ] },
+    { name: "Sink" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } } ]
+      checks: [
+        { access_path: {
+            handle: { particle_spec: "Sink", handle_connection: "in" } }
+          predicate: { label: { semantic_tag: "tag"} } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Source" connections: [
+              { name: "out" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } } ] } ] } ]
+)";
+
+class PolicyFactsTest : public testing::Test {
+ public:
+  PolicyFactsTest() {
+    arcs::ManifestProto manifest_proto;
+    CHECK(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                        &manifest_proto));
+    system_spec_ = ir::proto::Decode(manifest_proto);
+    CHECK(system_spec_ != nullptr);
+    facts_ = PolicyFacts::Create(
+        xform_to_datalog::ManifestDatalogFacts::CreateFromManifestProto(
+            *system_spec_, manifest_proto));
+  }
+
+ protected:
+  std::unique_ptr<ir::SystemSpec> system_spec_;
+  PolicyFacts facts_;
+};
+
+TEST_F(PolicyFactsTest, HasEveryInputRelation) {
+  std::vector<std::string> relations;
+  for (const auto &[relation, tuples] : facts_.relations()) {
+    relations.push_back(relation);
+  }
+  EXPECT_THAT(relations,
+              testing::UnorderedElementsAreArray(PolicyFacts::kInputRelations));
+  EXPECT_THAT(facts_.relations().at("claimRemoveTag"), testing::IsEmpty());
+}
+
+TEST_F(PolicyFactsTest, InstantiatesClaimsAndEdges) {
+  EXPECT_THAT(facts_.relations().at("claimHasTag"),
+              testing::ElementsAre(PolicyFacts::Tuple(
+                  {"Source", "R.Source#0.out", "tag"})));
+  EXPECT_THAT(facts_.relations().at("edge"),
+              testing::UnorderedElementsAre(
+                  PolicyFacts::Tuple({"R.Source#0.out", "R.h1"}),
+                  PolicyFacts::Tuple({"R.h1", "R.Sink#1.in"})));
+  EXPECT_EQ(facts_.NumFacts(), 4);
+}
+
+TEST_F(PolicyFactsTest, KeepsChecksWithTheirPredicates) {
+  ASSERT_EQ(facts_.checks().size(), 1);
+  const PolicyFacts::Check &check = facts_.checks().front();
+  EXPECT_EQ(check.label, "check_num_0");
+  EXPECT_EQ(check.access_path, "R.Sink#1.in");
+  EXPECT_EQ(check.predicate->GetPredicateKind(), ir::kTagPresence);
+  EXPECT_THAT(facts_.relations().at("isCheck"),
+              testing::ElementsAre(
+                  PolicyFacts::Tuple({"check_num_0", "R.Sink#1.in"})));
+}
+
+}  // namespace raksha::analysis::batch
@@ -0,0 +1,202 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/benchmarks/fact_shapes.h"
+
+#include <fstream>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "src/common/logging/logging.h"
+
+namespace raksha::analysis::benchmarks {
+
+namespace {
+
+constexpr absl::string_view kOwner = "Owner";
+constexpr absl::string_view kConsumer = "Consumer";
+constexpr absl::string_view kUsage = "use";
+
+// The length of the chains of the kManyPrincipals and kManyTags shapes.
+constexpr uint64_t kShortChainLength = 10;
+
+constexpr std::pair<FactShape, absl::string_view> kFactShapeNames[] = {
+    {FactShape::kChain, "chain"},
+    {FactShape::kFanIn, "fan_in"},
+    {FactShape::kFanOut, "fan_out"},
+    {FactShape::kDeepSchema, "deep_schema"},
+    {FactShape::kScc, "scc"},
+    {FactShape::kManyPrincipals, "many_principals"},
+    {FactShape::kManyTags, "many_tags"},
+};
+
+std::string Node(uint64_t index) { return absl::StrCat("n", index); }
+
+std::string Tag(uint64_t index) { return absl::StrCat("tag", index); }
+
+// Adds the facts of the relations of the analysis that are used in all
+// shapes.
+class FactSetBuilder {
+ public:
+  void AddEdge(absl::string_view src, absl::string_view tgt) {
+    facts_.AddFact("edge", {std::string(src), std::string(tgt)});
+  }
+
+  // `owner` owns `path` and `tag` and says `path` has `tag`.
+  void AddTaggedSource(absl::string_view owner, absl::string_view path,
+                       absl::string_view tag) {
+    std::string owner_str(owner);
+    facts_.AddFact("says_ownsAccessPath",
+                   {owner_str, owner_str, std::string(path)});
+    facts_.AddFact("says_ownsTag", {owner_str, owner_str, std::string(tag)});
+    facts_.AddFact("says_hasTag",
+                   {owner_str, std::string(path), owner_str, std::string(tag)});
+  }
+
+  void AddRemovedTag(absl::string_view owner, absl::string_view path,
+                     absl::string_view tag) {
+    std::string owner_str(owner);
+    facts_.AddFact("says_removeTag",
+                   {owner_str, std::string(path), owner_str, std::string(tag)});
+  }
+
+  // A consumer says it will use the data on `path`.
+  void AddSink(absl::string_view path) {
+    facts_.AddFact("saysWill", {std::string(kConsumer), std::string(kUsage),
+                                std::string(path)});
+  }
+
+  // Adds a chain of `length` edges from `n0` to `n<length>`.
+  void AddChain(uint64_t length) {
+    for (uint64_t i = 0; i < length; ++i) AddEdge(Node(i), Node(i + 1));
+  }
+
+  FactSet Build() { return std::move(facts_); }
+
+ private:
+  FactSet facts_;
+};
+
+}  // namespace
+
+absl::string_view FactShapeName(FactShape shape) {
+  for (const auto &[candidate, name] : kFactShapeNames) {
+    if (candidate == shape) return name;
+  }
+  LOG(FATAL) << "Unexpected fact shape.";
+}
+
+std::optional<FactShape> ParseFactShape(absl::string_view name) {
+  for (const auto &[shape, candidate] : kFactShapeNames) {
+    if (candidate == name) return shape;
+  }
+  return std::nullopt;
+}
+
+uint64_t FactSet::NumFacts() const {
+  uint64_t num_facts = 0;
+  for (const auto &[relation, facts] : relations_) num_facts += facts.size();
+  return num_facts;
+}
+
+bool FactSet::WriteFactsFiles(const std::filesystem::path &directory) const {
+  for (const auto &[relation, facts] : relations_) {
+    std::filesystem::path facts_path =
+        directory / absl::StrCat(relation, ".facts");
+    std::ofstream facts_stream(facts_path);
+    if (!facts_stream) {
+      LOG(ERROR) << "Error opening facts file " << facts_path << ": "
+                 << strerror(errno);
+      return false;
+    }
+    for (const Fact &fact : facts) {
+      facts_stream << absl::StrJoin(fact, "\t") << "\n";
+    }
+  }
+  return true;
+}
+
+FactSet GenerateFacts(FactShape shape, uint64_t size) {
+  FactSetBuilder builder;
+  switch (shape) {
+    case FactShape::kChain: {
+      builder.AddChain(size);
+      builder.AddTaggedSource(kOwner, Node(0), Tag(0));
+      builder.AddSink(Node(size));
+      break;
+    }
+    case FactShape::kFanIn: {
+      for (uint64_t i = 0; i < size; ++i) {
+        std::string source = absl::StrCat("src", i);
+        builder.AddTaggedSource(kOwner, source, Tag(i));
+        builder.AddEdge(source, "sink");
+      }
+      builder.AddSink("sink");
+      break;
+    }
+    case FactShape::kFanOut: {
+      builder.AddTaggedSource(kOwner, "src", Tag(0));
+      for (uint64_t i = 0; i < size; ++i) {
+        std::string sink = absl::StrCat("sink", i);
+        builder.AddEdge("src", sink);
+        builder.AddSink(sink);
+      }
+      break;
+    }
+    case FactShape::kDeepSchema: {
+      std::string fields;
+      for (uint64_t depth = 0; depth <= size; ++depth) {
+        builder.AddEdge(absl::StrCat("src", fields),
+                        absl::StrCat("dst", fields));
+        if (depth < size) absl::StrAppend(&fields, ".f");
+      }
+      builder.AddTaggedSource(kOwner, absl::StrCat("src", fields), Tag(0));
+      builder.AddSink("dst");
+      break;
+    }
+    case FactShape::kScc: {
+      builder.AddTaggedSource(kOwner, "src", Tag(0));
+      builder.AddEdge("src", Node(0));
+      for (uint64_t i = 0; i < size; ++i) {
+        builder.AddEdge(Node(i), Node((i + 1) % size));
+      }
+      builder.AddSink(Node(0));
+      break;
+    }
+    case FactShape::kManyPrincipals: {
+      builder.AddChain(kShortChainLength);
+      for (uint64_t i = 0; i < size; ++i) {
+        builder.AddTaggedSource(absl::StrCat(kOwner, i), Node(0), Tag(i));
+      }
+      builder.AddSink(Node(kShortChainLength));
+      break;
+    }
+    case FactShape::kManyTags: {
+      builder.AddChain(kShortChainLength);
+      for (uint64_t i = 0; i < size; ++i) {
+        builder.AddTaggedSource(kOwner, Node(0), Tag(i));
+        if (i % 2 == 0) {
+          builder.AddRemovedTag(kOwner, Node(kShortChainLength / 2), Tag(i));
+        }
+      }
+      builder.AddSink(Node(kShortChainLength));
+      break;
+    }
+  }
+  return builder.Build();
+}
+
+}  // namespace raksha::analysis::benchmarks
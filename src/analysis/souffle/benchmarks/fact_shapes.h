@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_BENCHMARKS_FACT_SHAPES_H_
+#define SRC_ANALYSIS_SOUFFLE_BENCHMARKS_FACT_SHAPES_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace raksha::analysis::benchmarks {
+
+// The shapes of the dataflow graphs that GenerateFacts can produce. In each
+// of them the sources of the graph are owned by a principal and tagged with
+// a tag it owns, and a consumer says it will use the sinks of the graph.
+enum class FactShape {
+  // A path of `size` edges.
+  kChain,
+  // `size` tagged sources, each with its own tag, flowing into one sink.
+  kFanIn,
+  // One tagged source flowing into `size` sinks.
+  kFanOut,
+  // A source and a sink handle whose fields are nested `size` deep, with an
+  // edge between each pair of corresponding fields. The number of access
+  // paths that are members of each other grows quadratically.
+  kDeepSchema,
+  // A cycle of `size` access paths with a tagged source flowing into it.
+  kScc,
+  // `size` principals, each owning and tagging the source of a short chain.
+  kManyPrincipals,
+  // `size` tags on the source of a short chain, with every other tag
+  // removed halfway along the chain.
+  kManyTags,
+};
+
+// The name of the shape, as accepted by ParseFactShape.
+absl::string_view FactShapeName(FactShape shape);
+
+// Returns the shape with the given name or std::nullopt if there is none.
+std::optional<FactShape> ParseFactShape(absl::string_view name);
+
+// The facts of a run of the analysis, by relation name. Every fact is the
+// list of its (symbol) arguments.
+class FactSet {
+ public:
+  using Fact = std::vector<std::string>;
+
+  void AddFact(absl::string_view relation, Fact fact) {
+    relations_[std::string(relation)].push_back(std::move(fact));
+  }
+
+  const std::map<std::string, std::vector<Fact>> &relations() const {
+    return relations_;
+  }
+
+  // The total number of facts in all relations.
+  uint64_t NumFacts() const;
+
+  // Writes each relation to a tab-separated `<relation>.facts` file in
+  // `directory`, as read by the `.input` directives of a Souffle program.
+  // Returns false if a file could not be written.
+  bool WriteFactsFiles(const std::filesystem::path &directory) const;
+
+ private:
+  std::map<std::string, std::vector<Fact>> relations_;
+};
+
+// Returns the facts of a graph of the given shape and size.
+FactSet GenerateFacts(FactShape shape, uint64_t size);
+
+}  // namespace raksha::analysis::benchmarks
+
+#endif  // SRC_ANALYSIS_SOUFFLE_BENCHMARKS_FACT_SHAPES_H_
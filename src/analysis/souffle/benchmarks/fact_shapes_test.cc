@@ -0,0 +1,99 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/benchmarks/fact_shapes.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::analysis::benchmarks {
+
+struct FactShapeTestParam {
+  FactShape shape;
+  uint64_t size;
+  // The expected number of facts of some of the relations.
+  std::map<std::string, uint64_t> expected_num_facts;
+};
+
+class FactShapeTest : public testing::TestWithParam<FactShapeTestParam> {};
+
+TEST_P(FactShapeTest, GeneratesFactsOfRequestedShape) {
+  const FactShapeTestParam &param = GetParam();
+  FactSet fact_set = GenerateFacts(param.shape, param.size);
+  for (const auto &[relation, expected_num_facts] : param.expected_num_facts) {
+    auto find_result = fact_set.relations().find(relation);
+    uint64_t num_facts = (find_result == fact_set.relations().end())
+                             ? 0
+                             : find_result->second.size();
+    EXPECT_EQ(num_facts, expected_num_facts) << relation;
+  }
+}
+
+TEST_P(FactShapeTest, ShapeNameRoundTrips) {
+  FactShape shape = GetParam().shape;
+  EXPECT_EQ(ParseFactShape(FactShapeName(shape)), shape);
+}
+
+static const FactShapeTestParam kFactShapeTestParams[] = {
+    {.shape = FactShape::kChain,
+     .size = 5,
+     .expected_num_facts = {{"edge", 5}, {"says_hasTag", 1}, {"saysWill", 1}}},
+    {.shape = FactShape::kFanIn,
+     .size = 5,
+     .expected_num_facts = {{"edge", 5}, {"says_hasTag", 5}, {"saysWill", 1}}},
+    {.shape = FactShape::kFanOut,
+     .size = 5,
+     .expected_num_facts = {{"edge", 5}, {"says_hasTag", 1}, {"saysWill", 5}}},
+    {.shape = FactShape::kDeepSchema,
+     .size = 5,
+     .expected_num_facts = {{"edge", 6}, {"says_hasTag", 1}, {"saysWill", 1}}},
+    {.shape = FactShape::kScc,
+     .size = 5,
+     .expected_num_facts = {{"edge", 6}, {"says_hasTag", 1}, {"saysWill", 1}}},
+    {.shape = FactShape::kManyPrincipals,
+     .size = 5,
+     .expected_num_facts = {{"edge", 10},
+                            {"says_hasTag", 5},
+                            {"says_ownsAccessPath", 5}}},
+    {.shape = FactShape::kManyTags,
+     .size = 5,
+     .expected_num_facts = {{"edge", 10},
+                            {"says_hasTag", 5},
+                            {"says_removeTag", 3}}},
+};
+
+INSTANTIATE_TEST_SUITE_P(FactShapeTest, FactShapeTest,
+                         testing::ValuesIn(kFactShapeTestParams));
+
+TEST(FactShapesTest, ParseFactShapeRejectsUnknownNames) {
+  EXPECT_EQ(ParseFactShape("triangle"), std::nullopt);
+}
+
+TEST(FactShapesTest, WriteFactsFilesWritesTabSeparatedFacts) {
+  std::filesystem::path directory =
+      std::filesystem::path(testing::TempDir()) / "fact_shapes_test";
+  std::filesystem::create_directories(directory);
+  ASSERT_TRUE(GenerateFacts(FactShape::kChain, 2).WriteFactsFiles(directory));
+
+  std::ifstream edge_facts(directory / "edge.facts");
+  std::stringstream contents;
+  contents << edge_facts.rdbuf();
+  EXPECT_EQ(contents.str(), "n0\tn1\nn1\tn2\n");
+}
+
+}  // namespace raksha::analysis::benchmarks
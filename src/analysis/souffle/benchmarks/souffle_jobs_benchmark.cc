@@ -0,0 +1,182 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+// Runs Souffle programs linked into this binary, such as those generated by
+// a policy_check with `openmp = True`, with different numbers of threads. It
+// prints one JSON object per program and number of threads, with the fastest
+// run time, the speedup over the first number of threads and whether the
+// results are identical to those of the first number of threads. It fails if
+// any of them differ.
+//
+// This file is compiled into a benchmark next to the programs it runs, as
+// the fact_test_driver is. For example:
+//   bazel run -c opt
+//     //src/analysis/souffle/examples/multimic:multimic_jobs_benchmark --
+//     --jobs=1,2,4,8 --repetitions=5
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "souffle/SouffleInterface.h"
+#include "src/common/logging/logging.h"
+
+ABSL_FLAG(std::vector<std::string>, programs, {},
+          "The names of the linked programs to run.");
+ABSL_FLAG(std::vector<std::string>, jobs,
+          std::vector<std::string>({"1", "2", "4", "8"}),
+          "The numbers of threads to run each program with. The first one is "
+          "the baseline for speedups and results.");
+ABSL_FLAG(int, repetitions, 3,
+          "The number of runs per program and number of threads.");
+
+constexpr char kUsageMessage[] =
+    "This tool measures the speedup of Souffle programs compiled with OpenMP "
+    "and checks that their results do not depend on the number of threads.";
+
+namespace {
+
+// The contents of every relation of a program, as sorted lists of rendered
+// tuples.
+using Results = std::map<std::string, std::vector<std::string>>;
+
+// Returns the contents of all relations of `prog`. Symbols are compared by
+// value, as their ids depend on the order of evaluation. So do the ids of
+// records, which is why relations with records are compared only by size.
+Results GetResults(const souffle::SouffleProgram &prog) {
+  Results results;
+  for (souffle::Relation *relation : prog.getAllRelations()) {
+    std::vector<std::string> &tuples = results[relation->getName()];
+    bool has_records = false;
+    for (size_t i = 0; i < relation->getArity(); ++i) {
+      char kind = relation->getAttrType(i)[0];
+      has_records = has_records || (kind == 'r') || (kind == '+');
+    }
+    if (has_records) {
+      tuples.push_back(absl::StrCat("size=", relation->size()));
+      continue;
+    }
+    for (souffle::tuple &tuple : *relation) {
+      std::vector<std::string> values;
+      for (size_t i = 0; i < relation->getArity(); ++i) {
+        switch (relation->getAttrType(i)[0]) {
+          case 's': {
+            std::string value;
+            tuple >> value;
+            values.push_back(std::move(value));
+            break;
+          }
+          case 'u': {
+            souffle::RamUnsigned value;
+            tuple >> value;
+            values.push_back(absl::StrCat(value));
+            break;
+          }
+          case 'f': {
+            souffle::RamFloat value;
+            tuple >> value;
+            values.push_back(absl::StrCat(value));
+            break;
+          }
+          default: {
+            souffle::RamSigned value;
+            tuple >> value;
+            values.push_back(absl::StrCat(value));
+            break;
+          }
+        }
+      }
+      tuples.push_back(absl::StrJoin(values, "\t"));
+    }
+    std::sort(tuples.begin(), tuples.end());
+  }
+  return results;
+}
+
+// Runs the program once with `jobs` threads. Returns the time taken by the
+// run and sets `results` to its results.
+double Run(const std::string &program_name, size_t jobs, Results &results) {
+  std::unique_ptr<souffle::SouffleProgram> prog(
+      souffle::ProgramFactory::newInstance(program_name));
+  CHECK(prog != nullptr) << "Program " << program_name << " is not linked.";
+  prog->setNumThreads(jobs);
+  auto start = std::chrono::steady_clock::now();
+  prog->run();
+  double run_ms = std::chrono::duration<double, std::milli>(
+                      std::chrono::steady_clock::now() - start)
+                      .count();
+  results = GetResults(*prog);
+  return run_ms;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("souffle_jobs_benchmark");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::vector<size_t> jobs_list;
+  for (const std::string &jobs_flag : absl::GetFlag(FLAGS_jobs)) {
+    size_t jobs;
+    if (!absl::SimpleAtoi(jobs_flag, &jobs) || jobs == 0) {
+      LOG(ERROR) << "Invalid number of threads " << jobs_flag;
+      return 1;
+    }
+    jobs_list.push_back(jobs);
+  }
+  if (jobs_list.empty() || absl::GetFlag(FLAGS_programs).empty()) {
+    LOG(ERROR) << "Both --programs and --jobs must be given.";
+    return 1;
+  }
+
+  bool all_identical = true;
+  for (const std::string &program_name : absl::GetFlag(FLAGS_programs)) {
+    Results baseline_results;
+    double baseline_ms = 0;
+    for (size_t jobs : jobs_list) {
+      double fastest_ms = std::numeric_limits<double>::infinity();
+      bool identical = true;
+      for (int run = 0; run < absl::GetFlag(FLAGS_repetitions); ++run) {
+        Results results;
+        fastest_ms = std::min(fastest_ms, Run(program_name, jobs, results));
+        if (baseline_results.empty()) {
+          baseline_results = std::move(results);
+        } else {
+          identical = identical && (results == baseline_results);
+        }
+      }
+      if (jobs == jobs_list.front()) baseline_ms = fastest_ms;
+      all_identical = all_identical && identical;
+      std::cout << "{\"program\": \"" << program_name
+                << "\", \"jobs\": " << jobs << ", \"run_ms\": " << fastest_ms
+                << ", \"speedup\": " << baseline_ms / fastest_ms
+                << ", \"identical\": " << (identical ? "true" : "false")
+                << "}" << std::endl;
+    }
+  }
+  return all_identical ? 0 : 1;
+}
@@ -0,0 +1,255 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+// Runs the taint analysis compiled from taint_scaling.dl on a generated
+// dataflow graph and prints one JSON object per run, with the time taken to
+// load the facts and to run the analysis, the peak RSS of the process and
+// the final sizes of the relations of interest.
+//
+// Example:
+//   bazel run -c opt
+//     //src/analysis/souffle/benchmarks:souffle_scaling_benchmark --
+//     --shape=fan_in --size=10000 --jobs=8 --repetitions=3
+//
+// The `_precomputed_paths` variant does not derive the path relation. With
+// --paths=precompute, the closure is computed by the bit matrix kernel of
+// src/xform_to_datalog/transitive_closure.h instead, and with
+// --paths=preload its tuples are also inserted into the relation. Compare
+// the times and peak RSS with those of the other variants, which derive the
+// relation with recursive rules.
+
+#include <sys/resource.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "souffle/SouffleInterface.h"
+#include "src/analysis/souffle/benchmarks/fact_shapes.h"
+#include "src/common/logging/logging.h"
+#include "src/xform_to_datalog/access_path_graph.h"
+#include "src/xform_to_datalog/transitive_closure.h"
+
+ABSL_FLAG(std::string, shape, "chain",
+          "The shape of the dataflow graph: chain, fan_in, fan_out, "
+          "deep_schema, scc, many_principals or many_tags.");
+ABSL_FLAG(uint64_t, size, 1000, "The size of the dataflow graph.");
+ABSL_FLAG(int, jobs, 1,
+          "The number of threads Souffle may use. Only has an effect if the "
+          "analysis was compiled with OpenMP.");
+ABSL_FLAG(int, repetitions, 1, "The number of runs.");
+ABSL_FLAG(std::string, facts_dir, "",
+          "If set, the facts are written to `.facts` files in this directory "
+          "and loaded from there rather than through the relation API.");
+ABSL_FLAG(std::string, paths, "derive",
+          "How to compute the path relation: derive it with the rules of the "
+          "analysis, precompute its closure in C++ or preload the tuples of "
+          "the precomputed closure. The last two need the "
+          "_precomputed_paths variant.");
+
+constexpr char kUsageMessage[] =
+    "This tool measures the Souffle taint analysis on generated dataflow "
+    "graphs.";
+
+// The name of the program compiled from taint_scaling.dl.
+constexpr char kProgramName[] = "taint_scaling";
+
+// The input relations of taint_scaling.dl. Souffle expects a `.facts` file
+// for each of them, even if the generated graph has no facts for it.
+constexpr const char *kInputRelations[] = {
+    "edge",           "claimNotEdge",        "says_hasTag",
+    "says_removeTag", "says_ownsAccessPath", "says_ownsTag",
+    "saysWill",       "saysMay",
+};
+
+// The relations whose sizes are reported, if the program has them.
+constexpr const char *kReportedRelations[] = {
+    "edge",       "resolvedEdge", "path",           "ownsAccessPath",
+    "isMemberOf", "mayHaveTag",   "disallowedUsage",
+};
+
+namespace {
+
+using raksha::analysis::benchmarks::FactSet;
+
+double MillisecondsSince(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::milli>(
+             std::chrono::steady_clock::now() - start)
+      .count();
+}
+
+// The peak resident set size of this process so far, in kilobytes.
+long PeakRssKb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// The closure of the edges of the generated graph and the time taken to
+// compute it.
+struct PrecomputedPaths {
+  raksha::xform_to_datalog::AccessPathGraph graph;
+  std::optional<raksha::xform_to_datalog::TransitiveClosure> closure;
+  double closure_ms = 0;
+};
+
+PrecomputedPaths PrecomputePaths(const FactSet &fact_set) {
+  auto find_claims = fact_set.relations().find("claimNotEdge");
+  if (find_claims != fact_set.relations().end() &&
+      !find_claims->second.empty()) {
+    LOG(WARNING) << "The precomputed paths ignore claimNotEdge facts.";
+  }
+  PrecomputedPaths paths;
+  auto closure_start = std::chrono::steady_clock::now();
+  auto find_edge = fact_set.relations().find("edge");
+  if (find_edge != fact_set.relations().end()) {
+    for (const FactSet::Fact &fact : find_edge->second) {
+      paths.graph.AddEdge(paths.graph.GetNode(fact.at(0)),
+                          paths.graph.GetNode(fact.at(1)));
+    }
+  }
+  paths.closure =
+      raksha::xform_to_datalog::TransitiveClosure::Create(paths.graph);
+  paths.closure_ms = MillisecondsSince(closure_start);
+  return paths;
+}
+
+void InsertPaths(const PrecomputedPaths &paths,
+                 souffle::SouffleProgram &prog) {
+  souffle::Relation *relation = CHECK_NOTNULL(prog.getRelation("path"));
+  paths.closure->ForEachPath([&](uint32_t from, uint32_t to) {
+    souffle::tuple tuple(relation);
+    tuple << paths.graph.name(from) << paths.graph.name(to);
+    relation->insert(tuple);
+  });
+}
+
+void InsertFacts(const FactSet &fact_set, souffle::SouffleProgram &prog) {
+  for (const auto &[relation_name, facts] : fact_set.relations()) {
+    souffle::Relation *relation =
+        CHECK_NOTNULL(prog.getRelation(relation_name));
+    for (const FactSet::Fact &fact : facts) {
+      souffle::tuple tuple(relation);
+      for (const std::string &argument : fact) tuple << argument;
+      relation->insert(tuple);
+    }
+  }
+}
+
+// Runs the analysis once and prints the JSON report of the run.
+void Run(const FactSet &fact_set, int run) {
+  std::unique_ptr<souffle::SouffleProgram> prog(
+      souffle::ProgramFactory::newInstance(kProgramName));
+  CHECK(prog != nullptr) << "Program " << kProgramName << " is not linked.";
+  prog->setNumThreads(absl::GetFlag(FLAGS_jobs));
+
+  auto load_start = std::chrono::steady_clock::now();
+  std::string facts_dir = absl::GetFlag(FLAGS_facts_dir);
+  if (facts_dir.empty()) {
+    InsertFacts(fact_set, *prog);
+  } else {
+    prog->loadAll(facts_dir);
+  }
+  double load_ms = MillisecondsSince(load_start);
+
+  std::string paths_mode = absl::GetFlag(FLAGS_paths);
+  std::optional<PrecomputedPaths> paths;
+  if (paths_mode != "derive") paths = PrecomputePaths(fact_set);
+  if (paths_mode == "preload") {
+    auto insert_start = std::chrono::steady_clock::now();
+    InsertPaths(*paths, *prog);
+    load_ms += MillisecondsSince(insert_start);
+  }
+
+  auto run_start = std::chrono::steady_clock::now();
+  prog->run();
+  double run_ms = MillisecondsSince(run_start);
+
+  std::vector<std::string> relation_sizes;
+  for (const char *relation_name : kReportedRelations) {
+    souffle::Relation *relation = prog->getRelation(relation_name);
+    if (relation == nullptr) continue;
+    relation_sizes.push_back(
+        absl::StrCat("\"", relation_name, "\": ", relation->size()));
+  }
+
+  std::cout << "{\"shape\": \"" << absl::GetFlag(FLAGS_shape)
+            << "\", \"size\": " << absl::GetFlag(FLAGS_size)
+            << ", \"jobs\": " << prog->getNumThreads()
+            << ", \"run\": " << run
+            << ", \"num_facts\": " << fact_set.NumFacts()
+            << ", \"paths\": \"" << paths_mode << "\"";
+  if (paths.has_value()) {
+    std::cout << ", \"closure_ms\": " << paths->closure_ms
+              << ", \"closure_bytes\": " << paths->closure->num_bytes()
+              << ", \"num_paths\": " << paths->closure->NumPaths();
+  }
+  std::cout << ", \"load_ms\": " << load_ms << ", \"run_ms\": " << run_ms
+            << ", \"peak_rss_kb\": " << PeakRssKb()
+            << ", \"relation_sizes\": {"
+            << absl::StrJoin(relation_sizes, ", ") << "}}" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("souffle_scaling_benchmark");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::optional<raksha::analysis::benchmarks::FactShape> shape =
+      raksha::analysis::benchmarks::ParseFactShape(absl::GetFlag(FLAGS_shape));
+  if (!shape.has_value()) {
+    LOG(ERROR) << "Unknown shape " << absl::GetFlag(FLAGS_shape);
+    return 1;
+  }
+  std::string paths_mode = absl::GetFlag(FLAGS_paths);
+  if (paths_mode != "derive" && paths_mode != "precompute" &&
+      paths_mode != "preload") {
+    LOG(ERROR) << "Unknown way to compute paths " << paths_mode;
+    return 1;
+  }
+  FactSet fact_set = raksha::analysis::benchmarks::GenerateFacts(
+      *shape, absl::GetFlag(FLAGS_size));
+
+  std::string facts_dir = absl::GetFlag(FLAGS_facts_dir);
+  if (!facts_dir.empty()) {
+    std::filesystem::create_directories(facts_dir);
+    if (!fact_set.WriteFactsFiles(facts_dir)) return 1;
+    for (const char *relation_name : kInputRelations) {
+      std::ofstream(std::filesystem::path(facts_dir) /
+                        absl::StrCat(relation_name, ".facts"),
+                    std::ios::app);
+    }
+    // Read by the `_precomputed_paths` variant. The tuples are inserted
+    // through the relation API.
+    std::ofstream(std::filesystem::path(facts_dir) / "path.facts",
+                  std::ios::app);
+  }
+
+  for (int run = 0; run < absl::GetFlag(FLAGS_repetitions); ++run) {
+    Run(fact_set, run);
+  }
+  return 0;
+}
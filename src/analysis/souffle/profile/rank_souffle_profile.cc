@@ -0,0 +1,150 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Tool that ranks the rules and relations of a Souffle profile log, as
+// written by a policy_check or souffle_cc_library built with
+// `profile = True`, and sums the runtime of the rules of each `.dl` file.
+//
+// Example:
+//   bazel test
+//     //src/analysis/souffle/examples/multimic:check_multimic_pass_profile
+//   bazel run //src/analysis/souffle/profile:rank_souffle_profile --
+//     --profile_log=<undeclared outputs of the test>/check_multimic_pass_profile_dl_cpp.profile.log
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_replace.h"
+#include "src/analysis/souffle/profile/souffle_profile.h"
+#include "src/common/logging/logging.h"
+
+ABSL_FLAG(std::string, profile_log, "", "The Souffle profile log.");
+ABSL_FLAG(std::string, sort_by, "runtime",
+          "What to rank by: runtime, tuples or iterations.");
+ABSL_FLAG(uint64_t, top, 20, "The number of rules and relations to print.");
+ABSL_FLAG(std::string, format, "text", "The report format: text or csv.");
+
+constexpr char kUsageMessage[] =
+    "This tool ranks the rules and relations of a Souffle profile log by "
+    "runtime, tuples produced or iterations.";
+
+namespace {
+
+using raksha::analysis::profile::ProfileEntry;
+
+// The width of the rule text in text reports. Longer rules are cut.
+constexpr size_t kRuleTextWidth = 80;
+
+std::string CsvField(absl::string_view value) {
+  return absl::StrCat("\"", absl::StrReplaceAll(value, {{"\"", "\"\""}}),
+                      "\"");
+}
+
+void PrintText(absl::string_view title,
+               const std::vector<ProfileEntry> &entries) {
+  std::cout << title << ":\n";
+  std::cout << absl::StrFormat("%12s %12s %10s  %-24s %s\n", "runtime_ms",
+                               "tuples", "iterations", "source", "name");
+  for (const ProfileEntry &entry : entries) {
+    std::string name = entry.name.size() > kRuleTextWidth
+                           ? absl::StrCat(entry.name.substr(0, kRuleTextWidth),
+                                          "...")
+                           : entry.name;
+    std::cout << absl::StrFormat("%12.3f %12d %10d  %-24s %s\n",
+                                 entry.runtime_ms, entry.num_tuples,
+                                 entry.num_iterations, entry.source_file,
+                                 name);
+  }
+  std::cout << "\n";
+}
+
+void PrintCsv(absl::string_view kind,
+              const std::vector<ProfileEntry> &entries) {
+  for (const ProfileEntry &entry : entries) {
+    std::cout << absl::StrFormat("%s,%s,%s,%s,%.3f,%d,%d\n", kind,
+                                 CsvField(entry.relation),
+                                 CsvField(entry.name),
+                                 CsvField(entry.source_locator),
+                                 entry.runtime_ms, entry.num_tuples,
+                                 entry.num_iterations);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("rank_souffle_profile");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::optional<raksha::analysis::profile::ProfileSortKey> sort_key =
+      raksha::analysis::profile::ParseProfileSortKey(
+          absl::GetFlag(FLAGS_sort_by));
+  if (!sort_key.has_value()) {
+    LOG(ERROR) << "Unknown sort key " << absl::GetFlag(FLAGS_sort_by);
+    return 1;
+  }
+  std::string format = absl::GetFlag(FLAGS_format);
+  if (format != "text" && format != "csv") {
+    LOG(ERROR) << "Unknown report format " << format;
+    return 1;
+  }
+
+  std::filesystem::path profile_log_filepath(absl::GetFlag(FLAGS_profile_log));
+  std::ifstream profile_log_stream(profile_log_filepath);
+  if (!profile_log_stream) {
+    LOG(ERROR) << "Error reading profile log " << profile_log_filepath << ":"
+               << strerror(errno);
+    return 1;
+  }
+  std::stringstream profile_log;
+  profile_log << profile_log_stream.rdbuf();
+  std::optional<raksha::analysis::profile::SouffleProfile> profile =
+      raksha::analysis::profile::SouffleProfile::Parse(profile_log.str());
+  if (!profile.has_value()) return 1;
+
+  uint64_t top = absl::GetFlag(FLAGS_top);
+  std::vector<ProfileEntry> rules =
+      RankProfileEntries(profile->rules(), *sort_key, top);
+  std::vector<ProfileEntry> relations =
+      RankProfileEntries(profile->relations(), *sort_key, top);
+
+  if (format == "csv") {
+    std::cout << "kind,relation,name,source,runtime_ms,tuples,iterations\n";
+    for (const auto &[file, runtime_ms] : profile->RuntimeMsBySourceFile()) {
+      std::cout << absl::StrFormat("file,,,%s,%.3f,,\n", CsvField(file),
+                                   runtime_ms);
+    }
+    PrintCsv("rule", rules);
+    PrintCsv("relation", relations);
+    return 0;
+  }
+
+  std::cout << "Rule runtime by source file:\n";
+  for (const auto &[file, runtime_ms] : profile->RuntimeMsBySourceFile()) {
+    std::cout << absl::StrFormat("%12.3f  %s\n", runtime_ms, file);
+  }
+  std::cout << "\n";
+  PrintText("Rules", rules);
+  PrintText("Relations", relations);
+  return 0;
+}
@@ -0,0 +1,252 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/profile/souffle_profile.h"
+
+#include <google/protobuf/struct.pb.h>
+#include <google/protobuf/util/json_util.h>
+
+#include <algorithm>
+#include <tuple>
+
+#include "absl/container/flat_hash_map.h"
+#include "src/common/logging/logging.h"
+
+namespace raksha::analysis::profile {
+
+namespace {
+
+using google::protobuf::Struct;
+using google::protobuf::Value;
+
+// The profile log is a tree of JSON objects. These helpers return a default
+// for missing or differently typed nodes, so that logs of Souffle versions
+// that record more or less than we read can still be ranked.
+const Value *GetField(const Struct &node, absl::string_view key) {
+  auto find_result = node.fields().find(std::string(key));
+  return (find_result == node.fields().end()) ? nullptr : &find_result->second;
+}
+
+const Struct *GetStruct(const Struct &node, absl::string_view key) {
+  const Value *value = GetField(node, key);
+  return (value != nullptr && value->has_struct_value())
+             ? &value->struct_value()
+             : nullptr;
+}
+
+uint64_t GetNumber(const Struct &node, absl::string_view key) {
+  const Value *value = GetField(node, key);
+  return (value != nullptr && value->kind_case() == Value::kNumberValue)
+             ? static_cast<uint64_t>(value->number_value())
+             : 0;
+}
+
+std::string GetText(const Struct &node, absl::string_view key) {
+  const Value *value = GetField(node, key);
+  return (value != nullptr && value->kind_case() == Value::kStringValue)
+             ? value->string_value()
+             : "";
+}
+
+// Durations are recorded as start and end times in microseconds.
+double GetDurationMs(const Struct &node, absl::string_view key) {
+  const Struct *duration = GetStruct(node, key);
+  if (duration == nullptr) return 0;
+  return (static_cast<double>(GetNumber(*duration, "end")) -
+          static_cast<double>(GetNumber(*duration, "start"))) /
+         1000;
+}
+
+// Returns the base name of the file of a source locator such as
+// "path/to/taint.dl [12:1-14:30]".
+std::string GetSourceFile(absl::string_view source_locator) {
+  absl::string_view file = source_locator.substr(0, source_locator.find(" ["));
+  size_t last_slash = file.find_last_of('/');
+  if (last_slash != absl::string_view::npos) {
+    file = file.substr(last_slash + 1);
+  }
+  return std::string(file);
+}
+
+void SetSourceLocator(const Struct &node, ProfileEntry &entry) {
+  if (!entry.source_locator.empty()) return;
+  entry.source_locator = GetText(node, "source-locator");
+  entry.source_file = GetSourceFile(entry.source_locator);
+}
+
+// Adds the cost recorded by a single execution of a rule to `entry`.
+void AddRuleCost(const Struct &rule, ProfileEntry &entry) {
+  SetSourceLocator(rule, entry);
+  entry.runtime_ms += GetDurationMs(rule, "runtime");
+  entry.num_tuples += GetNumber(rule, "num-tuples");
+}
+
+// Rules are identified by the relation they derive and their text.
+using RuleKey = std::pair<std::string, std::string>;
+
+ProfileEntry &GetRuleEntry(
+    absl::flat_hash_map<RuleKey, ProfileEntry> &rules_by_key,
+    const std::string &relation_name, const std::string &rule_text) {
+  ProfileEntry &entry = rules_by_key[{relation_name, rule_text}];
+  entry.name = rule_text;
+  entry.relation = relation_name;
+  return entry;
+}
+
+std::vector<ProfileEntry> SortedByName(std::vector<ProfileEntry> entries) {
+  std::sort(entries.begin(), entries.end(),
+            [](const ProfileEntry &lhs, const ProfileEntry &rhs) {
+              return std::tie(lhs.relation, lhs.name) <
+                     std::tie(rhs.relation, rhs.name);
+            });
+  return entries;
+}
+
+}  // namespace
+
+std::optional<ProfileSortKey> ParseProfileSortKey(absl::string_view name) {
+  if (name == "runtime") return ProfileSortKey::kRuntime;
+  if (name == "tuples") return ProfileSortKey::kTuples;
+  if (name == "iterations") return ProfileSortKey::kIterations;
+  return std::nullopt;
+}
+
+std::optional<SouffleProfile> SouffleProfile::Parse(
+    absl::string_view profile_log) {
+  Struct log;
+  auto status = google::protobuf::util::JsonStringToMessage(
+      std::string(profile_log), &log);
+  if (!status.ok()) {
+    LOG(ERROR) << "Error parsing the profile log: " << status.ToString();
+    return std::nullopt;
+  }
+  const Struct *root = GetStruct(log, "root");
+  const Struct *program = GetStruct((root != nullptr) ? *root : log, "program");
+  if (program == nullptr) {
+    LOG(ERROR) << "The profile log has no program entry.";
+    return std::nullopt;
+  }
+
+  absl::flat_hash_map<RuleKey, ProfileEntry> rules_by_key;
+  std::vector<ProfileEntry> relations;
+  const Struct *relation_nodes = GetStruct(*program, "relation");
+  if (relation_nodes == nullptr) return SouffleProfile({}, {});
+  for (const auto &[relation_name, relation_value] :
+       relation_nodes->fields()) {
+    if (!relation_value.has_struct_value()) continue;
+    const Struct &relation_node = relation_value.struct_value();
+    ProfileEntry relation{.name = relation_name,
+                          .relation = relation_name,
+                          .source_locator = "",
+                          .source_file = "",
+                          .runtime_ms = 0,
+                          .num_tuples = 0,
+                          .num_iterations = 0};
+    SetSourceLocator(relation_node, relation);
+
+    if (const Struct *rules = GetStruct(relation_node, "non-recursive-rule")) {
+      for (const auto &[rule_text, rule_value] : rules->fields()) {
+        if (!rule_value.has_struct_value()) continue;
+        AddRuleCost(rule_value.struct_value(),
+                    GetRuleEntry(rules_by_key, relation_name, rule_text));
+      }
+    }
+
+    // Recursive relations record their cost and that of their rules once
+    // per iteration, and that of their rules once per version within it.
+    double iterations_runtime_ms = 0;
+    uint64_t iterations_num_tuples = 0;
+    if (const Struct *iterations = GetStruct(relation_node, "iteration")) {
+      for (const auto &[iteration_number, iteration_value] :
+           iterations->fields()) {
+        if (!iteration_value.has_struct_value()) continue;
+        const Struct &iteration = iteration_value.struct_value();
+        ++relation.num_iterations;
+        iterations_runtime_ms += GetDurationMs(iteration, "runtime");
+        iterations_num_tuples += GetNumber(iteration, "num-tuples");
+        const Struct *rules = GetStruct(iteration, "recursive-rule");
+        if (rules == nullptr) continue;
+        for (const auto &[rule_text, versions_value] : rules->fields()) {
+          if (!versions_value.has_struct_value()) continue;
+          ProfileEntry &rule =
+              GetRuleEntry(rules_by_key, relation_name, rule_text);
+          ++rule.num_iterations;
+          for (const auto &[version, version_value] :
+               versions_value.struct_value().fields()) {
+            if (!version_value.has_struct_value()) continue;
+            AddRuleCost(version_value.struct_value(), rule);
+          }
+        }
+      }
+    }
+
+    relation.runtime_ms = (GetField(relation_node, "runtime") != nullptr)
+                              ? GetDurationMs(relation_node, "runtime")
+                              : iterations_runtime_ms;
+    relation.num_tuples = (GetField(relation_node, "num-tuples") != nullptr)
+                              ? GetNumber(relation_node, "num-tuples")
+                              : iterations_num_tuples;
+    relations.push_back(std::move(relation));
+  }
+
+  std::vector<ProfileEntry> rules;
+  for (auto &[key, rule] : rules_by_key) rules.push_back(std::move(rule));
+  return SouffleProfile(SortedByName(std::move(rules)),
+                        SortedByName(std::move(relations)));
+}
+
+std::vector<std::pair<std::string, double>>
+SouffleProfile::RuntimeMsBySourceFile() const {
+  absl::flat_hash_map<std::string, double> runtime_by_file;
+  for (const ProfileEntry &rule : rules_) {
+    runtime_by_file[rule.source_file.empty() ? "<unknown>"
+                                             : rule.source_file] +=
+        rule.runtime_ms;
+  }
+  std::vector<std::pair<std::string, double>> result(runtime_by_file.begin(),
+                                                     runtime_by_file.end());
+  std::sort(result.begin(), result.end(), [](const auto &lhs, const auto &rhs) {
+    return std::make_pair(rhs.second, lhs.first) <
+           std::make_pair(lhs.second, rhs.first);
+  });
+  return result;
+}
+
+std::vector<ProfileEntry> RankProfileEntries(std::vector<ProfileEntry> entries,
+                                             ProfileSortKey key,
+                                             uint64_t top_n) {
+  auto value = [key](const ProfileEntry &entry) -> double {
+    switch (key) {
+      case ProfileSortKey::kRuntime:
+        return entry.runtime_ms;
+      case ProfileSortKey::kTuples:
+        return entry.num_tuples;
+      case ProfileSortKey::kIterations:
+        return entry.num_iterations;
+    }
+    LOG(FATAL) << "Unexpected ProfileSortKey.";
+    return 0;
+  };
+  // The entries come sorted by name, which breaks ties.
+  std::stable_sort(entries.begin(), entries.end(),
+                   [&value](const ProfileEntry &lhs, const ProfileEntry &rhs) {
+                     return value(lhs) > value(rhs);
+                   });
+  if (entries.size() > top_n) entries.resize(top_n);
+  return entries;
+}
+
+}  // namespace raksha::analysis::profile
@@ -0,0 +1,88 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_PROFILE_SOUFFLE_PROFILE_H_
+#define SRC_ANALYSIS_SOUFFLE_PROFILE_SOUFFLE_PROFILE_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+
+namespace raksha::analysis::profile {
+
+// The cost of a rule or a relation, summed over all fixpoint iterations and,
+// for rules, over all versions of a recursive rule.
+struct ProfileEntry {
+  // The text of the rule or the name of the relation.
+  std::string name;
+  // The relation the rule derives, or the relation itself.
+  std::string relation;
+  // Where the rule or relation is declared, such as "taint.dl [12:1-14:30]".
+  std::string source_locator;
+  // The base name of the file in source_locator, such as "taint.dl".
+  std::string source_file;
+  double runtime_ms = 0;
+  uint64_t num_tuples = 0;
+  // The number of fixpoint iterations the rule or relation took part in.
+  // This is 0 for non-recursive rules and relations.
+  uint64_t num_iterations = 0;
+};
+
+// What to rank the entries of a profile by.
+enum class ProfileSortKey { kRuntime, kTuples, kIterations };
+
+// Returns the sort key with the given name ("runtime", "tuples" or
+// "iterations") or std::nullopt if there is none.
+std::optional<ProfileSortKey> ParseProfileSortKey(absl::string_view name);
+
+// The rules and relations of a profile log, as written by a Souffle program
+// compiled with `--profile`.
+class SouffleProfile {
+ public:
+  // Parses the JSON profile log of a Souffle program. Returns std::nullopt
+  // if `profile_log` is not such a log.
+  static std::optional<SouffleProfile> Parse(absl::string_view profile_log);
+
+  const std::vector<ProfileEntry> &rules() const { return rules_; }
+  const std::vector<ProfileEntry> &relations() const { return relations_; }
+
+  // The summed runtime of the rules of each source file, in decreasing
+  // order. This tells the cost of taint.dl apart from that of the checks
+  // generated from a policy.
+  std::vector<std::pair<std::string, double>> RuntimeMsBySourceFile() const;
+
+ private:
+  SouffleProfile(std::vector<ProfileEntry> rules,
+                 std::vector<ProfileEntry> relations)
+      : rules_(std::move(rules)), relations_(std::move(relations)) {}
+
+  std::vector<ProfileEntry> rules_;
+  std::vector<ProfileEntry> relations_;
+};
+
+// Returns the `top_n` entries with the highest value of `key`, in decreasing
+// order.
+std::vector<ProfileEntry> RankProfileEntries(std::vector<ProfileEntry> entries,
+                                             ProfileSortKey key,
+                                             uint64_t top_n);
+
+}  // namespace raksha::analysis::profile
+
+#endif  // SRC_ANALYSIS_SOUFFLE_PROFILE_SOUFFLE_PROFILE_H_
@@ -0,0 +1,171 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/analysis/souffle/profile/souffle_profile.h"
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::analysis::profile {
+
+// An abridged profile log with a non-recursive relation, whose single rule
+// comes from a generated policy, and a recursive relation with a rule that
+// ran in two iterations, once with two versions.
+static constexpr char kProfileLog[] = R"({
+  "root": {
+    "program": {
+      "relation": {
+        "isCheck": {
+          "source-locator": "bazel-out/k8-fastbuild/bin/policy.dl [3:1-3:30]",
+          "runtime": {"start": 1000, "end": 3000},
+          "num-tuples": 4,
+          "non-recursive-rule": {
+            "isCheck(\"check_num_0\",\"R.P#0.in\").": {
+              "source-locator": "bazel-out/k8-fastbuild/bin/policy.dl [3:1-3:30]",
+              "runtime": {"start": 1000, "end": 2500},
+              "num-tuples": 4
+            }
+          }
+        },
+        "path": {
+          "source-locator": "src/analysis/souffle/dataflow_graph.dl [10:7-10:11]",
+          "iteration": {
+            "0": {
+              "runtime": {"start": 5000, "end": 9000},
+              "num-tuples": 10,
+              "recursive-rule": {
+                "path(from,to) :- path(from,mid), edge(mid,to).": {
+                  "0": {
+                    "source-locator": "dataflow_graph.dl [40:1-40:50]",
+                    "runtime": {"start": 5000, "end": 6000},
+                    "num-tuples": 6
+                  },
+                  "1": {
+                    "source-locator": "dataflow_graph.dl [40:1-40:50]",
+                    "runtime": {"start": 6000, "end": 8000},
+                    "num-tuples": 4
+                  }
+                }
+              }
+            },
+            "1": {
+              "runtime": {"start": 9000, "end": 10000},
+              "num-tuples": 0,
+              "recursive-rule": {
+                "path(from,to) :- path(from,mid), edge(mid,to).": {
+                  "0": {
+                    "source-locator": "dataflow_graph.dl [40:1-40:50]",
+                    "runtime": {"start": 9000, "end": 9500},
+                    "num-tuples": 0
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+})";
+
+class SouffleProfileTest : public testing::Test {
+ public:
+  SouffleProfileTest() : profile_(*SouffleProfile::Parse(kProfileLog)) {}
+
+ protected:
+  SouffleProfile profile_;
+};
+
+TEST_F(SouffleProfileTest, SumsRuleCostsOverIterationsAndVersions) {
+  ASSERT_EQ(profile_.rules().size(), 2);
+  const ProfileEntry &is_check_rule = profile_.rules().at(0);
+  EXPECT_EQ(is_check_rule.relation, "isCheck");
+  EXPECT_EQ(is_check_rule.source_file, "policy.dl");
+  EXPECT_DOUBLE_EQ(is_check_rule.runtime_ms, 1.5);
+  EXPECT_EQ(is_check_rule.num_tuples, 4);
+  EXPECT_EQ(is_check_rule.num_iterations, 0);
+
+  const ProfileEntry &path_rule = profile_.rules().at(1);
+  EXPECT_EQ(path_rule.name, "path(from,to) :- path(from,mid), edge(mid,to).");
+  EXPECT_EQ(path_rule.relation, "path");
+  EXPECT_EQ(path_rule.source_locator, "dataflow_graph.dl [40:1-40:50]");
+  EXPECT_EQ(path_rule.source_file, "dataflow_graph.dl");
+  EXPECT_DOUBLE_EQ(path_rule.runtime_ms, 3.5);
+  EXPECT_EQ(path_rule.num_tuples, 10);
+  EXPECT_EQ(path_rule.num_iterations, 2);
+}
+
+TEST_F(SouffleProfileTest, SumsRelationCostsOverIterations) {
+  ASSERT_EQ(profile_.relations().size(), 2);
+  const ProfileEntry &is_check = profile_.relations().at(0);
+  EXPECT_EQ(is_check.name, "isCheck");
+  EXPECT_DOUBLE_EQ(is_check.runtime_ms, 2);
+  EXPECT_EQ(is_check.num_iterations, 0);
+
+  const ProfileEntry &path = profile_.relations().at(1);
+  EXPECT_EQ(path.name, "path");
+  EXPECT_EQ(path.source_file, "dataflow_graph.dl");
+  EXPECT_DOUBLE_EQ(path.runtime_ms, 5);
+  EXPECT_EQ(path.num_tuples, 10);
+  EXPECT_EQ(path.num_iterations, 2);
+}
+
+TEST_F(SouffleProfileTest, GroupsRuntimeBySourceFile) {
+  EXPECT_THAT(profile_.RuntimeMsBySourceFile(),
+              testing::ElementsAre(testing::Pair("dataflow_graph.dl", 3.5),
+                                   testing::Pair("policy.dl", 1.5)));
+}
+
+struct RankTestParam {
+  ProfileSortKey key;
+  std::vector<std::string> expected_relations;
+};
+
+class RankProfileEntriesTest : public testing::TestWithParam<RankTestParam> {};
+
+TEST_P(RankProfileEntriesTest, RanksRelationsByKey) {
+  const RankTestParam &param = GetParam();
+  std::optional<SouffleProfile> profile = SouffleProfile::Parse(kProfileLog);
+  ASSERT_TRUE(profile.has_value());
+  std::vector<std::string> relations;
+  for (const ProfileEntry &entry :
+       RankProfileEntries(profile->relations(), param.key, /*top_n=*/1)) {
+    relations.push_back(entry.name);
+  }
+  EXPECT_EQ(relations, param.expected_relations);
+}
+
+static const RankTestParam kRankTestParams[] = {
+    {.key = ProfileSortKey::kRuntime, .expected_relations = {"path"}},
+    {.key = ProfileSortKey::kTuples, .expected_relations = {"path"}},
+    {.key = ProfileSortKey::kIterations, .expected_relations = {"path"}},
+};
+
+INSTANTIATE_TEST_SUITE_P(RankProfileEntriesTest, RankProfileEntriesTest,
+                         testing::ValuesIn(kRankTestParams));
+
+TEST(SouffleProfileParseTest, RejectsOtherInput) {
+  EXPECT_EQ(SouffleProfile::Parse("not json").has_value(), false);
+  EXPECT_EQ(SouffleProfile::Parse(R"({"root": {}})").has_value(), false);
+}
+
+TEST(ParseProfileSortKeyTest, ParsesKnownKeys) {
+  EXPECT_EQ(ParseProfileSortKey("runtime"), ProfileSortKey::kRuntime);
+  EXPECT_EQ(ParseProfileSortKey("tuples"), ProfileSortKey::kTuples);
+  EXPECT_EQ(ParseProfileSortKey("iterations"), ProfileSortKey::kIterations);
+  EXPECT_EQ(ParseProfileSortKey("memory"), std::nullopt);
+}
+
+}  // namespace raksha::analysis::profile
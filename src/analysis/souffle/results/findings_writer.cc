@@ -0,0 +1,32 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include "src/analysis/souffle/results/findings_writer.h"
+
+namespace raksha::analysis::results {
+
+void FindingsWriter::Write(const CheckFailure &failure) {
+  out_ << "{\"check_failure\": " << ToJson(failure) << "}\n";
+  ++num_check_failures_;
+}
+
+void FindingsWriter::Write(const DisallowedUsage &usage) {
+  out_ << "{\"disallowed_usage\": " << ToJson(usage) << "}\n";
+  ++num_disallowed_usages_;
+}
+
+}  // namespace raksha::analysis::results
@@ -0,0 +1,52 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_RESULTS_FINDINGS_WRITER_H_
+#define SRC_ANALYSIS_SOUFFLE_RESULTS_FINDINGS_WRITER_H_
+
+#include <cstdint>
+#include <ostream>
+
+#include "src/analysis/souffle/results/policy_check_findings.h"
+
+namespace raksha::analysis::results {
+
+// Writes findings to a stream as they are read, one JSON object per line,
+// so that they need not all be kept in memory. The lines look like
+//   {"check_failure": {"check": "check_num_0", "owner": ..., ...}}
+//   {"disallowed_usage": {"consumer": ..., "usage": ..., ...}}
+class FindingsWriter {
+ public:
+  explicit FindingsWriter(std::ostream &out) : out_(out) {}
+
+  void Write(const CheckFailure &failure);
+  void Write(const DisallowedUsage &usage);
+
+  // Whether all writes so far succeeded.
+  bool ok() const { return static_cast<bool>(out_); }
+
+  uint64_t num_check_failures() const { return num_check_failures_; }
+  uint64_t num_disallowed_usages() const { return num_disallowed_usages_; }
+
+ private:
+  std::ostream &out_;
+  uint64_t num_check_failures_ = 0;
+  uint64_t num_disallowed_usages_ = 0;
+};
+
+}  // namespace raksha::analysis::results
+
+#endif  // SRC_ANALYSIS_SOUFFLE_RESULTS_FINDINGS_WRITER_H_
@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include "src/analysis/souffle/results/findings_writer.h"
+
+#include <sstream>
+
+#include "src/common/testing/gtest.h"
+#include "src/xform_to_datalog/check_sources.h"
+
+namespace raksha::analysis::results {
+
+TEST(FindingsWriterTest, WritesOneLinePerFinding) {
+  std::ostringstream out;
+  FindingsWriter writer(out);
+  writer.Write(CheckFailure{.check_label = "check_num_0",
+                            .owner = "UserC",
+                            .access_path = "R.P#0.in"});
+  writer.Write(DisallowedUsage{.consumer = "C",
+                               .usage = "store",
+                               .owner = "UserA",
+                               .tag = "say \"hi\""});
+  EXPECT_TRUE(writer.ok());
+  EXPECT_EQ(writer.num_check_failures(), 1);
+  EXPECT_EQ(writer.num_disallowed_usages(), 1);
+  EXPECT_EQ(out.str(),
+            R"({"check_failure": {"check": "check_num_0", "owner": "UserC", )"
+            R"("access_path": "R.P#0.in"}})"
+            "\n"
+            R"({"disallowed_usage": {"consumer": "C", "usage": "store", )"
+            R"("owner": "UserA", "tag": "say \"hi\""}})"
+            "\n");
+}
+
+TEST(FindingsWriterTest, WritesTheSourceOfACheck) {
+  xform_to_datalog::CheckSource source{.label = "check_num_0",
+                                       .recipe = "R",
+                                       .particle = "P#0",
+                                       .particle_spec = "P",
+                                       .handle_connection = "in",
+                                       .access_path = "R.P#0.in",
+                                       .predicate = "mayHaveTag(\"tag\")"};
+  std::ostringstream out;
+  FindingsWriter writer(out);
+  writer.Write(CheckFailure{.check_label = "check_num_0",
+                            .owner = "UserC",
+                            .access_path = "R.P#0.in",
+                            .source = &source});
+  EXPECT_EQ(out.str(),
+            R"({"check_failure": {"check": "check_num_0", "owner": "UserC", )"
+            R"("access_path": "R.P#0.in", "recipe": "R", "particle": "P#0", )"
+            R"("particle_spec": "P", "handle_connection": "in", )"
+            R"json("predicate": "mayHaveTag(\"tag\")"}})json"
+            "\n");
+}
+
+TEST(CheckFailureTest, IgnoresTheSourceInComparisons) {
+  xform_to_datalog::CheckSource source{.label = "check_num_0",
+                                       .recipe = "R",
+                                       .particle = "P#0",
+                                       .particle_spec = "P",
+                                       .handle_connection = "in",
+                                       .access_path = "P.in",
+                                       .predicate = "mayHaveTag(\"tag\")"};
+  EXPECT_EQ((CheckFailure{.check_label = "check_num_0",
+                          .owner = "UserC",
+                          .access_path = "R.P#0.in",
+                          .source = &source}),
+            (CheckFailure{.check_label = "check_num_0",
+                          .owner = "UserC",
+                          .access_path = "R.P#0.in",
+                          .source = nullptr}));
+}
+
+}  // namespace raksha::analysis::results
@@ -0,0 +1,57 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include "src/analysis/souffle/results/policy_check_findings.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+
+namespace raksha::analysis::results {
+
+std::string JsonString(absl::string_view value) {
+  return absl::StrCat(
+      "\"",
+      absl::StrReplaceAll(value,
+                          {{"\\", "\\\\"}, {"\"", "\\\""}, {"\n", "\\n"}}),
+      "\"");
+}
+
+std::string ToJson(const CheckFailure &failure) {
+  std::string json = absl::StrCat(
+      "{\"check\": ", JsonString(failure.check_label),
+      ", \"owner\": ", JsonString(failure.owner),
+      ", \"access_path\": ", JsonString(failure.access_path));
+  if (const xform_to_datalog::CheckSource *source = failure.source) {
+    absl::StrAppend(&json, ", \"recipe\": ", JsonString(source->recipe),
+                    ", \"particle\": ", JsonString(source->particle),
+                    ", \"particle_spec\": ", JsonString(source->particle_spec),
+                    ", \"handle_connection\": ",
+                    JsonString(source->handle_connection),
+                    ", \"predicate\": ", JsonString(source->predicate));
+  }
+  absl::StrAppend(&json, "}");
+  return json;
+}
+
+std::string ToJson(const DisallowedUsage &usage) {
+  return absl::StrCat("{\"consumer\": ", JsonString(usage.consumer),
+                      ", \"usage\": ", JsonString(usage.usage),
+                      ", \"owner\": ", JsonString(usage.owner),
+                      ", \"tag\": ", JsonString(usage.tag), "}");
+}
+
+}  // namespace raksha::analysis::results
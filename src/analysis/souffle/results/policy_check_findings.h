@@ -0,0 +1,70 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_RESULTS_POLICY_CHECK_FINDINGS_H_
+#define SRC_ANALYSIS_SOUFFLE_RESULTS_POLICY_CHECK_FINDINGS_H_
+
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+#include "src/xform_to_datalog/check_sources.h"
+
+namespace raksha::analysis::results {
+
+// An owner of the access path of a check for whom its predicate does not
+// hold: a checkFailure tuple of a policy_check, which also makes up the
+// `check_index-owner-path` string of a testFails tuple.
+struct CheckFailure {
+  std::string check_label;
+  std::string owner;
+  std::string access_path;
+  // Where the check comes from in the manifest, if known. Not compared.
+  const xform_to_datalog::CheckSource *source = nullptr;
+
+  bool operator==(const CheckFailure &other) const {
+    return check_label == other.check_label && owner == other.owner &&
+           access_path == other.access_path;
+  }
+};
+
+// A disallowedUsage tuple: a consumer says it will use data for a usage
+// that the owner of one of its tags does not say it may.
+struct DisallowedUsage {
+  std::string consumer;
+  std::string usage;
+  std::string owner;
+  std::string tag;
+
+  bool operator==(const DisallowedUsage &other) const {
+    return consumer == other.consumer && usage == other.usage &&
+           owner == other.owner && tag == other.tag;
+  }
+};
+
+// Returns `failure` as a JSON object. The fields of its source are added
+// after the check, owner and access path if it has one.
+std::string ToJson(const CheckFailure &failure);
+
+// Returns `usage` as a JSON object.
+std::string ToJson(const DisallowedUsage &usage);
+
+// Returns `value` as a JSON string, with quotes.
+std::string JsonString(absl::string_view value);
+
+}  // namespace raksha::analysis::results
+
+#endif  // SRC_ANALYSIS_SOUFFLE_RESULTS_POLICY_CHECK_FINDINGS_H_
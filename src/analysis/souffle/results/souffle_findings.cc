@@ -0,0 +1,90 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include "src/analysis/souffle/results/souffle_findings.h"
+
+#include <array>
+#include <string>
+
+#include "src/common/logging/logging.h"
+
+namespace raksha::analysis::results {
+
+namespace {
+
+// Reads the tuples of a relation of symbols, calling `add` with the
+// arguments of each of them. Returns false if there is no such relation.
+template <size_t kArity, typename Add>
+bool ReadRelation(const souffle::SouffleProgram &prog,
+                  const std::string &relation_name, Add add) {
+  souffle::Relation *relation = prog.getRelation(relation_name);
+  if (relation == nullptr) return false;
+  CHECK_EQ(relation->getArity(), kArity)
+      << "Unexpected arity of " << relation_name;
+  std::array<std::string, kArity> arguments;
+  for (souffle::tuple &tuple : *relation) {
+    for (std::string &argument : arguments) tuple >> argument;
+    add(arguments);
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ForEachCheckFailure(
+    const souffle::SouffleProgram &prog,
+    const xform_to_datalog::CheckSources *check_sources,
+    absl::FunctionRef<void(const CheckFailure &)> on_failure) {
+  CheckFailure failure;
+  return ReadRelation<3>(prog, "checkFailure", [&](auto &arguments) {
+    failure.check_label = std::move(arguments[0]);
+    failure.owner = std::move(arguments[1]);
+    failure.access_path = std::move(arguments[2]);
+    failure.source = (check_sources != nullptr)
+                         ? check_sources->Find(failure.check_label)
+                         : nullptr;
+    on_failure(failure);
+  });
+}
+
+bool ForEachDisallowedUsage(
+    const souffle::SouffleProgram &prog,
+    absl::FunctionRef<void(const DisallowedUsage &)> on_usage) {
+  DisallowedUsage usage;
+  return ReadRelation<4>(prog, "disallowedUsage", [&](auto &arguments) {
+    usage.consumer = std::move(arguments[0]);
+    usage.usage = std::move(arguments[1]);
+    usage.owner = std::move(arguments[2]);
+    usage.tag = std::move(arguments[3]);
+    on_usage(usage);
+  });
+}
+
+PolicyCheckFindings ReadPolicyCheckFindings(
+    const souffle::SouffleProgram &prog,
+    const xform_to_datalog::CheckSources *check_sources) {
+  PolicyCheckFindings findings;
+  ForEachCheckFailure(prog, check_sources, [&](const CheckFailure &failure) {
+    findings.check_failures.push_back(failure);
+  });
+  ForEachDisallowedUsage(prog, [&](const DisallowedUsage &usage) {
+    findings.disallowed_usages.push_back(usage);
+  });
+  return findings;
+}
+
+}  // namespace raksha::analysis::results
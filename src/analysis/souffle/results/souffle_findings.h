@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_ANALYSIS_SOUFFLE_RESULTS_SOUFFLE_FINDINGS_H_
+#define SRC_ANALYSIS_SOUFFLE_RESULTS_SOUFFLE_FINDINGS_H_
+
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "souffle/SouffleInterface.h"
+#include "src/analysis/souffle/results/policy_check_findings.h"
+#include "src/xform_to_datalog/check_sources.h"
+
+namespace raksha::analysis::results {
+
+// Calls `on_failure` with each tuple of the checkFailure relation of a
+// policy check program that has run. The sources of the failures are looked
+// up in `check_sources` if it is not nullptr. Returns false if the program
+// has no checkFailure relation, as programs generated before it was added.
+bool ForEachCheckFailure(
+    const souffle::SouffleProgram &prog,
+    const xform_to_datalog::CheckSources *check_sources,
+    absl::FunctionRef<void(const CheckFailure &)> on_failure);
+
+// Calls `on_usage` with each tuple of the disallowedUsage relation of a
+// program that has run. Returns false if the program has no such relation.
+bool ForEachDisallowedUsage(
+    const souffle::SouffleProgram &prog,
+    absl::FunctionRef<void(const DisallowedUsage &)> on_usage);
+
+// All findings of a policy check program, for callers that want them at once.
+struct PolicyCheckFindings {
+  std::vector<CheckFailure> check_failures;
+  std::vector<DisallowedUsage> disallowed_usages;
+};
+
+// Reads the findings of a program that has run, leaving out relations it
+// does not have.
+PolicyCheckFindings ReadPolicyCheckFindings(
+    const souffle::SouffleProgram &prog,
+    const xform_to_datalog::CheckSources *check_sources);
+
+}  // namespace raksha::analysis::results
+
+#endif  // SRC_ANALYSIS_SOUFFLE_RESULTS_SOUFFLE_FINDINGS_H_
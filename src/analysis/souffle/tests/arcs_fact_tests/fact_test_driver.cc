@@ -17,21 +17,70 @@
 // This file is a simple driver to run tests expressed as a datalog script that
 // contains facts describing the dataflow graph (such as edges and tag claims)
 // and our expectations (such as which tags will be present or absent). It
-// returns 1 if the test had contents in the testFails relation, 0 otherwise.
+// returns 1 if the test had contents in the testFails relation, 0 otherwise,
+// and prints the failures of a failed test rather than every output relation.
 // This allows the datalog tests to be run from a bazel cc_test rule and avoids
 // managing external facts files or diffing against an expected output file.
 //
+#include <unistd.h>
+
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
 
 #include "souffle/SouffleInterface.h"
+#include "src/analysis/souffle/results/findings_writer.h"
+#include "src/analysis/souffle/results/souffle_findings.h"
+#include "src/xform_to_datalog/check_sources.h"
+
+using raksha::xform_to_datalog::CheckSources;
 
-int run_test(std::string const &test_name) {
+// Prints why a test failed. The findings of a policy check are printed as
+// JSON lines, with the recipe, particle and predicate of each failed check
+// if its `check_sources` are given. Other tests, and failures that are not
+// findings, have their testFails and duplicateTestCaseNames tuples printed.
+void print_failures(souffle::SouffleProgram const &prog,
+                    CheckSources const *check_sources) {
+  raksha::analysis::results::FindingsWriter writer(std::cout);
+  raksha::analysis::results::ForEachCheckFailure(
+      prog, check_sources,
+      [&](raksha::analysis::results::CheckFailure const &failure) {
+        writer.Write(failure);
+      });
+  raksha::analysis::results::ForEachDisallowedUsage(
+      prog, [&](raksha::analysis::results::DisallowedUsage const &usage) {
+        writer.Write(usage);
+      });
+  if (writer.num_check_failures() + writer.num_disallowed_usages() > 0) {
+    return;
+  }
+  for (std::string const relation_name :
+       {"testFails", "duplicateTestCaseNames"}) {
+    souffle::Relation *relation = prog.getRelation(relation_name);
+    if (relation == nullptr) continue;
+    for (souffle::tuple &tuple : *relation) {
+      std::string test_aspect_name;
+      tuple >> test_aspect_name;
+      std::cout << relation_name << ": " << test_aspect_name << std::endl;
+    }
+  }
+}
+
+int run_test(std::string const &test_name, std::size_t num_threads,
+             CheckSources const *check_sources) {
   // We want one command line arg, the name of the current test module.
   std::unique_ptr<souffle::SouffleProgram> prog(
       souffle::ProgramFactory::newInstance(test_name));
   assert(prog != nullptr);
 
+  if (num_threads > 0) {
+    prog->setNumThreads(num_threads);
+  }
+
   prog->run();
 
   souffle::Relation *test_failures = prog->getRelation("testFails");
@@ -63,19 +112,67 @@ int run_test(std::string const &test_name) {
     std::cout << "Test " << test_name << " succeeded." << std::endl;
     return 0;
   }
-  prog->printAll();
+  print_failures(*prog, check_sources);
   return 1;
 }
 
 int main(int argc, char **argv) {
   // The first command line arg should be the name of the current test. The
-  // second optional argument should indicate whether or not the exit code
-  // of the test should be inverted for expected-fail tests.
-  assert((argc == 2) || (argc == 3));
+  // optional arguments following it are "invert", which indicates that the
+  // exit code of the test should be inverted for expected-fail tests, and
+  // "profile", which indicates that the test was compiled with Souffle's
+  // profiling enabled, "--jobs=N", which sets the number of threads of a
+  // test compiled with OpenMP, and "--check_sources=FILE", which names the
+  // check sources written by generate_datalog_program for a policy check.
+  assert(argc >= 2);
   std::string const test_name = std::string(argv[1]);
-  bool const invert_test = (argc == 3) && (std::string(argv[2]) == "invert");
+  bool invert_test = false;
+  bool profile = false;
+  std::size_t num_threads = 0;
+  std::string const jobs_prefix = "--jobs=";
+  std::string const check_sources_prefix = "--check_sources=";
+  std::string check_sources_file;
+  for (int i = 2; i < argc; ++i) {
+    std::string const option = std::string(argv[i]);
+    invert_test = invert_test || (option == "invert");
+    profile = profile || (option == "profile");
+    if (option.rfind(jobs_prefix, 0) == 0) {
+      num_threads = std::stoul(option.substr(jobs_prefix.size()));
+    }
+    if (option.rfind(check_sources_prefix, 0) == 0) {
+      check_sources_file = option.substr(check_sources_prefix.size());
+    }
+  }
+
+  std::optional<CheckSources> check_sources;
+  if (!check_sources_file.empty()) {
+    std::ifstream check_sources_stream(check_sources_file);
+    std::stringstream check_sources_text;
+    check_sources_text << check_sources_stream.rdbuf();
+    check_sources = CheckSources::Parse(check_sources_text.str());
+    if (!check_sources_stream || !check_sources.has_value()) {
+      std::cout << "Cannot read the check sources " << check_sources_file
+                << std::endl;
+      return 1;
+    }
+  }
+
+  // A profiled program writes its profile log to a path relative to the
+  // working directory. Under bazel test, move to the directory for
+  // undeclared test outputs so that the log is kept after the test.
+  char const *outputs_dir = std::getenv("TEST_UNDECLARED_OUTPUTS_DIR");
+  if (profile && (outputs_dir != nullptr)) {
+    if (chdir(outputs_dir) != 0) {
+      std::cout << "Cannot write the profile log to " << outputs_dir
+                << std::endl;
+      return 1;
+    }
+    std::cout << "Writing the profile log to " << outputs_dir << std::endl;
+  }
 
-  int const test_exit_code = run_test(test_name);
+  int const test_exit_code = run_test(
+      test_name, num_threads,
+      check_sources.has_value() ? &check_sources.value() : nullptr);
   if (invert_test) {
     return (test_exit_code == 0) ? 1 : 0;
   } else {
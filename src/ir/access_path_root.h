@@ -96,6 +96,14 @@ class HandleConnectionAccessPathRoot {
       recipe_name_, particle_name_, handle_connection_name_ }, ".");
   }
 
+  const std::string &recipe_name() const { return recipe_name_; }
+
+  const std::string &particle_name() const { return particle_name_; }
+
+  const std::string &handle_connection_name() const {
+    return handle_connection_name_;
+  }
+
   bool operator==(const HandleConnectionAccessPathRoot &other) const {
     return (recipe_name_ == other.recipe_name_) &&
       (particle_name_ == other.particle_name_) &&
@@ -171,6 +179,10 @@ class AccessPathRoot {
 
   std::string ToDatalog(const DatalogPrintContext &ctxt) const;
 
+  // Exposes the specific root for code that must treat the kinds of roots
+  // differently, such as encoders.
+  const RootVariant &GetRootVariant() const { return specific_root_; }
+
   bool operator==(const AccessPathRoot &other) const {
     return specific_root_ == other.specific_root_;
   }
@@ -33,15 +33,28 @@ class Edge {
 
   // Print the edge as a string containing a Datalog fact.
   std::string ToDatalog(DatalogPrintContext &ctxt) const {
+    std::string printed_from = from_.ToDatalog(ctxt);
+    return ToDatalog(printed_from, to_.ToDatalog(ctxt));
+  }
+
+  // Print an edge between two already printed access paths.
+  static std::string ToDatalog(absl::string_view from, absl::string_view to) {
     constexpr absl::string_view kEdgeFormat = R"(edge("%s", "%s").)";
-    return absl::StrFormat(kEdgeFormat, from_.ToDatalog(ctxt),
-                           to_.ToDatalog(ctxt));
+    return absl::StrFormat(kEdgeFormat, from, to);
   }
 
+  const AccessPath &from() const { return from_; }
+  const AccessPath &to() const { return to_; }
+
   bool operator==(const Edge &other) const {
     return (from_ == other.from_) && (to_ == other.to_);
   }
 
+  template<typename H>
+  friend H AbslHashValue(H h, const Edge &edge) {
+    return H::combine(std::move(h), edge.from_, edge.to_);
+  }
+
  private:
   // The AccessPath we are drawing the edge from.
   AccessPath from_;
@@ -16,6 +16,7 @@
 
 #include "src/ir/edge.h"
 
+#include "absl/hash/hash_testing.h"
 #include "src/common/testing/gtest.h"
 #include "src/ir/access_path_root.h"
 #include "src/ir/datalog_print_context.h"
@@ -109,4 +110,14 @@ INSTANTIATE_TEST_SUITE_P(
                          testing::ValuesIn(sample_access_paths))
         ));
 
+TEST(EdgeHashTest, EdgeHashTest) {
+  std::vector<Edge> edges;
+  for (const AccessPath &from : sample_access_paths) {
+    for (const AccessPath &to : sample_access_paths) {
+      edges.push_back(Edge(from, to));
+    }
+  }
+  EXPECT_TRUE(absl::VerifyTypeImplementsAbslHashCorrectly(edges));
+}
+
 }  // namespace raksha::ir
@@ -22,13 +22,16 @@ std::unique_ptr<ParticleSpec> ParticleSpec::Create(
     std::string name, std::vector<TagCheck> checks,
     std::vector<TagClaim> tag_claims,
     std::vector<DerivesFromClaim> derives_from_claims,
-    std::vector<HandleConnectionSpec> handle_connection_specs) {
+    std::vector<HandleConnectionSpec> handle_connection_specs,
+    DefaultDerivationMode default_derivation_mode) {
   return std::unique_ptr<ParticleSpec>(new ParticleSpec(
       std::move(name), std::move(checks), std::move(tag_claims),
-      std::move(derives_from_claims), std::move(handle_connection_specs)));
+      std::move(derives_from_claims), std::move(handle_connection_specs),
+      default_derivation_mode));
 }
 
-void ParticleSpec::GenerateEdges() {
+void ParticleSpec::GenerateEdges(
+    DefaultDerivationMode default_derivation_mode) {
   // First, iterate over the DerivesFrom claims to see which AccessPaths
   // explicitly derive from some group of inputs. Draw the edges implied by
   // those claims.
@@ -37,6 +40,10 @@ void ParticleSpec::GenerateEdges() {
     derives_from_targets.insert(derives_from_claim.target());
     edges_.push_back(derives_from_claim.GetAsEdge());
   }
+  // Repeated DerivesFrom claims draw the same edge. The default-dataflow
+  // edges below are distinct from each other and from these, as their
+  // targets have no DerivesFrom claims.
+  num_duplicates_.edges = utils::RemoveDuplicates(edges_);
 
   // Now that we have handle the explicit edges, draw the default-dataflow
   // edges (ie, assume that all inputs flow to all outputs without an
@@ -74,21 +81,47 @@ void ParticleSpec::GenerateEdges() {
 
   // Now that we have populated all of the access paths, draw the edges for
   // default dataflow.
-  // TODO(#99): Right now, we draw edges from all input access paths to all
-  // output access paths. This is quadratic; we should draw all edges without
-  // explicit DerivesFrom claims to and from a nexus AccessPath to produce a
-  // linear number of edges instead.
-  // Note: we iterate over output paths in the outer loop and input edges in
-  // the inner loop. We do this because it is entirely possible that there
-  // was a DerivesFrom claim for each output, making the
-  // default_derivation_output_access_paths empty. Putting the outputs in the
-  // outer loop allows us to do 0 iterations in that case instead of I, where
-  // I is the number of input_access_paths.
-  for (const AccessPath &output : default_derivation_output_access_paths) {
-    for (const AccessPath &input : input_access_paths) {
-      edges_.push_back(Edge(input, output));
+  switch (default_derivation_mode) {
+    case DefaultDerivationMode::kCartesian: {
+      // Note: we iterate over output paths in the outer loop and input edges
+      // in the inner loop. We do this because it is entirely possible that
+      // there was a DerivesFrom claim for each output, making the
+      // default_derivation_output_access_paths empty. Putting the outputs in
+      // the outer loop allows us to do 0 iterations in that case instead of
+      // I, where I is the number of input_access_paths.
+      num_default_derivation_edges_ =
+          default_derivation_output_access_paths.size() *
+          input_access_paths.size();
+      for (const AccessPath &output : default_derivation_output_access_paths) {
+        for (const AccessPath &input : input_access_paths) {
+          edges_.push_back(Edge(input, output));
+        }
+      }
+      return;
+    }
+    case DefaultDerivationMode::kMidpoint: {
+      // Route all default dataflow through a single midpoint AccessPath to
+      // draw a linear number of edges. If there are no inputs or no outputs
+      // there is no dataflow to route, so don't create a midpoint at all.
+      if (input_access_paths.empty() ||
+          default_derivation_output_access_paths.empty()) {
+        return;
+      }
+      num_default_derivation_edges_ =
+          input_access_paths.size() +
+          default_derivation_output_access_paths.size();
+      AccessPath midpoint(GetMidpointAccessPathRoot(name_),
+                          AccessPathSelectors());
+      for (AccessPath &input : input_access_paths) {
+        edges_.push_back(Edge(std::move(input), midpoint));
+      }
+      for (AccessPath &output : default_derivation_output_access_paths) {
+        edges_.push_back(Edge(midpoint, std::move(output)));
+      }
+      return;
     }
   }
+  LOG(FATAL) << "Unexpected DefaultDerivationMode.";
 }
 
 }  // namespace raksha::xform_to_datalog::arcs_manifest_tree
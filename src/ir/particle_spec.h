@@ -27,6 +27,7 @@
 #include "src/ir/predicate.h"
 #include "src/ir/tag_check.h"
 #include "src/ir/tag_claim.h"
+#include "src/utils/remove_duplicates.h"
 
 namespace raksha::ir {
 
@@ -37,11 +38,52 @@ namespace raksha::ir {
 // are instantiated with a fully-instantiated root.
 class ParticleSpec {
  public:
+  // Describes how the default-derivation edges (those between inputs and
+  // outputs without an explicit DerivesFrom claim) are drawn.
+  enum class DefaultDerivationMode {
+    // Draw an edge from every input to every output. This produces
+    // inputs * outputs edges.
+    kCartesian,
+    // Draw an edge from every input to a single synthetic midpoint access
+    // path and from the midpoint to every output. This produces
+    // inputs + outputs edges. Tags reaching an output, and thus any
+    // removeTag claims and checks on outputs, are unaffected. The individual
+    // input-to-output edges no longer exist, though, so this mode must not
+    // be used with claimNotEdge facts on default-derivation edges.
+    kMidpoint,
+  };
+
+  // The name of the synthetic HandleConnectionSpec rooting the midpoint
+  // access path in DefaultDerivationMode::kMidpoint. This cannot collide
+  // with the name of a real HandleConnectionSpec.
+  static constexpr absl::string_view kMidpointHandleConnectionSpecName =
+      "$midpoint";
+
+  // The numbers of duplicate checks, claims and edges that were dropped.
+  // Souffle would drop the facts printed for them anyway, but only after
+  // parsing and interning every copy.
+  struct DuplicateCounts {
+    uint64_t tag_claims = 0;
+    uint64_t checks = 0;
+    uint64_t edges = 0;
+  };
+
   static std::unique_ptr<ParticleSpec> Create(
       std::string name, std::vector<TagCheck> checks,
       std::vector<TagClaim> tag_claims,
       std::vector<DerivesFromClaim> derives_from_claims,
-      std::vector<HandleConnectionSpec> handle_connection_specs);
+      std::vector<HandleConnectionSpec> handle_connection_specs,
+      DefaultDerivationMode default_derivation_mode =
+          DefaultDerivationMode::kCartesian);
+
+  // Returns the root of the midpoint access path for the ParticleSpec with
+  // the given name.
+  static AccessPathRoot GetMidpointAccessPathRoot(
+      absl::string_view particle_spec_name) {
+    return AccessPathRoot(HandleConnectionSpecAccessPathRoot(
+        std::string(particle_spec_name),
+        std::string(kMidpointHandleConnectionSpecName)));
+  }
 
   const std::string &name() const { return name_; }
   const std::vector<TagCheck> &checks() const { return checks_; }
@@ -49,6 +91,15 @@ class ParticleSpec {
     return tag_claims_;
   }
   const std::vector<Edge> &edges() const { return edges_; }
+  // The number of edges drawn by the default-derivation rule, as opposed
+  // to those drawn for DerivesFrom claims.
+  uint64_t num_default_derivation_edges() const {
+    return num_default_derivation_edges_;
+  }
+  // The duplicates dropped from the checks, claims and DerivesFrom edges of
+  // this ParticleSpec. Each of them would have been printed once for every
+  // particle of this ParticleSpec.
+  const DuplicateCounts &num_duplicates() const { return num_duplicates_; }
 
   const HandleConnectionSpec &getHandleConnectionSpec(
       const absl::string_view hcs_name) const {
@@ -63,11 +114,13 @@ class ParticleSpec {
   ParticleSpec(std::string name, std::vector<TagCheck> checks,
                std::vector<TagClaim> tag_claims,
                std::vector<DerivesFromClaim> derives_from_claims,
-               std::vector<HandleConnectionSpec> handle_connection_specs)
+               std::vector<HandleConnectionSpec> handle_connection_specs,
+               DefaultDerivationMode default_derivation_mode)
       : name_(std::move(name)),
         checks_(std::move(checks)),
         tag_claims_(std::move(tag_claims)),
-        derives_from_claims_(std::move(derives_from_claims)) {
+        derives_from_claims_(std::move(derives_from_claims)),
+        num_default_derivation_edges_(0) {
     for (HandleConnectionSpec &handle_connection_spec :
       handle_connection_specs) {
       std::string hcs_name = handle_connection_spec.name();
@@ -76,11 +129,13 @@ class ParticleSpec {
       CHECK(ins_res.second)
         << "Found two HandleConnectionSpecs with same name.";
     }
-    GenerateEdges();
+    num_duplicates_.checks = utils::RemoveDuplicates(checks_);
+    num_duplicates_.tag_claims = utils::RemoveDuplicates(tag_claims_);
+    GenerateEdges(default_derivation_mode);
   }
 
   // Generate the edges between HandleConnectionSpecs within this ParticleSpec.
-  void GenerateEdges();
+  void GenerateEdges(DefaultDerivationMode default_derivation_mode);
 
   // The name of this ParticleSpec.
   std::string name_;
@@ -97,6 +152,9 @@ class ParticleSpec {
   // HandleConnectionSpecs. These edges are all between uninstantiated
   // AccessPaths.
   std::vector<Edge> edges_;
+  // The number of edges_ drawn by the default-derivation rule.
+  uint64_t num_default_derivation_edges_;
+  DuplicateCounts num_duplicates_;
   // A map of HandleConnectionSpec names to HandleConnectionSpecs.
   absl::flat_hash_map<std::string, HandleConnectionSpec>
     handle_connection_specs_;
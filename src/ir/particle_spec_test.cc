@@ -18,6 +18,8 @@
 
 #include <google/protobuf/text_format.h>
 
+#include <algorithm>
+
 #include "src/common/testing/gtest.h"
 #include "src/common/logging/logging.h"
 #include "src/ir/proto/particle_spec.h"
@@ -493,4 +495,150 @@ INSTANTIATE_TEST_SUITE_P(
     ParticleSpecFromProtoTest, ParticleSpecFromProtoTest,
     testing::ValuesIn(spec_proto_and_expected_info));
 
+struct MidpointTextprotoAndExpectedEdges {
+  std::string textproto;
+  std::vector<Edge> expected_edges;
+};
+
+class ParticleSpecMidpointTest
+    : public testing::TestWithParam<MidpointTextprotoAndExpectedEdges> {};
+
+TEST_P(ParticleSpecMidpointTest, ParticleSpecMidpointTest) {
+  const MidpointTextprotoAndExpectedEdges &param = GetParam();
+  arcs::ParticleSpecProto particle_spec_proto;
+  CHECK(google::protobuf::TextFormat::ParseFromString(param.textproto,
+                                                      &particle_spec_proto))
+      << "Particle spec textproto did not parse correctly.";
+  std::unique_ptr<ParticleSpec> particle_spec = proto::Decode(
+      particle_spec_proto, ParticleSpec::DefaultDerivationMode::kMidpoint);
+  EXPECT_THAT(particle_spec->edges(),
+              testing::UnorderedElementsAreArray(param.expected_edges));
+  // Every edge to or from the midpoint is a default-derivation edge.
+  AccessPath midpoint(ParticleSpec::GetMidpointAccessPathRoot("PS1"),
+                      AccessPathSelectors());
+  EXPECT_EQ(particle_spec->num_default_derivation_edges(),
+            std::count_if(param.expected_edges.begin(),
+                          param.expected_edges.end(),
+                          [&midpoint](const Edge &edge) {
+                            return edge.from() == midpoint ||
+                                   edge.to() == midpoint;
+                          }));
+}
+
+static const AccessPath kPs1Midpoint(
+    ParticleSpec::GetMidpointAccessPathRoot("PS1"), AccessPathSelectors());
+
+static MidpointTextprotoAndExpectedEdges midpoint_textproto_and_edges[] = {
+    // No inputs, so no midpoint.
+    {.textproto = R"(
+name: "PS1" connections: [
+  { name: "out_handle" direction: WRITES type: { primitive: TEXT } } ])",
+     .expected_edges = {}},
+    // Two inputs and three outputs produce five edges rather than six.
+    {.textproto = R"(
+name: "PS1" connections: [
+  {
+    name: "out_handle" direction: WRITES
+    type: {
+      entity: {
+        schema: {
+          fields: [
+            { key: "field1", value: { primitive: TEXT } },
+            { key: "field2", value: { primitive: TEXT } },
+            { key: "field3", value: { primitive: TEXT } }] } } } },
+  {
+    name: "in_handle" direction: READS
+    type: {
+      entity: {
+        schema: {
+          fields: [
+            { key: "field2", value: { primitive: TEXT } },
+            { key: "world", value: { primitive: TEXT } } ] } } } } ])",
+     .expected_edges =
+         {
+             Edge(AccessPath(kPs1InHandleRoot,
+                             MakeSingleFieldSelectors("field2")),
+                  kPs1Midpoint),
+             Edge(AccessPath(kPs1InHandleRoot,
+                             MakeSingleFieldSelectors("world")),
+                  kPs1Midpoint),
+             Edge(kPs1Midpoint, AccessPath(kPs1OutHandleRoot,
+                                           MakeSingleFieldSelectors("field1"))),
+             Edge(kPs1Midpoint, AccessPath(kPs1OutHandleRoot,
+                                           MakeSingleFieldSelectors("field2"))),
+             Edge(kPs1Midpoint, AccessPath(kPs1OutHandleRoot,
+                                           MakeSingleFieldSelectors("field3"))),
+         }},
+    // Outputs with DerivesFrom claims do not use the midpoint.
+    {.textproto = R"(
+name: "PS1" connections: [
+  { name: "out_handle" direction: WRITES type: { primitive: TEXT } },
+  { name: "in_handle" direction: READS type: { primitive: TEXT } },
+  { name: "in_out_handle" direction: READS_WRITES
+    type: { primitive: TEXT } } ]
+claims: [
+  { derives_from: {
+      target: {
+        handle: { particle_spec: "PS1" handle_connection: "out_handle" } }
+      source: {
+        handle: { particle_spec: "PS1" handle_connection: "in_handle" } }
+  } } ])",
+     .expected_edges = {
+         Edge(AccessPath(kPs1InHandleRoot, AccessPathSelectors()),
+              AccessPath(kPs1OutHandleRoot, AccessPathSelectors())),
+         Edge(AccessPath(kPs1InHandleRoot, AccessPathSelectors()),
+              kPs1Midpoint),
+         Edge(AccessPath(kPs1InOutHandleRoot, AccessPathSelectors()),
+              kPs1Midpoint),
+         Edge(kPs1Midpoint,
+              AccessPath(kPs1InOutHandleRoot, AccessPathSelectors())),
+     }}};
+
+INSTANTIATE_TEST_SUITE_P(
+    ParticleSpecMidpointTest, ParticleSpecMidpointTest,
+    testing::ValuesIn(midpoint_textproto_and_edges));
+
+// A spec in the default kCartesian mode has an edge from every input field
+// to every output field.
+TEST(ParticleSpecCartesianTest, DrawsAllCartesianEdges) {
+  arcs::ParticleSpecProto particle_spec_proto;
+  CHECK(google::protobuf::TextFormat::ParseFromString(R"(
+name: "PS1" connections: [
+  {
+    name: "out_handle" direction: WRITES
+    type: {
+      entity: {
+        schema: {
+          fields: [
+            { key: "field1", value: { primitive: TEXT } },
+            { key: "field2", value: { primitive: TEXT } },
+            { key: "field3", value: { primitive: TEXT } }] } } } },
+  {
+    name: "in_handle" direction: READS
+    type: {
+      entity: {
+        schema: {
+          fields: [
+            { key: "field1", value: { primitive: TEXT } },
+            { key: "field2", value: { primitive: TEXT } },
+            { key: "field3", value: { primitive: TEXT } }] } } } } ])",
+                                                      &particle_spec_proto))
+      << "Particle spec textproto did not parse correctly.";
+  std::unique_ptr<ParticleSpec> particle_spec = proto::Decode(
+      particle_spec_proto, ParticleSpec::DefaultDerivationMode::kCartesian);
+  std::vector<Edge> expected_edges;
+  for (absl::string_view in_field : {"field1", "field2", "field3"}) {
+    for (absl::string_view out_field : {"field1", "field2", "field3"}) {
+      expected_edges.push_back(
+          Edge(AccessPath(kPs1InHandleRoot,
+                          MakeSingleFieldSelectors(std::string(in_field))),
+               AccessPath(kPs1OutHandleRoot,
+                          MakeSingleFieldSelectors(std::string(out_field)))));
+    }
+  }
+  EXPECT_EQ(particle_spec->edges().size(), 9u);
+  EXPECT_THAT(particle_spec->edges(),
+              testing::UnorderedElementsAreArray(expected_edges));
+}
+
 }  // namespace raksha::ir
@@ -19,6 +19,7 @@
 
 #include <memory>
 
+#include "absl/functional/function_ref.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/string_view.h"
 #include "src/ir/access_path.h"
@@ -49,6 +50,12 @@ class Predicate {
   // the given condition holds.
   virtual std::string ToDatalogRuleBody(
       const AccessPath &ap, const DatalogPrintContext &ctxt) const = 0;
+  // Returns whether this predicate holds for an owner of an access path,
+  // given whether each tag may be present on it for that owner. This agrees
+  // with the rule body above and lets callers that read mayHaveTag from the
+  // analysis evaluate checks without generating rules for them.
+  virtual bool IsSatisfied(
+      absl::FunctionRef<bool(absl::string_view)> tag_may_be_present) const = 0;
   virtual PredicateKind GetPredicateKind() const = 0;
   virtual bool operator==(Predicate const &other) const = 0;
 
@@ -79,6 +86,12 @@ class And : public Predicate {
                            rhs_->ToDatalogRuleBody(ap, ctxt));
   }
 
+  bool IsSatisfied(absl::FunctionRef<bool(absl::string_view)>
+                       tag_may_be_present) const override {
+    return lhs_->IsSatisfied(tag_may_be_present) &&
+           rhs_->IsSatisfied(tag_may_be_present);
+  }
+
   static PredicateKind GetKind() { return kAnd; }
 
   PredicateKind GetPredicateKind() const override { return GetKind(); }
@@ -119,6 +132,12 @@ class Implies : public Predicate {
                            consequent_->ToDatalogRuleBody(ap, ctxt));
   }
 
+  bool IsSatisfied(absl::FunctionRef<bool(absl::string_view)>
+                       tag_may_be_present) const override {
+    return !antecedent_->IsSatisfied(tag_may_be_present) ||
+           consequent_->IsSatisfied(tag_may_be_present);
+  }
+
   static PredicateKind GetKind() { return PredicateKind::kImplies; }
 
   PredicateKind GetPredicateKind() const override { return GetKind(); }
@@ -152,6 +171,11 @@ class Not : public Predicate {
                            negated_predicate_->ToDatalogRuleBody(ap, ctxt));
   }
 
+  bool IsSatisfied(absl::FunctionRef<bool(absl::string_view)>
+                       tag_may_be_present) const override {
+    return !negated_predicate_->IsSatisfied(tag_may_be_present);
+  }
+
   static PredicateKind GetKind() { return PredicateKind::kNot; }
 
   PredicateKind GetPredicateKind() const override { return GetKind(); }
@@ -183,6 +207,12 @@ class Or : public Predicate {
                            rhs_->ToDatalogRuleBody(ap, ctxt));
   }
 
+  bool IsSatisfied(absl::FunctionRef<bool(absl::string_view)>
+                       tag_may_be_present) const override {
+    return lhs_->IsSatisfied(tag_may_be_present) ||
+           rhs_->IsSatisfied(tag_may_be_present);
+  }
+
   static PredicateKind GetKind() { return PredicateKind::kOr; }
 
   PredicateKind GetPredicateKind() const override { return GetKind(); }
@@ -215,6 +245,11 @@ class TagPresence : public Predicate {
     return absl::StrFormat(kFormatStr, access_path.ToDatalog(ctxt), tag_);
   }
 
+  bool IsSatisfied(absl::FunctionRef<bool(absl::string_view)>
+                       tag_may_be_present) const override {
+    return tag_may_be_present(tag_);
+  }
+
   static PredicateKind GetKind() { return kTagPresence; }
 
   PredicateKind GetPredicateKind() const override { return GetKind(); }
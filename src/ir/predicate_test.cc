@@ -189,4 +189,37 @@ INSTANTIATE_TEST_SUITE_P(
         testing::ValuesIn(example_predicates),
         testing::ValuesIn(example_predicates)));
 
+struct IsSatisfiedTestParam {
+  const Predicate *predicate;
+  bool expected_result;
+};
+
+class IsSatisfiedTest : public testing::TestWithParam<IsSatisfiedTestParam> {};
+
+// Only tag1 and tag3 may be present.
+TEST_P(IsSatisfiedTest, IsSatisfiedTest) {
+  auto tag_may_be_present = [](absl::string_view tag) {
+    return tag == "tag1" || tag == "tag3";
+  };
+  EXPECT_EQ(GetParam().predicate->IsSatisfied(tag_may_be_present),
+            GetParam().expected_result);
+}
+
+static const IsSatisfiedTestParam kIsSatisfiedTestParams[] = {
+    {.predicate = &kTag1Present, .expected_result = true},
+    {.predicate = &kTag2Present, .expected_result = false},
+    {.predicate = &kAndTag1Tag2, .expected_result = false},
+    {.predicate = &kAndTag1Tag3, .expected_result = true},
+    {.predicate = &kOrTag1Tag2, .expected_result = true},
+    {.predicate = &kOrTag2Tag3, .expected_result = true},
+    {.predicate = &kImpliesTag1Tag2, .expected_result = false},
+    {.predicate = &kImpliesTag1Tag3, .expected_result = true},
+    {.predicate = &kImpliesTag2Tag3, .expected_result = true},
+    {.predicate = &kNotTag1, .expected_result = false},
+    {.predicate = &kNotTag2, .expected_result = true},
+};
+
+INSTANTIATE_TEST_SUITE_P(IsSatisfiedTest, IsSatisfiedTest,
+                         testing::ValuesIn(kIsSatisfiedTestParams));
+
 }  // namespace raksha::ir
@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/ir/proto/manifest_file.h"
+
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include <limits>
+
+#include "src/common/logging/logging.h"
+#include "src/utils/mapped_file.h"
+
+namespace raksha::ir::proto {
+
+namespace {
+
+// Large manifests have many messages. Growing the blocks of the arena up to
+// this size keeps their number low.
+constexpr size_t kMaxArenaBlockSize = size_t{8} << 20;
+
+}  // namespace
+
+std::unique_ptr<ManifestFile> ManifestFile::Load(
+    const std::filesystem::path &path) {
+  std::unique_ptr<utils::MappedFile> mapped_file =
+      utils::MappedFile::Open(path, MADV_SEQUENTIAL);
+  if (mapped_file == nullptr) return nullptr;
+  if (mapped_file->size() > std::numeric_limits<int>::max()) {
+    LOG(ERROR) << "The manifest proto file " << path
+               << " is larger than the 2 GB that protobuf can parse.";
+    return nullptr;
+  }
+
+  google::protobuf::ArenaOptions options;
+  options.max_block_size = kMaxArenaBlockSize;
+  std::unique_ptr<ManifestFile> manifest_file(new ManifestFile(options));
+  manifest_file->file_size_ = mapped_file->size();
+  google::protobuf::io::ArrayInputStream stream(mapped_file->data(),
+                                                mapped_file->size());
+  if (!manifest_file->manifest_proto_->ParseFromZeroCopyStream(&stream)) {
+    LOG(ERROR) << "Error parsing the manifest proto " << path;
+    return nullptr;
+  }
+  return manifest_file;
+}
+
+}  // namespace raksha::ir::proto
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_IR_PROTO_MANIFEST_FILE_H_
+#define SRC_IR_PROTO_MANIFEST_FILE_H_
+
+#include <google/protobuf/arena.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+
+#include "third_party/arcs/proto/manifest.pb.h"
+
+namespace raksha::ir::proto {
+
+// A manifest proto read from a file. The file is mapped into memory and
+// parsed in place, without copying it through a stream buffer, into a
+// protobuf arena, which frees all of its messages and strings at once.
+//
+// The IR decoded from the manifest owns copies of the strings it needs, so
+// the ManifestFile may be destroyed once the manifest has been decoded.
+class ManifestFile {
+ public:
+  // Returns nullptr and logs an error if the file cannot be read or parsed.
+  static std::unique_ptr<ManifestFile> Load(const std::filesystem::path &path);
+
+  ManifestFile(const ManifestFile &) = delete;
+  ManifestFile &operator=(const ManifestFile &) = delete;
+
+  const arcs::ManifestProto &manifest_proto() const {
+    return *manifest_proto_;
+  }
+  uint64_t file_size() const { return file_size_; }
+  // The bytes of the blocks of the arena that hold messages.
+  uint64_t arena_bytes() const { return arena_.SpaceUsed(); }
+
+ private:
+  explicit ManifestFile(const google::protobuf::ArenaOptions &options)
+      : arena_(options),
+        manifest_proto_(google::protobuf::Arena::CreateMessage<
+                        arcs::ManifestProto>(&arena_)) {}
+
+  google::protobuf::Arena arena_;
+  arcs::ManifestProto *manifest_proto_;
+  uint64_t file_size_ = 0;
+};
+
+}  // namespace raksha::ir::proto
+
+#endif  // SRC_IR_PROTO_MANIFEST_FILE_H_
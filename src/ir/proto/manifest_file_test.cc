@@ -0,0 +1,84 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/ir/proto/manifest_file.h"
+
+#include <google/protobuf/text_format.h>
+
+#include <fstream>
+
+#include "absl/strings/string_view.h"
+#include "src/common/testing/gtest.h"
+
+namespace raksha::ir::proto {
+
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Relay" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } },
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Relay" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } },
+              { name: "out" handle: "h2" type: { primitive: TEXT } } ] } ] } ]
+)";
+
+class ManifestFileTest : public testing::Test {
+ protected:
+  std::filesystem::path WriteFile(absl::string_view name,
+                                  absl::string_view contents) {
+    std::filesystem::path path =
+        std::filesystem::path(testing::TempDir()) / std::string(name);
+    std::ofstream(path, std::ios::out | std::ios::trunc | std::ios::binary)
+        << contents;
+    return path;
+  }
+};
+
+TEST_F(ManifestFileTest, LoadsAManifest) {
+  arcs::ManifestProto manifest_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                            &manifest_proto));
+  std::string serialized = manifest_proto.SerializeAsString();
+  std::unique_ptr<ManifestFile> manifest_file =
+      ManifestFile::Load(WriteFile("manifest.binarypb", serialized));
+  ASSERT_NE(manifest_file, nullptr);
+  EXPECT_EQ(manifest_file->file_size(), serialized.size());
+  EXPECT_GT(manifest_file->arena_bytes(), 0);
+  EXPECT_EQ(manifest_file->manifest_proto().SerializeAsString(), serialized);
+  EXPECT_EQ(manifest_file->manifest_proto().recipes(0).particles(0).spec_name(),
+            "Relay");
+}
+
+TEST_F(ManifestFileTest, LoadsAnEmptyManifest) {
+  std::unique_ptr<ManifestFile> manifest_file =
+      ManifestFile::Load(WriteFile("empty.binarypb", ""));
+  ASSERT_NE(manifest_file, nullptr);
+  EXPECT_EQ(manifest_file->file_size(), 0);
+  EXPECT_EQ(manifest_file->manifest_proto().particle_specs_size(), 0);
+}
+
+TEST_F(ManifestFileTest, RejectsMissingAndMalformedFiles) {
+  EXPECT_EQ(ManifestFile::Load(std::filesystem::path(testing::TempDir()) /
+                               "missing.binarypb"),
+            nullptr);
+  EXPECT_EQ(ManifestFile::Load(WriteFile("malformed.binarypb", "\xff\xff")),
+            nullptr);
+}
+
+}  // namespace raksha::ir::proto
@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/ir/proto/manifest_stream.h"
+
+#include <google/protobuf/util/delimited_message_util.h>
+
+#include "src/common/logging/logging.h"
+
+namespace raksha::ir::proto {
+
+using google::protobuf::util::ParseDelimitedFromZeroCopyStream;
+using google::protobuf::util::SerializeDelimitedToOstream;
+
+bool WriteManifestStream(const arcs::ManifestProto &manifest_proto,
+                         std::ostream &output) {
+  arcs::ManifestProto particle_specs;
+  *particle_specs.mutable_particle_specs() = manifest_proto.particle_specs();
+  if (!SerializeDelimitedToOstream(particle_specs, &output)) return false;
+  for (const arcs::RecipeProto &recipe_proto : manifest_proto.recipes()) {
+    if (!SerializeDelimitedToOstream(recipe_proto, &output)) return false;
+  }
+  return true;
+}
+
+std::unique_ptr<ManifestStreamReader> ManifestStreamReader::Create(
+    std::istream &input) {
+  std::unique_ptr<ManifestStreamReader> reader(
+      new ManifestStreamReader(input));
+  if (!ParseDelimitedFromZeroCopyStream(&reader->particle_specs_,
+                                        &reader->input_,
+                                        /*clean_eof=*/nullptr)) {
+    LOG(ERROR) << "Error parsing the particle specs of the manifest stream";
+    return nullptr;
+  }
+  if (reader->particle_specs_.recipes_size() != 0) {
+    LOG(ERROR) << "The particle specs of the manifest stream must not be "
+                  "followed by recipes in the same record";
+    return nullptr;
+  }
+  return reader;
+}
+
+bool ManifestStreamReader::ReadRecipe(arcs::RecipeProto &recipe_proto) {
+  if (failed_) return false;
+  // Parsing merges into the message rather than replacing it.
+  recipe_proto.Clear();
+  bool clean_eof = false;
+  if (!ParseDelimitedFromZeroCopyStream(&recipe_proto, &input_, &clean_eof)) {
+    if (clean_eof) return false;
+    LOG(ERROR) << "Error parsing recipe " << num_recipes_
+               << " of the manifest stream";
+    failed_ = true;
+    return false;
+  }
+  ++num_recipes_;
+  return true;
+}
+
+}  // namespace raksha::ir::proto
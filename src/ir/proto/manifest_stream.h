@@ -0,0 +1,73 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_IR_PROTO_MANIFEST_STREAM_H_
+#define SRC_IR_PROTO_MANIFEST_STREAM_H_
+
+#include <google/protobuf/io/zero_copy_stream_impl.h>
+
+#include <istream>
+#include <memory>
+#include <ostream>
+
+#include "third_party/arcs/proto/manifest.pb.h"
+
+namespace raksha::ir::proto {
+
+// A manifest stream is a manifest written as length-delimited records: a
+// ManifestProto with the particle specs of the manifest and no recipes,
+// followed by one RecipeProto per recipe. Unlike a ManifestProto, it can be
+// read one recipe at a time, so that only the particle specs and the
+// current recipe have to be in memory.
+
+// Writes `manifest_proto` to `output` as a manifest stream. Returns false if
+// the output fails.
+bool WriteManifestStream(const arcs::ManifestProto &manifest_proto,
+                         std::ostream &output);
+
+// Reads the recipes of a manifest stream one at a time.
+class ManifestStreamReader {
+ public:
+  // Reads the particle specs at the start of `input`, which must outlive
+  // the reader. Returns nullptr and logs an error if they cannot be parsed.
+  static std::unique_ptr<ManifestStreamReader> Create(std::istream &input);
+
+  ManifestStreamReader(const ManifestStreamReader &) = delete;
+  ManifestStreamReader &operator=(const ManifestStreamReader &) = delete;
+
+  // The particle specs of the manifest, in a ManifestProto without recipes.
+  const arcs::ManifestProto &particle_specs() const { return particle_specs_; }
+
+  // Reads the next recipe into `recipe_proto`. Returns false at the end of
+  // the stream and if the recipe cannot be parsed, in which case `failed`
+  // is true and an error is logged.
+  bool ReadRecipe(arcs::RecipeProto &recipe_proto);
+
+  bool failed() const { return failed_; }
+  uint64_t num_recipes() const { return num_recipes_; }
+
+ private:
+  explicit ManifestStreamReader(std::istream &input) : input_(&input) {}
+
+  google::protobuf::io::IstreamInputStream input_;
+  arcs::ManifestProto particle_specs_;
+  bool failed_ = false;
+  uint64_t num_recipes_ = 0;
+};
+
+}  // namespace raksha::ir::proto
+
+#endif  // SRC_IR_PROTO_MANIFEST_STREAM_H_
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/ir/proto/manifest_stream.h"
+
+#include <google/protobuf/text_format.h>
+#include <google/protobuf/util/delimited_message_util.h>
+
+#include <sstream>
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::ir::proto {
+
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Relay" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } },
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ] } ]
+    recipes: [
+      { name: "R1"
+        particles: [
+          { spec_name: "Relay" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } },
+              { name: "out" handle: "h2" type: { primitive: TEXT } } ] } ] },
+      { particles: [ { spec_name: "Relay" } ] } ]
+)";
+
+class ManifestStreamTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+        kManifestTextproto, &manifest_proto_));
+  }
+
+  arcs::ManifestProto manifest_proto_;
+};
+
+TEST_F(ManifestStreamTest, ReadsTheRecipesThatWereWritten) {
+  std::stringstream stream;
+  ASSERT_TRUE(WriteManifestStream(manifest_proto_, stream));
+
+  std::unique_ptr<ManifestStreamReader> reader =
+      ManifestStreamReader::Create(stream);
+  ASSERT_NE(reader, nullptr);
+  EXPECT_EQ(reader->particle_specs().particle_specs_size(), 1);
+  EXPECT_EQ(reader->particle_specs().particle_specs(0).name(), "Relay");
+  EXPECT_EQ(reader->particle_specs().recipes_size(), 0);
+
+  arcs::ManifestProto read_manifest_proto = reader->particle_specs();
+  arcs::RecipeProto recipe_proto;
+  while (reader->ReadRecipe(recipe_proto)) {
+    *read_manifest_proto.add_recipes() = recipe_proto;
+  }
+  EXPECT_FALSE(reader->failed());
+  EXPECT_EQ(reader->num_recipes(), 2);
+  EXPECT_EQ(read_manifest_proto.SerializeAsString(),
+            manifest_proto_.SerializeAsString());
+}
+
+TEST_F(ManifestStreamTest, FailsOnATruncatedRecipe) {
+  std::stringstream stream;
+  ASSERT_TRUE(WriteManifestStream(manifest_proto_, stream));
+  std::string contents = stream.str();
+  std::stringstream truncated_stream(contents.substr(0, contents.size() - 1));
+
+  std::unique_ptr<ManifestStreamReader> reader =
+      ManifestStreamReader::Create(truncated_stream);
+  ASSERT_NE(reader, nullptr);
+  arcs::RecipeProto recipe_proto;
+  EXPECT_TRUE(reader->ReadRecipe(recipe_proto));
+  EXPECT_FALSE(reader->ReadRecipe(recipe_proto));
+  EXPECT_TRUE(reader->failed());
+  EXPECT_FALSE(reader->ReadRecipe(recipe_proto));
+}
+
+TEST_F(ManifestStreamTest, RejectsAMissingOrMalformedHeader) {
+  std::stringstream empty_stream;
+  EXPECT_EQ(ManifestStreamReader::Create(empty_stream), nullptr);
+
+  // A whole manifest proto is not a manifest stream.
+  std::stringstream manifest_stream;
+  google::protobuf::util::SerializeDelimitedToOstream(manifest_proto_,
+                                                      &manifest_stream);
+  EXPECT_EQ(ManifestStreamReader::Create(manifest_stream), nullptr);
+}
+
+}  // namespace raksha::ir::proto
@@ -16,6 +16,8 @@
 
 #include "src/ir/proto/particle_spec.h"
 
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
 #include "src/ir/particle_spec.h"
 #include "src/ir/proto/handle_connection_spec.h"
 #include "src/ir/proto/derives_from_claim.h"
@@ -25,8 +27,229 @@
 
 namespace raksha::ir::proto {
 
+namespace {
+
+// The FindDecodeError functions below mirror the CHECKs of the Decode
+// functions of the same protos.
+
+std::optional<std::string> FindDecodeError(const arcs::TypeProto &type_proto) {
+  if (type_proto.optional()) {
+    return "Optional types are currently unimplemented.";
+  }
+  if (type_proto.has_refinement()) {
+    return "Type refinements are currently unimplemented.";
+  }
+  switch (type_proto.data_case()) {
+    case arcs::TypeProto::kPrimitive:
+      return std::nullopt;
+    case arcs::TypeProto::kEntity: {
+      if (!type_proto.entity().has_schema()) {
+        return "Schema is required for Entity types.";
+      }
+      const arcs::SchemaProto &schema = type_proto.entity().schema();
+      if (schema.names().size() > 1) {
+        return "Multiple names for a Schema not yet supported.";
+      }
+      for (const auto &[field_name, field_type] : schema.fields()) {
+        if (std::optional<std::string> error = FindDecodeError(field_type)) {
+          return error;
+        }
+      }
+      return std::nullopt;
+    }
+    case arcs::TypeProto::DATA_NOT_SET:
+      return "Found a TypeProto with an unset specific type.";
+    default:
+      return "Found unimplemented type. Only Primitive and Entity types are "
+             "currently implemented.";
+  }
+}
+
+std::optional<std::string> FindDecodeError(
+    const arcs::HandleConnectionSpecProto &proto) {
+  if (proto.name().empty()) {
+    return "Found connection spec without required name.";
+  }
+  switch (proto.direction()) {
+    case arcs::HandleConnectionSpecProto_Direction_READS:
+    case arcs::HandleConnectionSpecProto_Direction_WRITES:
+    case arcs::HandleConnectionSpecProto_Direction_READS_WRITES:
+      break;
+    default:
+      return absl::StrCat("Connection spec ", proto.name(),
+                          " has unspecified or unimplemented direction.");
+  }
+  if (!proto.has_type()) {
+    return absl::StrCat("Found connection spec ", proto.name(),
+                        " without required type.");
+  }
+  return FindDecodeError(proto.type());
+}
+
+std::optional<std::string> FindDecodeError(
+    const arcs::AccessPathProto &access_path_proto) {
+  if (access_path_proto.has_store_id()) {
+    return "Currently, access paths involving stores are not implemented.";
+  }
+  if (!access_path_proto.has_handle()) {
+    return "Expected AccessPathProto to contain a handle member.";
+  }
+  if (access_path_proto.handle().particle_spec().empty()) {
+    return "Expected a HandleRoot message to have a non-empty particle_spec.";
+  }
+  if (access_path_proto.handle().handle_connection().empty()) {
+    return "Expected a HandleRoot message to have a non-empty "
+           "handle_connection.";
+  }
+  for (const arcs::AccessPathProto_Selector &selector :
+       access_path_proto.selectors()) {
+    if (!selector.has_field()) {
+      return "Found a Selector with an unimplemented specific type.";
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<std::string> FindDecodeError(
+    const arcs::InformationFlowLabelProto_Predicate &predicate_proto) {
+  switch (predicate_proto.predicate_case()) {
+    case arcs::InformationFlowLabelProto_Predicate::kLabel:
+      if (!predicate_proto.label().has_semantic_tag()) {
+        return "Found a label without required field tag.";
+      }
+      return std::nullopt;
+    case arcs::InformationFlowLabelProto_Predicate::kAnd: {
+      const auto &and_predicate = predicate_proto.and_();
+      if (!and_predicate.has_conjunct0() || !and_predicate.has_conjunct1()) {
+        return "Found an `And` predicate without both conjuncts.";
+      }
+      if (std::optional<std::string> error =
+              FindDecodeError(and_predicate.conjunct0())) {
+        return error;
+      }
+      return FindDecodeError(and_predicate.conjunct1());
+    }
+    case arcs::InformationFlowLabelProto_Predicate::kImplies: {
+      const auto &implies_predicate = predicate_proto.implies();
+      if (!implies_predicate.has_antecedent() ||
+          !implies_predicate.has_consequent()) {
+        return "Found an `Implies` predicate without both antecedent and "
+               "consequent.";
+      }
+      if (std::optional<std::string> error =
+              FindDecodeError(implies_predicate.antecedent())) {
+        return error;
+      }
+      return FindDecodeError(implies_predicate.consequent());
+    }
+    case arcs::InformationFlowLabelProto_Predicate::kNot:
+      if (!predicate_proto.not_().has_predicate()) {
+        return "Found a `Not` predicate without required field predicate.";
+      }
+      return FindDecodeError(predicate_proto.not_().predicate());
+    case arcs::InformationFlowLabelProto_Predicate::kOr: {
+      const auto &or_predicate = predicate_proto.or_();
+      if (!or_predicate.has_disjunct0() || !or_predicate.has_disjunct1()) {
+        return "Found an `Or` predicate without both disjuncts.";
+      }
+      if (std::optional<std::string> error =
+              FindDecodeError(or_predicate.disjunct0())) {
+        return error;
+      }
+      return FindDecodeError(or_predicate.disjunct1());
+    }
+    default:
+      return "Unexpected predicate kind.";
+  }
+}
+
+// The predicates of Assume claims are conjunctions of possibly negated
+// labels.
+std::optional<std::string> FindAssumeDecodeError(
+    const arcs::InformationFlowLabelProto_Predicate &predicate,
+    bool in_negation) {
+  switch (predicate.predicate_case()) {
+    case arcs::InformationFlowLabelProto_Predicate::kLabel:
+      if (!predicate.label().has_semantic_tag()) {
+        return "semantic_tag field required on InformationFlowLabelProto.";
+      }
+      return std::nullopt;
+    case arcs::InformationFlowLabelProto_Predicate::kNot:
+      if (in_negation) return "Double negation not allowed in Assume claim.";
+      if (!predicate.not_().has_predicate()) {
+        return "Inner predicate is required in Not predicate in Assume.";
+      }
+      return FindAssumeDecodeError(predicate.not_().predicate(),
+                                   /*in_negation=*/true);
+    case arcs::InformationFlowLabelProto_Predicate::kAnd: {
+      if (in_negation) return "Negated Ands not allowed in Assume claim.";
+      const auto &and_predicate = predicate.and_();
+      if (!and_predicate.has_conjunct0() || !and_predicate.has_conjunct1()) {
+        return "And predicate missing required conjunct field.";
+      }
+      if (std::optional<std::string> error = FindAssumeDecodeError(
+              and_predicate.conjunct0(), /*in_negation=*/false)) {
+        return error;
+      }
+      return FindAssumeDecodeError(and_predicate.conjunct1(),
+                                   /*in_negation=*/false);
+    }
+    default:
+      return "Found unexpected predicate kind in Assume claim proto.";
+  }
+}
+
+std::optional<std::string> FindDecodeError(const arcs::ClaimProto &claim) {
+  switch (claim.claim_case()) {
+    case arcs::ClaimProto::kDerivesFrom: {
+      const arcs::ClaimProto_DerivesFrom &derives_from = claim.derives_from();
+      if (!derives_from.has_source() || !derives_from.has_target()) {
+        return "DerivesFrom proto does not have both source and target.";
+      }
+      if (std::optional<std::string> error =
+              FindDecodeError(derives_from.source())) {
+        return error;
+      }
+      return FindDecodeError(derives_from.target());
+    }
+    case arcs::ClaimProto::kAssume: {
+      const arcs::ClaimProto_Assume &assume = claim.assume();
+      if (!assume.has_access_path()) {
+        return "Expected Assume message to have access_path field.";
+      }
+      if (std::optional<std::string> error =
+              FindDecodeError(assume.access_path())) {
+        return error;
+      }
+      if (!assume.has_predicate()) {
+        return "Expected Assume message to have predicate field.";
+      }
+      return FindAssumeDecodeError(assume.predicate(), /*in_negation=*/false);
+    }
+    default:
+      return "Unexpected claim variant.";
+  }
+}
+
+std::optional<std::string> FindDecodeError(const arcs::CheckProto &check) {
+  if (!check.has_access_path()) {
+    return "`Check` proto missing required field access_path!";
+  }
+  if (std::optional<std::string> error =
+          FindDecodeError(check.access_path())) {
+    return error;
+  }
+  if (!check.has_predicate()) {
+    return "`Check` proto missing required field predicate!";
+  }
+  return FindDecodeError(check.predicate());
+}
+
+}  // namespace
+
 std::unique_ptr<ParticleSpec> Decode(
-    const arcs::ParticleSpecProto &particle_spec_proto) {
+    const arcs::ParticleSpecProto &particle_spec_proto,
+    ParticleSpec::DefaultDerivationMode default_derivation_mode) {
   std::string name = particle_spec_proto.name();
   CHECK(!name.empty()) << "Expected particle spec to have a name.";
 
@@ -69,7 +292,36 @@ std::unique_ptr<ParticleSpec> Decode(
 
   return ParticleSpec::Create(
       std::move(name), std::move(checks), std::move(tag_claims),
-      std::move(derives_from_claims), std::move(handle_connection_specs));
+      std::move(derives_from_claims), std::move(handle_connection_specs),
+      default_derivation_mode);
+}
+
+std::optional<std::string> FindDecodeError(
+    const arcs::ParticleSpecProto &particle_spec_proto) {
+  if (particle_spec_proto.name().empty()) {
+    return "Expected particle spec to have a name.";
+  }
+  absl::flat_hash_set<std::string> connection_names;
+  for (const arcs::HandleConnectionSpecProto &hcs_proto :
+       particle_spec_proto.connections()) {
+    if (std::optional<std::string> error = FindDecodeError(hcs_proto)) {
+      return error;
+    }
+    if (!connection_names.insert(hcs_proto.name()).second) {
+      return "Found two HandleConnectionSpecs with same name.";
+    }
+  }
+  for (const arcs::ClaimProto &claim : particle_spec_proto.claims()) {
+    if (std::optional<std::string> error = FindDecodeError(claim)) {
+      return error;
+    }
+  }
+  for (const arcs::CheckProto &check : particle_spec_proto.checks()) {
+    if (std::optional<std::string> error = FindDecodeError(check)) {
+      return error;
+    }
+  }
+  return std::nullopt;
 }
 
 }  // namespace raksha::ir::proto
@@ -18,13 +18,24 @@
 #define SRC_IR_PROTO_PARTICLE_SPEC_H_
 
 #include <memory>
+#include <optional>
+#include <string>
 
 #include "src/ir/particle_spec.h"
 #include "third_party/arcs/proto/manifest.pb.h"
 
 namespace raksha::ir::proto {
 
-std::unique_ptr<ParticleSpec> Decode(const arcs::ParticleSpecProto &proto);
+std::unique_ptr<ParticleSpec> Decode(
+    const arcs::ParticleSpecProto &proto,
+    ParticleSpec::DefaultDerivationMode default_derivation_mode =
+        ParticleSpec::DefaultDerivationMode::kCartesian);
+
+// Returns why Decode would fail on `proto`, or std::nullopt if it would
+// succeed. Decode CHECK-fails on malformed protos, so services that take
+// specs from outside call this first.
+std::optional<std::string> FindDecodeError(
+    const arcs::ParticleSpecProto &proto);
 
 }  // namespace raksha::ir::proto
 
@@ -21,7 +21,10 @@
 
 namespace raksha::ir::proto {
 
-std::unique_ptr<SystemSpec> Decode(const arcs::ManifestProto &manifest_proto);
+std::unique_ptr<SystemSpec> Decode(
+    const arcs::ManifestProto &manifest_proto,
+    ParticleSpec::DefaultDerivationMode default_derivation_mode =
+        ParticleSpec::DefaultDerivationMode::kCartesian);
 
 }  // namespace raksha::ir::proto
 
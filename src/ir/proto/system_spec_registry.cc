@@ -0,0 +1,105 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/ir/proto/system_spec_registry.h"
+
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/particle_spec.h"
+
+namespace raksha::ir::proto {
+
+namespace {
+
+// Specs are compared by their serialization. This must be deterministic, as
+// the order in which the fields of schemas, which are maps, are serialized
+// otherwise differs between copies of the same proto.
+std::string SerializeDeterministically(
+    const arcs::ParticleSpecProto &particle_spec_proto) {
+  std::string serialized;
+  {
+    google::protobuf::io::StringOutputStream string_stream(&serialized);
+    google::protobuf::io::CodedOutputStream coded_stream(&string_stream);
+    coded_stream.SetSerializationDeterministic(true);
+    particle_spec_proto.SerializeToCodedStream(&coded_stream);
+  }
+  return serialized;
+}
+
+}  // namespace
+
+SystemSpecRegistry::SystemSpecRegistry(
+    ParticleSpec::DefaultDerivationMode default_derivation_mode)
+    : default_derivation_mode_(default_derivation_mode),
+      current_(std::make_shared<const SystemSpecSnapshot>(0, SystemSpec())) {}
+
+std::optional<SystemSpecReloadStats> SystemSpecRegistry::Reload(
+    const arcs::ManifestProto &manifest_proto) {
+  std::lock_guard<std::mutex> lock(reload_mutex_);
+  SystemSpecReloadStats stats;
+  absl::flat_hash_map<std::string, DecodedParticleSpec> decoded_particle_specs;
+  for (const arcs::ParticleSpecProto &particle_spec_proto :
+       manifest_proto.particle_specs()) {
+    DecodedParticleSpec decoded{
+        .serialized_proto = SerializeDeterministically(particle_spec_proto),
+        .particle_spec = nullptr};
+    auto find_result =
+        decoded_particle_specs_.find(particle_spec_proto.name());
+    if (find_result != decoded_particle_specs_.end() &&
+        find_result->second.serialized_proto == decoded.serialized_proto) {
+      decoded.particle_spec = find_result->second.particle_spec;
+      ++stats.num_reused;
+    } else {
+      if (std::optional<std::string> error =
+              FindDecodeError(particle_spec_proto)) {
+        LOG(ERROR) << "Malformed particle spec "
+                   << particle_spec_proto.name() << ": " << *error
+                   << " Keeping version " << Current()->version() << ".";
+        return std::nullopt;
+      }
+      decoded.particle_spec =
+          Decode(particle_spec_proto, default_derivation_mode_);
+      ++stats.num_decoded;
+    }
+    if (!decoded_particle_specs
+             .insert({particle_spec_proto.name(), std::move(decoded)})
+             .second) {
+      LOG(ERROR) << "Found two particle specs with name "
+                 << particle_spec_proto.name() << "; keeping version "
+                 << Current()->version() << ".";
+      return std::nullopt;
+    }
+  }
+  for (const auto &[name, decoded] : decoded_particle_specs_) {
+    if (!decoded_particle_specs.contains(name)) ++stats.num_removed;
+  }
+
+  SystemSpec system_spec;
+  for (const auto &[name, decoded] : decoded_particle_specs) {
+    system_spec.AddSharedParticleSpec(decoded.particle_spec);
+  }
+  stats.version = Current()->version() + 1;
+  std::atomic_store(&current_,
+                    std::shared_ptr<const SystemSpecSnapshot>(
+                        std::make_shared<const SystemSpecSnapshot>(
+                            stats.version, std::move(system_spec))));
+  decoded_particle_specs_ = std::move(decoded_particle_specs);
+  return stats;
+}
+
+}  // namespace raksha::ir::proto
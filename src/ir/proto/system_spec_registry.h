@@ -0,0 +1,108 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+#ifndef SRC_IR_PROTO_SYSTEM_SPEC_REGISTRY_H_
+#define SRC_IR_PROTO_SYSTEM_SPEC_REGISTRY_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "src/ir/particle_spec.h"
+#include "src/ir/system_spec.h"
+#include "third_party/arcs/proto/manifest.pb.h"
+
+namespace raksha::ir::proto {
+
+// An immutable version of the particle specs of a SystemSpecRegistry.
+class SystemSpecSnapshot {
+ public:
+  SystemSpecSnapshot(uint64_t version, SystemSpec system_spec)
+      : version_(version), system_spec_(std::move(system_spec)) {}
+
+  // Versions start at 0, for the empty snapshot of a new registry, and
+  // increase by one with each successful reload.
+  uint64_t version() const { return version_; }
+  const SystemSpec &system_spec() const { return system_spec_; }
+
+ private:
+  uint64_t version_;
+  SystemSpec system_spec_;
+};
+
+// What a reload of a SystemSpecRegistry did.
+struct SystemSpecReloadStats {
+  // The version of the snapshot the reload published.
+  uint64_t version = 0;
+  // The ParticleSpecs taken over from the previous snapshot because their
+  // protos did not change.
+  uint64_t num_reused = 0;
+  // The ParticleSpecs that were added or changed and thus decoded.
+  uint64_t num_decoded = 0;
+  // The ParticleSpecs of the previous snapshot that are no longer present.
+  uint64_t num_removed = 0;
+};
+
+// Holds the current particle specs of a long-running service whose catalog
+// of specs changes while manifests are checked against it. Readers pin the
+// current snapshot with Current, which takes no lock of the registry, and
+// may keep using it after reloads. A reload decodes only the specs whose
+// protos changed, sharing the others, along with their edges, with the
+// previous snapshot, and then publishes the new snapshot at once.
+class SystemSpecRegistry {
+ public:
+  explicit SystemSpecRegistry(ParticleSpec::DefaultDerivationMode
+                                  default_derivation_mode =
+                                      ParticleSpec::DefaultDerivationMode::
+                                          kCartesian);
+
+  SystemSpecRegistry(const SystemSpecRegistry &) = delete;
+  SystemSpecRegistry &operator=(const SystemSpecRegistry &) = delete;
+
+  // Returns the current snapshot. May be called from any thread.
+  std::shared_ptr<const SystemSpecSnapshot> Current() const {
+    return std::atomic_load(&current_);
+  }
+
+  // Replaces the particle specs with those of `manifest_proto`. Returns
+  // std::nullopt, keeping the current snapshot, if the manifest has two
+  // particle specs with the same name or a particle spec that Decode
+  // rejects. Reloads from several threads are applied one at a time.
+  std::optional<SystemSpecReloadStats> Reload(
+      const arcs::ManifestProto &manifest_proto);
+
+ private:
+  // A decoded ParticleSpec and the serialized proto it was decoded from.
+  struct DecodedParticleSpec {
+    std::string serialized_proto;
+    std::shared_ptr<const ParticleSpec> particle_spec;
+  };
+
+  ParticleSpec::DefaultDerivationMode default_derivation_mode_;
+  // Only accessed with std::atomic_load and std::atomic_store.
+  std::shared_ptr<const SystemSpecSnapshot> current_;
+  // Serializes reloads and guards decoded_particle_specs_.
+  std::mutex reload_mutex_;
+  // The ParticleSpecs of the current snapshot, by name.
+  absl::flat_hash_map<std::string, DecodedParticleSpec>
+      decoded_particle_specs_;
+};
+
+}  // namespace raksha::ir::proto
+
+#endif  // SRC_IR_PROTO_SYSTEM_SPEC_REGISTRY_H_
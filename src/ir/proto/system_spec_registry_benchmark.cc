@@ -0,0 +1,150 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Benchmarks of SystemSpecRegistry on synthetic manifests. BM_Reload times
+// a reload in which one of the particle specs changed, against
+// BM_DecodeSystemSpec, which decodes all of them as a service without the
+// registry would. BM_GetParticleSpec times the lookups of reader threads,
+// with and without a thread reloading the registry as fast as it can.
+//
+// Example:
+//   bazel run -c opt //src/ir/proto:system_spec_registry_benchmark --
+//     --benchmark_filter=GetParticleSpec
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/ir/proto/system_spec_registry.h"
+#include "src/test_utils/synthetic_manifest/synthetic_manifest.h"
+
+namespace raksha::ir::proto {
+namespace {
+
+using test_utils::SyntheticManifestOptions;
+
+// The number of particle specs of the manifests of BM_GetParticleSpec.
+constexpr uint64_t kReadParticleSpecs = 100;
+
+arcs::ManifestProto GetManifest(uint64_t num_particle_specs) {
+  return test_utils::GenerateSyntheticManifest(SyntheticManifestOptions{
+      .particles_per_recipe = num_particle_specs,
+      .connections_per_particle = 4,
+      .schema_depth = 1,
+      .schema_width = 4,
+      .checks_per_particle = 1,
+      .claims_per_particle = 1});
+}
+
+// Returns `manifest` with another connection on its first particle spec.
+arcs::ManifestProto ChangeFirstParticleSpec(arcs::ManifestProto manifest) {
+  arcs::HandleConnectionSpecProto *connection =
+      manifest.mutable_particle_specs(0)->add_connections();
+  connection->set_name("changed");
+  connection->set_direction(arcs::HandleConnectionSpecProto::READS);
+  connection->mutable_type()->set_primitive(arcs::TEXT);
+  return manifest;
+}
+
+void BM_DecodeSystemSpec(benchmark::State &state) {
+  arcs::ManifestProto manifest = GetManifest(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Decode(manifest));
+  }
+  state.counters["particle_specs"] = state.range(0);
+}
+
+void BM_Reload(benchmark::State &state) {
+  arcs::ManifestProto manifests[] = {
+      GetManifest(state.range(0)),
+      ChangeFirstParticleSpec(GetManifest(state.range(0)))};
+  SystemSpecRegistry registry;
+  CHECK(registry.Reload(manifests[1]).has_value());
+  uint64_t num_reloads = 0;
+  for (auto _ : state) {
+    CHECK(registry.Reload(manifests[num_reloads++ % 2]).has_value());
+  }
+  state.counters["particle_specs"] = state.range(0);
+}
+
+// The registry of BM_GetParticleSpec, which the reader threads share, and
+// the thread reloading it.
+SystemSpecRegistry *read_registry = nullptr;
+std::vector<std::string> read_particle_spec_names;
+std::atomic<bool> stop_reloading = false;
+std::atomic<uint64_t> num_background_reloads = 0;
+std::thread reloader;
+
+// Looks up the particle specs of the current snapshot in turn, pinning a
+// snapshot per lookup. With state.range(0) set, another thread reloads the
+// registry, changing one particle spec every time, throughout the run.
+void BM_GetParticleSpec(benchmark::State &state) {
+  if (state.thread_index() == 0) {
+    arcs::ManifestProto manifest = GetManifest(kReadParticleSpecs);
+    read_registry = new SystemSpecRegistry();
+    CHECK(read_registry->Reload(manifest).has_value());
+    read_particle_spec_names.clear();
+    for (const arcs::ParticleSpecProto &spec : manifest.particle_specs()) {
+      read_particle_spec_names.push_back(spec.name());
+    }
+    stop_reloading = false;
+    num_background_reloads = 0;
+    if (state.range(0) != 0) {
+      reloader = std::thread([manifest]() {
+        arcs::ManifestProto manifests[] = {manifest,
+                                           ChangeFirstParticleSpec(manifest)};
+        while (!stop_reloading) {
+          CHECK(read_registry->Reload(manifests[++num_background_reloads % 2])
+                    .has_value());
+        }
+      });
+    }
+  }
+  size_t next = state.thread_index();
+  for (auto _ : state) {
+    std::shared_ptr<const SystemSpecSnapshot> snapshot =
+        read_registry->Current();
+    const ParticleSpec *particle_spec = snapshot->system_spec().GetParticleSpec(
+        read_particle_spec_names[next++ % read_particle_spec_names.size()]);
+    CHECK(particle_spec != nullptr);
+    benchmark::DoNotOptimize(particle_spec->edges().size());
+  }
+  if (state.thread_index() == 0) {
+    stop_reloading = true;
+    if (reloader.joinable()) reloader.join();
+    state.counters["reloads"] = num_background_reloads.load();
+    delete read_registry;
+    read_registry = nullptr;
+  }
+}
+
+BENCHMARK(BM_DecodeSystemSpec)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_Reload)->RangeMultiplier(10)->Range(10, 10000);
+BENCHMARK(BM_GetParticleSpec)
+    ->ArgName("reloading")
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace raksha::ir::proto
+
+BENCHMARK_MAIN();
@@ -0,0 +1,199 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+#include "src/ir/proto/system_spec_registry.h"
+
+#include <google/protobuf/text_format.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "src/common/logging/logging.h"
+#include "src/common/testing/gtest.h"
+
+namespace raksha::ir::proto {
+
+static arcs::ManifestProto ParseManifest(const std::string &textproto) {
+  arcs::ManifestProto manifest_proto;
+  CHECK(google::protobuf::TextFormat::ParseFromString(textproto,
+                                                      &manifest_proto))
+      << "Manifest textproto did not parse correctly.";
+  return manifest_proto;
+}
+
+static const char kPS1[] = R"(
+particle_specs: [{
+  name: "PS1"
+  connections: [
+    { name: "in" direction: READS type: { primitive: TEXT } },
+    { name: "out" direction: WRITES type: { primitive: TEXT } } ] }])";
+
+static const char kPS2[] = R"(
+particle_specs: [{
+  name: "PS2"
+  connections: [
+    { name: "in" direction: READS type: { primitive: TEXT } } ] }])";
+
+// PS2 with another connection.
+static const char kPS2Changed[] = R"(
+particle_specs: [{
+  name: "PS2"
+  connections: [
+    { name: "in" direction: READS type: { primitive: TEXT } },
+    { name: "out" direction: WRITES type: { primitive: TEXT } } ] }])";
+
+TEST(SystemSpecRegistryTest, StartsEmpty) {
+  SystemSpecRegistry registry;
+  std::shared_ptr<const SystemSpecSnapshot> snapshot = registry.Current();
+  EXPECT_EQ(snapshot->version(), 0);
+  EXPECT_EQ(snapshot->system_spec().GetParticleSpec("PS1"), nullptr);
+}
+
+TEST(SystemSpecRegistryTest, ReloadReusesUnchangedParticleSpecs) {
+  SystemSpecRegistry registry;
+  std::optional<SystemSpecReloadStats> first_stats =
+      registry.Reload(ParseManifest(absl::StrCat(kPS1, kPS2)));
+  ASSERT_TRUE(first_stats.has_value());
+  EXPECT_EQ(first_stats->version, 1);
+  EXPECT_EQ(first_stats->num_decoded, 2);
+  std::shared_ptr<const SystemSpecSnapshot> first = registry.Current();
+
+  std::optional<SystemSpecReloadStats> second_stats =
+      registry.Reload(ParseManifest(absl::StrCat(kPS1, kPS2Changed)));
+  ASSERT_TRUE(second_stats.has_value());
+  EXPECT_EQ(second_stats->version, 2);
+  EXPECT_EQ(second_stats->num_reused, 1);
+  EXPECT_EQ(second_stats->num_decoded, 1);
+  EXPECT_EQ(second_stats->num_removed, 0);
+  std::shared_ptr<const SystemSpecSnapshot> second = registry.Current();
+
+  EXPECT_EQ(second->system_spec().GetParticleSpec("PS1"),
+            first->system_spec().GetParticleSpec("PS1"));
+  EXPECT_NE(second->system_spec().GetParticleSpec("PS2"),
+            first->system_spec().GetParticleSpec("PS2"));
+  // The pinned first snapshot still holds the old PS2.
+  EXPECT_EQ(first->system_spec().GetParticleSpec("PS2")->edges().size(), 0);
+  EXPECT_EQ(second->system_spec().GetParticleSpec("PS2")->edges().size(), 1);
+}
+
+TEST(SystemSpecRegistryTest, ReloadReusesParticleSpecsWithMapFields) {
+  // The fields of a schema are a map, whose order may differ between copies.
+  arcs::ManifestProto manifest_proto = ParseManifest(R"(
+particle_specs: [{
+  name: "PS1"
+  connections: [
+    { name: "in" direction: READS
+      type: { entity: { schema: { fields: [
+        { key: "field1", value: { primitive: TEXT } },
+        { key: "field2", value: { primitive: TEXT } },
+        { key: "field3", value: { primitive: TEXT } },
+        { key: "field4", value: { primitive: TEXT } } ] } } } } ] }])");
+  SystemSpecRegistry registry;
+  ASSERT_TRUE(registry.Reload(manifest_proto));
+  for (int i = 0; i < 10; ++i) {
+    arcs::ManifestProto copy = manifest_proto;
+    std::optional<SystemSpecReloadStats> stats = registry.Reload(copy);
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_EQ(stats->num_reused, 1);
+  }
+}
+
+TEST(SystemSpecRegistryTest, ReloadRemovesMissingParticleSpecs) {
+  SystemSpecRegistry registry;
+  ASSERT_TRUE(registry.Reload(ParseManifest(absl::StrCat(kPS1, kPS2))));
+  std::optional<SystemSpecReloadStats> stats =
+      registry.Reload(ParseManifest(kPS2));
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->num_reused, 1);
+  EXPECT_EQ(stats->num_removed, 1);
+  EXPECT_EQ(registry.Current()->system_spec().GetParticleSpec("PS1"),
+            nullptr);
+  EXPECT_NE(registry.Current()->system_spec().GetParticleSpec("PS2"),
+            nullptr);
+}
+
+TEST(SystemSpecRegistryTest, ReloadKeepsSnapshotOnDuplicateNames) {
+  SystemSpecRegistry registry;
+  ASSERT_TRUE(registry.Reload(ParseManifest(kPS1)));
+  EXPECT_EQ(registry.Reload(ParseManifest(absl::StrCat(kPS2, kPS2Changed))),
+            std::nullopt);
+  EXPECT_EQ(registry.Current()->version(), 1);
+  EXPECT_NE(registry.Current()->system_spec().GetParticleSpec("PS1"),
+            nullptr);
+  // The failed reload does not affect what the next one reuses.
+  std::optional<SystemSpecReloadStats> stats =
+      registry.Reload(ParseManifest(kPS1));
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->version, 2);
+  EXPECT_EQ(stats->num_reused, 1);
+}
+
+TEST(SystemSpecRegistryTest, ReloadKeepsSnapshotOnMalformedParticleSpec) {
+  SystemSpecRegistry registry;
+  ASSERT_TRUE(registry.Reload(ParseManifest(absl::StrCat(kPS1, kPS2))));
+  // A connection without a direction, which Decode CHECK-fails on.
+  EXPECT_EQ(registry.Reload(ParseManifest(absl::StrCat(kPS1, R"(
+particle_specs: [{
+  name: "PS2"
+  connections: [ { name: "in" type: { primitive: TEXT } } ] }])"))),
+            std::nullopt);
+  EXPECT_EQ(registry.Current()->version(), 1);
+  EXPECT_TRUE(registry.Current()
+                  ->system_spec()
+                  .GetParticleSpec("PS2")
+                  ->getHandleConnectionSpec("in")
+                  .reads());
+  std::optional<SystemSpecReloadStats> stats =
+      registry.Reload(ParseManifest(absl::StrCat(kPS1, kPS2)));
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->version, 2);
+  EXPECT_EQ(stats->num_reused, 2);
+}
+
+TEST(SystemSpecRegistryTest, ReadersSeeWholeSnapshotsDuringReloads) {
+  SystemSpecRegistry registry;
+  arcs::ManifestProto original = ParseManifest(absl::StrCat(kPS1, kPS2));
+  arcs::ManifestProto changed = ParseManifest(absl::StrCat(kPS1, kPS2Changed));
+  ASSERT_TRUE(registry.Reload(original));
+  std::atomic<bool> done = false;
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&registry, &done]() {
+      uint64_t last_version = 0;
+      while (!done) {
+        std::shared_ptr<const SystemSpecSnapshot> snapshot =
+            registry.Current();
+        EXPECT_GE(snapshot->version(), last_version);
+        last_version = snapshot->version();
+        // Odd versions hold the original PS2 and even ones the changed PS2.
+        const ParticleSpec *ps2 =
+            snapshot->system_spec().GetParticleSpec("PS2");
+        ASSERT_NE(ps2, nullptr);
+        EXPECT_EQ(ps2->edges().size(), 1 - (snapshot->version() % 2));
+        EXPECT_NE(snapshot->system_spec().GetParticleSpec("PS1"), nullptr);
+      }
+    });
+  }
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_TRUE(registry.Reload((i % 2 == 0) ? changed : original));
+  }
+  done = true;
+  for (std::thread &reader : readers) reader.join();
+  EXPECT_EQ(registry.Current()->version(), 101);
+}
+
+}  // namespace raksha::ir::proto
@@ -8,7 +8,7 @@
 
 namespace raksha::ir::proto {
 
-TagCheck Decode(const arcs::CheckProto &check_proto) {
+inline TagCheck Decode(const arcs::CheckProto &check_proto) {
   CHECK(check_proto.has_access_path())
     << "`Check` proto missing required field access_path!";
   AccessPath access_path = Decode(check_proto.access_path());
@@ -16,6 +16,8 @@
 #ifndef SRC_IR_SYSTEM_SPEC_H_
 #define SRC_IR_SYSTEM_SPEC_H_
 
+#include <memory>
+
 #include "src/ir/particle_spec.h"
 
 namespace raksha::ir {
@@ -25,6 +27,13 @@ class SystemSpec {
  public:
   const ParticleSpec *AddParticleSpec(
       std::unique_ptr<ParticleSpec> particle_spec) {
+    return AddSharedParticleSpec(std::move(particle_spec));
+  }
+
+  // Adds a ParticleSpec that may also be part of other SystemSpecs, such as
+  // the snapshots of a SystemSpecRegistry that share unchanged specs.
+  const ParticleSpec *AddSharedParticleSpec(
+      std::shared_ptr<const ParticleSpec> particle_spec) {
     auto ins_res = particle_specs_.insert(
         {particle_spec->name(), std::move(particle_spec)});
     CHECK(ins_res.second) << "Tried to insert second particle spec with name "
@@ -43,7 +52,7 @@ class SystemSpec {
 
  private:
   // The particles in the system spec.
-  absl::flat_hash_map<std::string, std::unique_ptr<ParticleSpec>>
+  absl::flat_hash_map<std::string, std::shared_ptr<const ParticleSpec>>
       particle_specs_;
 };
 
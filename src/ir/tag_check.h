@@ -41,13 +41,23 @@ class TagCheck {
   // elements of isCheck and check are equal. If that is the case, all checks
   // passed. If it is not, at least one check failed.
   std::string ToDatalog(DatalogPrintContext &ctxt) const {
+    std::string check_label = ctxt.GetUniqueCheckLabel();
+    std::string access_path = access_path_.ToDatalog(ctxt);
+    return ToDatalog(check_label, access_path,
+                     predicate_->ToDatalogRuleBody(access_path_, ctxt));
+  }
+
+  // Print a check as Datalog from its label and its already printed access
+  // path and predicate. This is used when checks are stored in printed form,
+  // such as in a PolicyBundle.
+  static std::string ToDatalog(absl::string_view check_label,
+                               absl::string_view access_path,
+                               absl::string_view rule_body) {
     constexpr absl::string_view kCheckHasTagFormat =
         R"(isCheck("$0", "$1"). check("$0", owner, "$1") :-
   ownsAccessPath(owner, "$1"), $2.)";
-    std::string check_label = ctxt.GetUniqueCheckLabel();
-    return absl::Substitute(kCheckHasTagFormat, check_label,
-                            access_path_.ToDatalog(ctxt),
-                            predicate_->ToDatalogRuleBody(access_path_, ctxt));
+    return absl::Substitute(kCheckHasTagFormat, check_label, access_path,
+                            rule_body);
   }
 
   bool operator==(const TagCheck &other) const {
@@ -59,7 +69,15 @@ class TagCheck {
          (*predicate_ == *other.predicate_));
   }
 
+  // Predicates have no hash, so checks that differ only in their predicates
+  // hash alike but still compare unequal.
+  template<typename H>
+  friend H AbslHashValue(H h, const TagCheck &tag_check) {
+    return H::combine(std::move(h), tag_check.access_path_);
+  }
+
   const AccessPath& access_path() const { return access_path_; }
+  const Predicate& predicate() const { return *predicate_; }
 
  private:
   // The access path which is the subject of the check.
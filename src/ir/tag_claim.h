@@ -42,13 +42,23 @@ class TagClaim {
 
   // Produce a string containing a datalog fact for this TagClaim.
   std::string ToDatalog(DatalogPrintContext &ctxt) const {
+    return ToDatalog(claim_tag_is_present_, claiming_particle_name_,
+                     access_path_.ToDatalog(ctxt), tag_);
+  }
+
+  // Print a claim as a Datalog fact from its already printed parts. This is
+  // used when claims are stored in printed form, such as in a PolicyBundle.
+  static std::string ToDatalog(bool claim_tag_is_present,
+                               absl::string_view claiming_particle_name,
+                               absl::string_view access_path,
+                               absl::string_view tag) {
     constexpr absl::string_view kClaimTagFormat =
         R"(%s("%s", "%s", owner, "%s") :- ownsAccessPath(owner, "%s").)";
     absl::string_view relation_name =
-        (claim_tag_is_present_) ? "says_hasTag" : "says_removeTag";
-    return absl::StrFormat(
-        kClaimTagFormat, relation_name, claiming_particle_name_,
-        access_path_.ToDatalog(ctxt), tag_, access_path_.ToDatalog(ctxt));
+        (claim_tag_is_present) ? "says_hasTag" : "says_removeTag";
+    return absl::StrFormat(kClaimTagFormat, relation_name,
+                           claiming_particle_name, access_path, tag,
+                           access_path);
   }
 
   bool operator==(const TagClaim &other) const {
@@ -59,7 +69,19 @@ class TagClaim {
           (tag_ == other.tag_);
   }
 
+  template<typename H>
+  friend H AbslHashValue(H h, const TagClaim &tag_claim) {
+    return H::combine(std::move(h), tag_claim.claiming_particle_name_,
+                      tag_claim.access_path_, tag_claim.claim_tag_is_present_,
+                      tag_claim.tag_);
+  }
+
+  const std::string &claiming_particle_name() const {
+    return claiming_particle_name_;
+  }
   const AccessPath &access_path() const { return access_path_; }
+  bool claim_tag_is_present() const { return claim_tag_is_present_; }
+  const std::string &tag() const { return tag_; }
 
  private:
   // The name of the particle performing this claim. Important for connecting
@@ -19,6 +19,7 @@
 #include <google/protobuf/util/message_differencer.h>
 #include <google/protobuf/text_format.h>
 
+#include "absl/hash/hash_testing.h"
 #include "absl/strings/str_format.h"
 #include "src/common/testing/gtest.h"
 #include "src/ir/access_path_selectors.h"
@@ -249,4 +250,19 @@ INSTANTIATE_TEST_SUITE_P(
             testing::Values(true, false),
             testing::ValuesIn(sample_tags))));
 
+TEST(TagClaimHashTest, TagClaimHashTest) {
+  std::vector<TagClaim> tag_claims;
+  for (const std::string &particle_spec_name : particle_spec_names) {
+    for (const AccessPath &access_path : sample_access_paths) {
+      for (bool claim_tag_is_present : {true, false}) {
+        for (const std::string &tag : sample_tags) {
+          tag_claims.push_back(TagClaim(particle_spec_name, access_path,
+                                        claim_tag_is_present, tag));
+        }
+      }
+    }
+  }
+  EXPECT_TRUE(absl::VerifyTypeImplementsAbslHashCorrectly(tag_claims));
+}
+
 }  // namespace raksha::ir
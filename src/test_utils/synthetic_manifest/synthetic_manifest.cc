@@ -0,0 +1,147 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#include "src/test_utils/synthetic_manifest/synthetic_manifest.h"
+
+#include <string>
+
+#include "absl/strings/str_cat.h"
+#include "src/common/logging/logging.h"
+
+namespace raksha::test_utils {
+
+namespace {
+
+// Returns a type whose schema has `width` fields named `f0`, `f1`, ... at
+// each of `depth` levels.
+arcs::TypeProto MakeType(uint64_t depth, uint64_t width) {
+  arcs::TypeProto type;
+  if (depth == 0) {
+    type.set_primitive(arcs::PrimitiveTypeProto::TEXT);
+    return type;
+  }
+  arcs::SchemaProto *schema = type.mutable_entity()->mutable_schema();
+  schema->add_names(absl::StrCat("Schema", depth));
+  for (uint64_t i = 0; i < width; ++i) {
+    (*schema->mutable_fields())[absl::StrCat("f", i)] =
+        MakeType(depth - 1, width);
+  }
+  return type;
+}
+
+// Returns the access path of the first leaf of the given connection.
+arcs::AccessPathProto MakeFirstLeafAccessPath(
+    const std::string &particle_spec_name, const std::string &connection_name,
+    uint64_t schema_depth) {
+  arcs::AccessPathProto access_path;
+  arcs::AccessPathProto::HandleRoot *root = access_path.mutable_handle();
+  root->set_particle_spec(particle_spec_name);
+  root->set_handle_connection(connection_name);
+  for (uint64_t i = 0; i < schema_depth; ++i) {
+    access_path.add_selectors()->set_field("f0");
+  }
+  return access_path;
+}
+
+std::string ParticleSpecName(uint64_t index) {
+  return absl::StrCat("Particle", index);
+}
+
+std::string ReadConnectionName(uint64_t index) {
+  return absl::StrCat("in", index);
+}
+
+std::string WriteConnectionName(uint64_t index) {
+  return absl::StrCat("out", index);
+}
+
+// The handles read by the `i`th particle of a recipe are named `h<i>_<k>`.
+std::string HandleName(uint64_t particle_index, uint64_t read_index) {
+  return absl::StrCat("h", particle_index, "_", read_index);
+}
+
+}  // namespace
+
+arcs::ManifestProto GenerateSyntheticManifest(
+    const SyntheticManifestOptions &options) {
+  const uint64_t num_reads = (options.connections_per_particle + 1) / 2;
+  const uint64_t num_writes = options.connections_per_particle - num_reads;
+  CHECK(options.checks_per_particle == 0 || num_reads > 0)
+      << "Checks require at least one reading connection.";
+  CHECK(options.claims_per_particle == 0 || num_writes > 0)
+      << "Claims require at least two connections.";
+  const arcs::TypeProto type =
+      MakeType(options.schema_depth, options.schema_width);
+
+  arcs::ManifestProto manifest;
+  for (uint64_t p = 0; p < options.particles_per_recipe; ++p) {
+    arcs::ParticleSpecProto *spec = manifest.add_particle_specs();
+    spec->set_name(ParticleSpecName(p));
+    for (uint64_t r = 0; r < num_reads; ++r) {
+      arcs::HandleConnectionSpecProto *connection = spec->add_connections();
+      connection->set_name(ReadConnectionName(r));
+      connection->set_direction(arcs::HandleConnectionSpecProto::READS);
+      *connection->mutable_type() = type;
+    }
+    for (uint64_t w = 0; w < num_writes; ++w) {
+      arcs::HandleConnectionSpecProto *connection = spec->add_connections();
+      connection->set_name(WriteConnectionName(w));
+      connection->set_direction(arcs::HandleConnectionSpecProto::WRITES);
+      *connection->mutable_type() = type;
+    }
+    for (uint64_t c = 0; c < options.claims_per_particle; ++c) {
+      arcs::ClaimProto::Assume *assume =
+          spec->add_claims()->mutable_assume();
+      *assume->mutable_access_path() = MakeFirstLeafAccessPath(
+          spec->name(), WriteConnectionName(c % num_writes),
+          options.schema_depth);
+      assume->mutable_predicate()->mutable_label()->set_semantic_tag(
+          absl::StrCat("tag", c));
+    }
+    for (uint64_t c = 0; c < options.checks_per_particle; ++c) {
+      arcs::CheckProto *check = spec->add_checks();
+      *check->mutable_access_path() = MakeFirstLeafAccessPath(
+          spec->name(), ReadConnectionName(c % num_reads),
+          options.schema_depth);
+      check->mutable_predicate()->mutable_label()->set_semantic_tag(
+          absl::StrCat("tag", c));
+    }
+  }
+
+  for (uint64_t r = 0; r < options.num_recipes; ++r) {
+    arcs::RecipeProto *recipe = manifest.add_recipes();
+    recipe->set_name(absl::StrCat("Recipe", r));
+    for (uint64_t p = 0; p < options.particles_per_recipe; ++p) {
+      arcs::ParticleProto *particle = recipe->add_particles();
+      particle->set_spec_name(ParticleSpecName(p));
+      for (uint64_t i = 0; i < num_reads; ++i) {
+        arcs::HandleConnectionProto *connection = particle->add_connections();
+        connection->set_name(ReadConnectionName(i));
+        connection->set_handle(HandleName(p, i));
+        *connection->mutable_type() = type;
+      }
+      for (uint64_t i = 0; i < num_writes; ++i) {
+        arcs::HandleConnectionProto *connection = particle->add_connections();
+        connection->set_name(WriteConnectionName(i));
+        connection->set_handle(HandleName(p + 1, i % num_reads));
+        *connection->mutable_type() = type;
+      }
+    }
+  }
+  return manifest;
+}
+
+}  // namespace raksha::test_utils
@@ -0,0 +1,59 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#ifndef SRC_TEST_UTILS_SYNTHETIC_MANIFEST_SYNTHETIC_MANIFEST_H_
+#define SRC_TEST_UTILS_SYNTHETIC_MANIFEST_SYNTHETIC_MANIFEST_H_
+
+#include <cstdint>
+
+#include "third_party/arcs/proto/manifest.pb.h"
+
+namespace raksha::test_utils {
+
+// The shape of a manifest produced by GenerateSyntheticManifest.
+struct SyntheticManifestOptions {
+  // The number of recipes. Recipes are independent of each other.
+  uint64_t num_recipes = 1;
+  // The number of particles in each recipe. The particles of a recipe form a
+  // pipeline: particle `i` writes the handles that particle `i + 1` reads.
+  // The `i`th particle of every recipe implements the same ParticleSpec, so
+  // there are this many ParticleSpecs in the manifest.
+  uint64_t particles_per_recipe = 1;
+  // The number of handle connections of each ParticleSpec. The first half
+  // (rounded up) of the connections read, the rest write.
+  uint64_t connections_per_particle = 2;
+  // The depth and width of the schema of every handle connection. A depth
+  // of 0 gives a primitive type; otherwise each level of the schema has
+  // `schema_width` fields, so that there are `schema_width ^ schema_depth`
+  // leaf access paths per connection.
+  uint64_t schema_depth = 1;
+  uint64_t schema_width = 1;
+  // The number of checks and claims in each ParticleSpec. Checks are placed
+  // on the reading connections and claims on the writing connections, in
+  // round-robin order, always on the first leaf of the schema. The `n`th
+  // check checks for the tag that the `n`th claim claims.
+  uint64_t checks_per_particle = 0;
+  uint64_t claims_per_particle = 0;
+};
+
+// Returns a manifest of the given shape. The result is deterministic, so
+// that measurements on manifests with the same options are comparable.
+arcs::ManifestProto GenerateSyntheticManifest(
+    const SyntheticManifestOptions &options);
+
+}  // namespace raksha::test_utils
+
+#endif  // SRC_TEST_UTILS_SYNTHETIC_MANIFEST_SYNTHETIC_MANIFEST_H_
@@ -0,0 +1,97 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#include "src/test_utils/synthetic_manifest/synthetic_manifest.h"
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+
+namespace raksha::test_utils {
+
+struct SyntheticManifestTestParam {
+  SyntheticManifestOptions options;
+  uint64_t expected_num_edges_per_particle_spec;
+  uint64_t expected_num_checks_per_particle_spec;
+  uint64_t expected_num_claims_per_particle_spec;
+};
+
+class SyntheticManifestTest
+    : public testing::TestWithParam<SyntheticManifestTestParam> {};
+
+TEST_P(SyntheticManifestTest, GeneratesManifestOfRequestedShape) {
+  const SyntheticManifestTestParam &param = GetParam();
+  const SyntheticManifestOptions &options = param.options;
+  arcs::ManifestProto manifest = GenerateSyntheticManifest(options);
+
+  EXPECT_EQ(manifest.recipes_size(), options.num_recipes);
+  EXPECT_EQ(manifest.particle_specs_size(), options.particles_per_recipe);
+  for (const arcs::RecipeProto &recipe : manifest.recipes()) {
+    EXPECT_EQ(recipe.particles_size(), options.particles_per_recipe);
+    for (const arcs::ParticleProto &particle : recipe.particles()) {
+      EXPECT_EQ(particle.connections_size(), options.connections_per_particle);
+    }
+  }
+
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  for (const arcs::ParticleSpecProto &spec_proto : manifest.particle_specs()) {
+    const ir::ParticleSpec *spec =
+        system_spec->GetParticleSpec(spec_proto.name());
+    ASSERT_NE(spec, nullptr);
+    EXPECT_EQ(spec->edges().size(),
+              param.expected_num_edges_per_particle_spec);
+    EXPECT_EQ(spec->checks().size(),
+              param.expected_num_checks_per_particle_spec);
+    EXPECT_EQ(spec->tag_claims().size(),
+              param.expected_num_claims_per_particle_spec);
+  }
+
+  // The manifest must be consistent enough to generate datalog facts.
+  xform_to_datalog::ManifestDatalogFacts::CreateFromManifestProto(*system_spec,
+                                                                  manifest);
+}
+
+// With `n` reading and `m` writing connections of `l` leaves each, the
+// default derivation draws `n * l * m * l` edges.
+static const SyntheticManifestTestParam kSyntheticManifestTestParams[] = {
+    {.options = {.num_recipes = 1, .particles_per_recipe = 1},
+     .expected_num_edges_per_particle_spec = 1,
+     .expected_num_checks_per_particle_spec = 0,
+     .expected_num_claims_per_particle_spec = 0},
+    {.options = {.num_recipes = 3,
+                 .particles_per_recipe = 4,
+                 .connections_per_particle = 3,
+                 .schema_depth = 2,
+                 .schema_width = 2,
+                 .checks_per_particle = 3,
+                 .claims_per_particle = 2},
+     .expected_num_edges_per_particle_spec = 2 * 4 * 1 * 4,
+     .expected_num_checks_per_particle_spec = 3,
+     .expected_num_claims_per_particle_spec = 2},
+    {.options = {.num_recipes = 2,
+                 .particles_per_recipe = 2,
+                 .connections_per_particle = 1,
+                 .schema_depth = 0,
+                 .checks_per_particle = 1},
+     .expected_num_edges_per_particle_spec = 0,
+     .expected_num_checks_per_particle_spec = 1,
+     .expected_num_claims_per_particle_spec = 0},
+};
+
+INSTANTIATE_TEST_SUITE_P(SyntheticManifestTest, SyntheticManifestTest,
+                         testing::ValuesIn(kSyntheticManifestTestParams));
+
+}  // namespace raksha::test_utils
@@ -0,0 +1,127 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#include "src/utils/allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+thread_local raksha::utils::AllocationCounts thread_allocation_counts;
+
+void *CountedAllocate(std::size_t size) {
+  ++thread_allocation_counts.num_allocations;
+  thread_allocation_counts.num_bytes += size;
+  // malloc(0) may return nullptr, which `operator new` must not.
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+void *CountedAllocateAligned(std::size_t size, std::align_val_t alignment) {
+  ++thread_allocation_counts.num_allocations;
+  thread_allocation_counts.num_bytes += size;
+  std::size_t align = static_cast<std::size_t>(alignment);
+  // aligned_alloc needs a size that is a nonzero multiple of the alignment.
+  std::size_t rounded_size =
+      size == 0 ? align : (size + align - 1) & ~(align - 1);
+  void *ptr = std::aligned_alloc(align, rounded_size);
+  if (ptr == nullptr) throw std::bad_alloc();
+  return ptr;
+}
+
+}  // namespace
+
+void *operator new(std::size_t size) { return CountedAllocate(size); }
+void *operator new[](std::size_t size) { return CountedAllocate(size); }
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete[](void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+// The nothrow and aligned forms are replaced as well, so that no allocation
+// bypasses the counts and no delete frees memory that another
+// allocator returned.
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return CountedAllocate(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  try {
+    return CountedAllocate(size);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  return CountedAllocateAligned(size, alignment);
+}
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return CountedAllocateAligned(size, alignment);
+}
+void *operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+  try {
+    return CountedAllocateAligned(size, alignment);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+  try {
+    return CountedAllocateAligned(size, alignment);
+  } catch (const std::bad_alloc &) {
+    return nullptr;
+  }
+}
+void operator delete(void *ptr, std::align_val_t) noexcept { std::free(ptr); }
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  std::free(ptr);
+}
+void operator delete(void *ptr, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+void operator delete[](void *ptr, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  std::free(ptr);
+}
+
+namespace raksha::utils {
+
+AllocationCounts GetThreadAllocationCounts() {
+  return thread_allocation_counts;
+}
+
+}  // namespace raksha::utils
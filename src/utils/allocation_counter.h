@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#ifndef SRC_UTILS_ALLOCATION_COUNTER_H_
+#define SRC_UTILS_ALLOCATION_COUNTER_H_
+
+#include <cstdint>
+
+namespace raksha::utils {
+
+// Counts the calls to the global `operator new` and the bytes they request,
+// for each thread separately. Linking this library replaces the global
+// allocation functions of the binary with ones that count before calling
+// malloc. Counting is a thread-local increment, so threads do not contend
+// and the counts of one thread are not mixed with those of others.
+struct AllocationCounts {
+  uint64_t num_allocations = 0;
+  uint64_t num_bytes = 0;
+};
+
+// Returns the allocations made by the calling thread since it started.
+AllocationCounts GetThreadAllocationCounts();
+
+// Records the allocations made by the calling thread between its
+// construction and a call to `Get`.
+class ScopedAllocationCounter {
+ public:
+  ScopedAllocationCounter() : start_(GetThreadAllocationCounts()) {}
+
+  AllocationCounts Get() const {
+    AllocationCounts now = GetThreadAllocationCounts();
+    return AllocationCounts{
+        .num_allocations = now.num_allocations - start_.num_allocations,
+        .num_bytes = now.num_bytes - start_.num_bytes};
+  }
+
+ private:
+  AllocationCounts start_;
+};
+
+}  // namespace raksha::utils
+
+#endif  // SRC_UTILS_ALLOCATION_COUNTER_H_
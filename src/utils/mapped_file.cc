@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/utils/mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "src/common/logging/logging.h"
+
+namespace raksha::utils {
+
+std::unique_ptr<MappedFile> MappedFile::Open(const std::filesystem::path &path,
+                                             int advice) {
+  int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    LOG(ERROR) << "Error reading " << path << ":" << strerror(errno);
+    return nullptr;
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    LOG(ERROR) << "Error reading " << path << ":" << strerror(errno);
+    close(fd);
+    return nullptr;
+  }
+  size_t size = file_stat.st_size;
+  if (size == 0) {
+    close(fd);
+    return std::unique_ptr<MappedFile>(new MappedFile(nullptr, 0));
+  }
+  // The mapping stays valid once the file is closed.
+  void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    LOG(ERROR) << "Error mapping " << path << ":" << strerror(errno);
+    return nullptr;
+  }
+  madvise(data, size, advice);
+  return std::unique_ptr<MappedFile>(
+      new MappedFile(static_cast<const char *>(data), size));
+}
+
+MappedFile::~MappedFile() {
+  if (data_ != nullptr) munmap(const_cast<char *>(data_), size_);
+}
+
+}  // namespace raksha::utils
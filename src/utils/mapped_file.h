@@ -0,0 +1,62 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_UTILS_MAPPED_FILE_H_
+#define SRC_UTILS_MAPPED_FILE_H_
+
+#include <sys/mman.h>
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+
+#include "absl/strings/string_view.h"
+
+namespace raksha::utils {
+
+// A read-only mapping of a whole file, unmapped on destruction. The
+// contents are paged in as they are used, rather than read up front.
+class MappedFile {
+ public:
+  // Maps the file at `path` and passes `advice` to madvise for the mapping.
+  // Returns nullptr and logs an error if the file cannot be opened or
+  // mapped.
+  static std::unique_ptr<MappedFile> Open(const std::filesystem::path &path,
+                                          int advice = MADV_NORMAL);
+
+  ~MappedFile();
+
+  MappedFile(const MappedFile &) = delete;
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  // The contents of the file. Empty files have no mapping and a null data
+  // pointer.
+  const char *data() const { return data_; }
+  size_t size() const { return size_; }
+  absl::string_view contents() const {
+    return absl::string_view(data_, size_);
+  }
+
+ private:
+  MappedFile(const char *data, size_t size) : data_(data), size_(size) {}
+
+  const char *data_;
+  size_t size_;
+};
+
+}  // namespace raksha::utils
+
+#endif  // SRC_UTILS_MAPPED_FILE_H_
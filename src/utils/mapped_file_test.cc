@@ -0,0 +1,56 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/utils/mapped_file.h"
+
+#include <fstream>
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::utils {
+
+static std::filesystem::path WriteFile(const std::string &name,
+                                       const std::string &contents) {
+  std::filesystem::path path = std::filesystem::path(testing::TempDir()) / name;
+  std::ofstream(path, std::ios::out | std::ios::trunc | std::ios::binary)
+      << contents;
+  return path;
+}
+
+TEST(MappedFileTest, MapsTheContentsOfAFile) {
+  std::string contents("with\0nul", 8);
+  std::unique_ptr<MappedFile> mapped_file =
+      MappedFile::Open(WriteFile("contents", contents), MADV_WILLNEED);
+  ASSERT_NE(mapped_file, nullptr);
+  EXPECT_EQ(mapped_file->size(), 8);
+  EXPECT_EQ(mapped_file->contents(), contents);
+}
+
+TEST(MappedFileTest, MapsAnEmptyFile) {
+  std::unique_ptr<MappedFile> mapped_file =
+      MappedFile::Open(WriteFile("empty", ""));
+  ASSERT_NE(mapped_file, nullptr);
+  EXPECT_EQ(mapped_file->data(), nullptr);
+  EXPECT_EQ(mapped_file->size(), 0);
+}
+
+TEST(MappedFileTest, FailsOnAMissingFile) {
+  EXPECT_EQ(MappedFile::Open(std::filesystem::path(testing::TempDir()) /
+                             "missing"),
+            nullptr);
+}
+
+}  // namespace raksha::utils
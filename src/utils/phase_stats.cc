@@ -0,0 +1,123 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#include "src/utils/phase_stats.h"
+
+#include <sys/resource.h>
+#include <time.h>
+
+#include <algorithm>
+
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+
+namespace raksha::utils {
+
+namespace {
+
+// The user and system CPU time used by the calling thread so far.
+double ThreadCpuMicroseconds() {
+  struct timespec time;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+  return time.tv_sec * 1e6 + time.tv_nsec / 1e3;
+}
+
+// The peak resident set size of the process so far.
+int64_t PeakRssKb() {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+double MicrosecondsBetween(std::chrono::steady_clock::time_point start,
+                           std::chrono::steady_clock::time_point end) {
+  return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+}  // namespace
+
+PhaseStats::ScopedPhase::ScopedPhase(PhaseStats &stats, std::string name)
+    : stats_(stats),
+      wall_start_(std::chrono::steady_clock::now()),
+      cpu_start_us_(ThreadCpuMicroseconds()) {
+  phase_.name = std::move(name);
+  phase_.start_us = MicrosecondsBetween(stats_.creation_time_, wall_start_);
+  phase_.allocations = GetThreadAllocationCounts();
+}
+
+PhaseStats::ScopedPhase::~ScopedPhase() {
+  AllocationCounts allocations_at_end = GetThreadAllocationCounts();
+  phase_.allocations = AllocationCounts{
+      .num_allocations = allocations_at_end.num_allocations -
+                         phase_.allocations.num_allocations,
+      .num_bytes =
+          allocations_at_end.num_bytes - phase_.allocations.num_bytes};
+  phase_.wall_us =
+      MicrosecondsBetween(wall_start_, std::chrono::steady_clock::now());
+  phase_.cpu_us = ThreadCpuMicroseconds() - cpu_start_us_;
+  phase_.peak_rss_kb = PeakRssKb();
+  std::lock_guard<std::mutex> lock(stats_.mutex_);
+  std::vector<std::thread::id> &threads = stats_.threads_;
+  auto thread = std::find(threads.begin(), threads.end(),
+                          std::this_thread::get_id());
+  if (thread == threads.end()) {
+    thread = threads.insert(threads.end(), std::this_thread::get_id());
+  }
+  phase_.thread = thread - threads.begin() + 1;
+  stats_.phases_.push_back(std::move(phase_));
+}
+
+std::string PhaseStats::ToJson() const {
+  auto phase_formatter = [](std::string *out, const Phase &phase) {
+    absl::StrAppendFormat(
+        out,
+        R"(    {"name": "%s", "wall_ms": %.3f, "cpu_ms": %.3f, )"
+        R"("allocations": %d, "allocated_bytes": %d, "peak_rss_kb": %d, )"
+        R"("thread": %d})",
+        phase.name, phase.wall_us / 1000, phase.cpu_us / 1000,
+        phase.allocations.num_allocations, phase.allocations.num_bytes,
+        phase.peak_rss_kb, phase.thread);
+  };
+  auto value_formatter =
+      [](std::string *out, const std::pair<std::string, uint64_t> &value) {
+        absl::StrAppendFormat(out, R"(    "%s": %d)", value.first,
+                              value.second);
+      };
+  return absl::StrFormat(
+      "{\n  \"phases\": [\n%s\n  ],\n  \"output_bytes\": {\n%s\n  },\n"
+      "  \"counters\": {\n%s\n  },\n  \"peak_rss_kb\": %d\n}\n",
+      absl::StrJoin(phases_, ",\n", phase_formatter),
+      absl::StrJoin(output_sizes_, ",\n", value_formatter),
+      absl::StrJoin(counters_, ",\n", value_formatter), PeakRssKb());
+}
+
+std::string PhaseStats::ToChromeTrace() const {
+  auto event_formatter = [](std::string *out, const Phase &phase) {
+    absl::StrAppendFormat(
+        out,
+        R"(  {"name": "%s", "ph": "X", "pid": 1, "tid": %d, "ts": %.0f, )"
+        R"("dur": %.0f, "args": {"cpu_ms": %.3f, "allocations": %d, )"
+        R"("allocated_bytes": %d, "peak_rss_kb": %d}})",
+        phase.name, phase.thread, phase.start_us, phase.wall_us,
+        phase.cpu_us / 1000,
+        phase.allocations.num_allocations, phase.allocations.num_bytes,
+        phase.peak_rss_kb);
+  };
+  return absl::StrFormat("{\"traceEvents\": [\n%s\n]}\n",
+                         absl::StrJoin(phases_, ",\n", event_formatter));
+}
+
+}  // namespace raksha::utils
@@ -0,0 +1,132 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#ifndef SRC_UTILS_PHASE_STATS_H_
+#define SRC_UTILS_PHASE_STATS_H_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "src/utils/allocation_counter.h"
+
+namespace raksha::utils {
+
+// Records the wall time, CPU time, allocations and peak memory of the
+// phases of a tool, along with the sizes of its outputs and other counts,
+// and renders them as a JSON report or as a Chrome trace-event file.
+//
+// Phases may run concurrently on different threads. Their CPU time and
+// allocations are those of their own thread, so they do not include the
+// work of the phases they overlap on other threads.
+//
+// Allocations are those made through the global `operator new` of C++,
+// which this library replaces by linking :allocation_counter. Every binary
+// that links it, the production tools included, thus pays two thread-local
+// increments per allocation whether or not it records any phase. Memory
+// that Rust or C code allocates with malloc is not counted: the allocations
+// of a phase that calls into the Rust authorization logic compiler, such as
+// compile_auth_logic, are only those of its C++ side.
+class PhaseStats {
+ public:
+  struct Phase {
+    std::string name;
+    // The start of the phase, relative to the creation of the PhaseStats.
+    double start_us = 0;
+    double wall_us = 0;
+    // The CPU time of the thread that ran the phase.
+    double cpu_us = 0;
+    // The allocations of the thread that ran the phase.
+    AllocationCounts allocations;
+    // The peak resident set size of the process at the end of the phase.
+    int64_t peak_rss_kb = 0;
+    // The thread that ran the phase: 1 for the thread that created the
+    // PhaseStats, then 2, 3 and so on in order of the end of their first
+    // phase.
+    int thread = 1;
+  };
+
+  // Records a phase that lasts from its construction to its destruction.
+  class ScopedPhase {
+   public:
+    ScopedPhase(PhaseStats &stats, std::string name);
+    ~ScopedPhase();
+
+    ScopedPhase(const ScopedPhase &) = delete;
+    ScopedPhase &operator=(const ScopedPhase &) = delete;
+
+   private:
+    PhaseStats &stats_;
+    Phase phase_;
+    std::chrono::steady_clock::time_point wall_start_;
+    double cpu_start_us_;
+  };
+
+  PhaseStats()
+      : creation_time_(std::chrono::steady_clock::now()),
+        threads_({std::this_thread::get_id()}) {}
+
+  PhaseStats(const PhaseStats &) = delete;
+  PhaseStats &operator=(const PhaseStats &) = delete;
+
+  // Records the size in bytes of the output or section of output `name`.
+  // Unlike phases, output sizes and counters are to be recorded by a single
+  // thread.
+  void AddOutputSize(std::string name, uint64_t num_bytes) {
+    output_sizes_.push_back({std::move(name), num_bytes});
+  }
+
+  // Records a count that is neither a phase nor an output size, such as the
+  // hits of a cache.
+  void AddCounter(std::string name, uint64_t value) {
+    counters_.push_back({std::move(name), value});
+  }
+
+  const std::vector<Phase> &phases() const { return phases_; }
+  const std::vector<std::pair<std::string, uint64_t>> &output_sizes() const {
+    return output_sizes_;
+  }
+  const std::vector<std::pair<std::string, uint64_t>> &counters() const {
+    return counters_;
+  }
+
+  // Returns a JSON object with the phases, in the order in which they
+  // ended, the output sizes and the counters.
+  std::string ToJson() const;
+
+  // Returns the phases as complete events of the Chrome trace-event format,
+  // which can be loaded into chrome://tracing or Perfetto.
+  std::string ToChromeTrace() const;
+
+ private:
+  std::chrono::steady_clock::time_point creation_time_;
+  // Guards `threads_` and `phases_`, which ScopedPhases of any thread add
+  // to.
+  std::mutex mutex_;
+  // The threads that ran phases, by their `Phase::thread` minus one.
+  std::vector<std::thread::id> threads_;
+  std::vector<Phase> phases_;
+  std::vector<std::pair<std::string, uint64_t>> output_sizes_;
+  std::vector<std::pair<std::string, uint64_t>> counters_;
+};
+
+}  // namespace raksha::utils
+
+#endif  // SRC_UTILS_PHASE_STATS_H_
@@ -0,0 +1,101 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+
+#include "src/utils/phase_stats.h"
+
+#include <thread>
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::utils {
+
+TEST(PhaseStatsTest, RecordsPhasesInOrderOfCompletion) {
+  PhaseStats stats;
+  {
+    PhaseStats::ScopedPhase outer(stats, "outer");
+    { PhaseStats::ScopedPhase inner(stats, "inner"); }
+  }
+  { PhaseStats::ScopedPhase last(stats, "last"); }
+
+  ASSERT_EQ(stats.phases().size(), 3);
+  EXPECT_EQ(stats.phases().at(0).name, "inner");
+  EXPECT_EQ(stats.phases().at(1).name, "outer");
+  EXPECT_EQ(stats.phases().at(2).name, "last");
+  EXPECT_LE(stats.phases().at(1).start_us, stats.phases().at(0).start_us);
+  EXPECT_GE(stats.phases().at(1).wall_us, stats.phases().at(0).wall_us);
+  EXPECT_GT(stats.phases().at(2).peak_rss_kb, 0);
+}
+
+TEST(PhaseStatsTest, RecordsPhasesOfOtherThreads) {
+  PhaseStats stats;
+  std::thread worker([&stats] {
+    PhaseStats::ScopedPhase phase(stats, "worker");
+  });
+  worker.join();
+  { PhaseStats::ScopedPhase phase(stats, "main"); }
+
+  ASSERT_EQ(stats.phases().size(), 2);
+  EXPECT_EQ(stats.phases().at(0).name, "worker");
+  EXPECT_EQ(stats.phases().at(0).thread, 2);
+  EXPECT_EQ(stats.phases().at(1).thread, 1);
+  EXPECT_THAT(stats.ToChromeTrace(),
+              testing::HasSubstr(R"({"name": "worker", "ph": "X", "pid": 1, )"
+                                 R"("tid": 2)"));
+}
+
+TEST(PhaseStatsTest, CountsAllocationsOfPhase) {
+  PhaseStats stats;
+  {
+    PhaseStats::ScopedPhase phase(stats, "allocate");
+    // Unlike new-expressions, direct calls of the allocation function may
+    // not be optimized away.
+    ::operator delete(::operator new(1000));
+  }
+  ASSERT_EQ(stats.phases().size(), 1);
+  EXPECT_GE(stats.phases().at(0).allocations.num_allocations, 1);
+  EXPECT_GE(stats.phases().at(0).allocations.num_bytes, 1000);
+}
+
+TEST(PhaseStatsTest, CountsOnlyAllocationsOfThePhaseThread) {
+  PhaseStats stats;
+  {
+    PhaseStats::ScopedPhase phase(stats, "main");
+    std::thread worker([] { ::operator delete(::operator new(1 << 20)); });
+    worker.join();
+  }
+  ASSERT_EQ(stats.phases().size(), 1);
+  EXPECT_LT(stats.phases().at(0).allocations.num_bytes, 1 << 20);
+}
+
+TEST(PhaseStatsTest, RendersJsonAndChromeTrace) {
+  PhaseStats stats;
+  { PhaseStats::ScopedPhase phase(stats, "parse"); }
+  stats.AddOutputSize("edges", 42);
+  stats.AddCounter("cache_hits", 3);
+
+  std::string json = stats.ToJson();
+  EXPECT_THAT(json, testing::HasSubstr(R"({"name": "parse", "wall_ms": )"));
+  EXPECT_THAT(json, testing::HasSubstr(R"("edges": 42)"));
+  EXPECT_THAT(json,
+              testing::HasSubstr("\"counters\": {\n    \"cache_hits\": 3\n"));
+
+  std::string trace = stats.ToChromeTrace();
+  EXPECT_THAT(trace, testing::StartsWith(R"({"traceEvents": [)"));
+  EXPECT_THAT(trace,
+              testing::HasSubstr(R"({"name": "parse", "ph": "X", "pid": 1)"));
+}
+
+}  // namespace raksha::utils
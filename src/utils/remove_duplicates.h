@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_UTILS_REMOVE_DUPLICATES_H_
+#define SRC_UTILS_REMOVE_DUPLICATES_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/hash/hash.h"
+
+namespace raksha::utils {
+
+// Removes all but the first of the equal elements of `elements`, keeping
+// the order of the rest, and returns the number of elements removed.
+// Elements are compared by their AbslHashValue and operator==, and need
+// only be movable.
+template <typename T>
+uint64_t RemoveDuplicates(std::vector<T> &elements) {
+  struct PointeeHash {
+    size_t operator()(const T *element) const {
+      return absl::Hash<T>()(*element);
+    }
+  };
+  struct PointeeEq {
+    bool operator()(const T *lhs, const T *rhs) const { return *lhs == *rhs; }
+  };
+  // The set points into `unique_elements`, which never reallocates.
+  std::vector<T> unique_elements;
+  unique_elements.reserve(elements.size());
+  absl::flat_hash_set<const T *, PointeeHash, PointeeEq> seen;
+  for (T &element : elements) {
+    if (seen.contains(&element)) continue;
+    unique_elements.push_back(std::move(element));
+    seen.insert(&unique_elements.back());
+  }
+  uint64_t num_removed = elements.size() - unique_elements.size();
+  elements = std::move(unique_elements);
+  return num_removed;
+}
+
+}  // namespace raksha::utils
+
+#endif  // SRC_UTILS_REMOVE_DUPLICATES_H_
@@ -0,0 +1,72 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/utils/remove_duplicates.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::utils {
+
+TEST(RemoveDuplicatesTest, KeepsFirstOccurrencesInOrder) {
+  std::vector<std::string> values = {"b", "a", "b", "c", "a", "b"};
+  EXPECT_EQ(RemoveDuplicates(values), 3);
+  EXPECT_THAT(values, testing::ElementsAre("b", "a", "c"));
+}
+
+TEST(RemoveDuplicatesTest, LeavesUniqueElementsAlone) {
+  std::vector<int> values = {3, 1, 2};
+  EXPECT_EQ(RemoveDuplicates(values), 0);
+  EXPECT_THAT(values, testing::ElementsAre(3, 1, 2));
+
+  std::vector<int> empty;
+  EXPECT_EQ(RemoveDuplicates(empty), 0);
+  EXPECT_TRUE(empty.empty());
+}
+
+// A move-only value, like a TagCheck, that is compared by its contents.
+class MoveOnly {
+ public:
+  explicit MoveOnly(int value) : value_(std::make_unique<int>(value)) {}
+
+  int value() const { return *value_; }
+
+  bool operator==(const MoveOnly &other) const {
+    return *value_ == *other.value_;
+  }
+
+  template <typename H>
+  friend H AbslHashValue(H h, const MoveOnly &move_only) {
+    return H::combine(std::move(h), *move_only.value_);
+  }
+
+ private:
+  std::unique_ptr<int> value_;
+};
+
+TEST(RemoveDuplicatesTest, MovesMoveOnlyElements) {
+  std::vector<MoveOnly> values;
+  for (int value : {1, 2, 1, 1, 3, 2}) values.push_back(MoveOnly(value));
+  EXPECT_EQ(RemoveDuplicates(values), 3);
+  std::vector<int> remaining;
+  for (const MoveOnly &value : values) remaining.push_back(value.value());
+  EXPECT_THAT(remaining, testing::ElementsAre(1, 2, 3));
+}
+
+}  // namespace raksha::utils
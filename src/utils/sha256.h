@@ -0,0 +1,53 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_UTILS_SHA256_H_
+#define SRC_UTILS_SHA256_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "absl/strings/string_view.h"
+
+namespace raksha::utils {
+
+// Computes the SHA-256 digest of a sequence of byte strings, for naming
+// content that is cached on disk. Unlike absl::Hash, the digest is the same
+// in every process and on every host.
+class Sha256 {
+ public:
+  Sha256();
+
+  // Appends `data` to the hashed bytes.
+  void Update(absl::string_view data);
+
+  // Returns the digest of the bytes so far as 64 lowercase hex digits. This
+  // ends the computation; no further updates may be made.
+  std::string HexDigest();
+
+ private:
+  void ProcessBlock(const uint8_t *block);
+
+  std::array<uint32_t, 8> state_;
+  std::array<uint8_t, 64> buffer_;
+  uint64_t num_bytes_ = 0;
+  bool finished_ = false;
+};
+
+}  // namespace raksha::utils
+
+#endif  // SRC_UTILS_SHA256_H_
@@ -0,0 +1,53 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/utils/sha256.h"
+
+#include <string>
+
+#include "src/common/testing/gtest.h"
+
+namespace raksha::utils {
+
+static std::string Sha256HexDigest(absl::string_view data) {
+  Sha256 sha256;
+  sha256.Update(data);
+  return sha256.HexDigest();
+}
+
+// The examples of FIPS 180-4 and a message that fills exactly one block.
+TEST(Sha256Test, MatchesKnownDigests) {
+  EXPECT_EQ(Sha256HexDigest(""),
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  EXPECT_EQ(Sha256HexDigest("abc"),
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  EXPECT_EQ(Sha256HexDigest(
+                "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"),
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  EXPECT_EQ(Sha256HexDigest(std::string(64, 'a')),
+            "ffe054fe7ae0cb6dc65c3af9b61d5209f439851db43d0ba5997337df154668eb");
+}
+
+TEST(Sha256Test, DoesNotDependOnHowTheInputIsSplit) {
+  std::string message(1000, 'x');
+  Sha256 sha256;
+  for (size_t i = 0; i < message.size(); i += 7) {
+    sha256.Update(absl::string_view(message).substr(i, 7));
+  }
+  EXPECT_EQ(sha256.HexDigest(), Sha256HexDigest(message));
+}
+
+}  // namespace raksha::utils
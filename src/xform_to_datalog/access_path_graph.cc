@@ -0,0 +1,160 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include "src/xform_to_datalog/access_path_graph.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "src/ir/datalog_print_context.h"
+
+namespace raksha::xform_to_datalog {
+
+AccessPathGraph AccessPathGraph::Create(
+    const ManifestDatalogFacts &manifest_facts) {
+  AccessPathGraph graph;
+  for (const ManifestDatalogFacts::Particle &particle :
+       manifest_facts.particle_instances()) {
+    graph.AddParticle(particle);
+  }
+  return graph;
+}
+
+uint32_t AccessPathGraph::GetNode(std::string access_path) {
+  auto insert_result =
+      node_ids_.insert({std::move(access_path), names_.size()});
+  if (insert_result.second) {
+    names_.push_back(insert_result.first->first);
+    successors_.emplace_back();
+    fan_in_.push_back(0);
+  }
+  return insert_result.first->second;
+}
+
+std::optional<uint32_t> AccessPathGraph::FindNode(
+    absl::string_view access_path) const {
+  auto find_result = node_ids_.find(access_path);
+  if (find_result == node_ids_.end()) return std::nullopt;
+  return find_result->second;
+}
+
+void AccessPathGraph::AddParticle(
+    const ManifestDatalogFacts::Particle &particle) {
+  ir::DatalogPrintContext ctxt;
+  ctxt.set_instantiation_map(&particle.instantiation_map());
+  for (const std::vector<ir::Edge> *edges :
+       {&particle.edges(), &particle.spec()->edges()}) {
+    for (const ir::Edge &edge : *edges) {
+      // Number the source first, as the order in which arguments are
+      // evaluated is unspecified.
+      uint32_t from = GetNode(edge.from().ToDatalog(ctxt));
+      AddEdge(from, GetNode(edge.to().ToDatalog(ctxt)));
+    }
+  }
+}
+
+// Tarjan's algorithm, with an explicit stack so that long dataflow chains do
+// not overflow the call stack. It completes components in reverse
+// topological order.
+StronglyConnectedComponents GetStronglyConnectedComponents(
+    const AccessPathGraph &graph) {
+  constexpr uint32_t kUnvisited = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> index(graph.num_nodes(), kUnvisited);
+  std::vector<uint32_t> lowlink(graph.num_nodes(), 0);
+  std::vector<bool> on_stack(graph.num_nodes(), false);
+  std::vector<uint32_t> scc_stack;
+  // Pairs of a node and the position of its next successor to visit.
+  std::vector<std::pair<uint32_t, size_t>> dfs_stack;
+  uint32_t next_index = 0;
+  StronglyConnectedComponents sccs;
+  sccs.component_of_node.resize(graph.num_nodes());
+
+  auto visit = [&](uint32_t node) {
+    index[node] = lowlink[node] = next_index++;
+    scc_stack.push_back(node);
+    on_stack[node] = true;
+    dfs_stack.push_back({node, 0});
+  };
+
+  for (uint32_t root = 0; root < graph.num_nodes(); ++root) {
+    if (index[root] != kUnvisited) continue;
+    visit(root);
+    while (!dfs_stack.empty()) {
+      uint32_t node = dfs_stack.back().first;
+      size_t &next_successor = dfs_stack.back().second;
+      if (next_successor < graph.successors(node).size()) {
+        uint32_t successor = graph.successors(node)[next_successor++];
+        if (index[successor] == kUnvisited) {
+          visit(successor);
+        } else if (on_stack[successor]) {
+          lowlink[node] = std::min(lowlink[node], index[successor]);
+        }
+        continue;
+      }
+      dfs_stack.pop_back();
+      if (!dfs_stack.empty()) {
+        uint32_t parent = dfs_stack.back().first;
+        lowlink[parent] = std::min(lowlink[parent], lowlink[node]);
+      }
+      if (lowlink[node] != index[node]) continue;
+      uint32_t component = sccs.component_sizes.size();
+      uint64_t size = 0;
+      uint32_t member;
+      do {
+        member = scc_stack.back();
+        scc_stack.pop_back();
+        on_stack[member] = false;
+        sccs.component_of_node[member] = component;
+        ++size;
+      } while (member != node);
+      sccs.component_sizes.push_back(size);
+      sccs.is_cyclic.push_back(size > 1);
+    }
+  }
+  for (uint32_t node = 0; node < graph.num_nodes(); ++node) {
+    for (uint32_t successor : graph.successors(node)) {
+      if (successor == node) {
+        sccs.is_cyclic[sccs.component_of_node[node]] = true;
+      }
+    }
+  }
+  return sccs;
+}
+
+std::vector<std::vector<uint32_t>> GetComponentSuccessors(
+    const AccessPathGraph &graph, const StronglyConnectedComponents &sccs) {
+  std::vector<std::vector<uint32_t>> successors(sccs.num_components());
+  for (uint32_t node = 0; node < graph.num_nodes(); ++node) {
+    uint32_t component = sccs.component_of_node[node];
+    for (uint32_t successor : graph.successors(node)) {
+      uint32_t successor_component = sccs.component_of_node[successor];
+      if (successor_component != component) {
+        successors[component].push_back(successor_component);
+      }
+    }
+  }
+  for (std::vector<uint32_t> &component_successors : successors) {
+    std::sort(component_successors.begin(), component_successors.end());
+    component_successors.erase(std::unique(component_successors.begin(),
+                                           component_successors.end()),
+                               component_successors.end());
+  }
+  return successors;
+}
+
+}  // namespace raksha::xform_to_datalog
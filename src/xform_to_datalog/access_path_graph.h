@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_ACCESS_PATH_GRAPH_H_
+#define SRC_XFORM_TO_DATALOG_ACCESS_PATH_GRAPH_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+
+namespace raksha::xform_to_datalog {
+
+// The dataflow graph instantiated from a manifest, as in the edge facts that
+// ManifestDatalogFacts::ToDatalog prints, with access paths numbered in the
+// order of their first appearance.
+class AccessPathGraph {
+ public:
+  static AccessPathGraph Create(const ManifestDatalogFacts &manifest_facts);
+
+  // Returns the node of `access_path`, adding it if it is new.
+  uint32_t GetNode(std::string access_path);
+  // Returns the node of `access_path`, or std::nullopt if there is none.
+  std::optional<uint32_t> FindNode(absl::string_view access_path) const;
+
+  void AddEdge(uint32_t from, uint32_t to) {
+    successors_[from].push_back(to);
+    ++fan_in_[to];
+    ++num_edges_;
+  }
+
+  // Adds the edges of the handle connections and flows of `particle`.
+  void AddParticle(const ManifestDatalogFacts::Particle &particle);
+
+  uint64_t num_nodes() const { return names_.size(); }
+  uint64_t num_edges() const { return num_edges_; }
+  const std::string &name(uint32_t node) const { return names_[node]; }
+  const std::vector<uint32_t> &successors(uint32_t node) const {
+    return successors_[node];
+  }
+  uint64_t fan_in(uint32_t node) const { return fan_in_[node]; }
+  uint64_t fan_out(uint32_t node) const { return successors_[node].size(); }
+
+ private:
+  absl::flat_hash_map<std::string, uint32_t> node_ids_;
+  std::vector<std::string> names_;
+  std::vector<std::vector<uint32_t>> successors_;
+  std::vector<uint64_t> fan_in_;
+  uint64_t num_edges_ = 0;
+};
+
+// The strongly connected components of a graph. Components are numbered in
+// reverse topological order: the edges between components lead from larger
+// to smaller numbers.
+struct StronglyConnectedComponents {
+  std::vector<uint32_t> component_of_node;
+  std::vector<uint64_t> component_sizes;
+  // Whether each component has a cycle: more than one node or a self-loop.
+  std::vector<bool> is_cyclic;
+
+  uint64_t num_components() const { return component_sizes.size(); }
+};
+
+StronglyConnectedComponents GetStronglyConnectedComponents(
+    const AccessPathGraph &graph);
+
+// The edges of the graph condensed into `sccs`: for each component, the
+// other components its nodes have edges to, sorted and without duplicates.
+std::vector<std::vector<uint32_t>> GetComponentSuccessors(
+    const AccessPathGraph &graph, const StronglyConnectedComponents &sccs);
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_ACCESS_PATH_GRAPH_H_
@@ -0,0 +1,256 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/authorization_logic_cache.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/match.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "absl/strings/strip.h"
+#include "src/common/logging/logging.h"
+#include "src/utils/sha256.h"
+
+namespace raksha::xform_to_datalog {
+
+namespace {
+
+// The version of the crate of the authorization logic compiler.
+constexpr absl::string_view kCompilerCrateVersion = "authorization-logic 0.1.0";
+
+// The first line of every entry, followed by the size of the datalog. The
+// version is to be bumped on any change to the entries or their keys.
+constexpr absl::string_view kEntryHeader = "raksha-auth-logic-cache-v1";
+
+std::optional<std::string> ReadFile(const std::filesystem::path &path) {
+  std::ifstream stream(path, std::ios::in | std::ios::binary);
+  if (!stream) return std::nullopt;
+  std::stringstream contents;
+  contents << stream.rdbuf();
+  return contents.str();
+}
+
+// Whether `c` may be part of an ID of the authorization logic grammar.
+bool IsIdChar(char c) {
+  return absl::ascii_isalnum(c) || c == '_' || c == '/' || c == '.' ||
+         c == '#' || c == '"';
+}
+
+// Returns the IDs and keywords of an authorization logic program, without
+// comments and punctuation.
+std::vector<absl::string_view> GetTokens(absl::string_view source) {
+  std::vector<absl::string_view> tokens;
+  size_t i = 0;
+  while (i < source.size()) {
+    absl::string_view rest = source.substr(i);
+    if (absl::StartsWith(rest, "//")) {
+      size_t end = rest.find('\n');
+      i = (end == absl::string_view::npos) ? source.size() : i + end + 1;
+    } else if (absl::StartsWith(rest, "/*")) {
+      size_t end = rest.find("*/", 2);
+      i = (end == absl::string_view::npos) ? source.size() : i + end + 2;
+    } else if (IsIdChar(source[i])) {
+      size_t end = i;
+      while (end < source.size() && IsIdChar(source[end])) ++end;
+      tokens.push_back(source.substr(i, end - i));
+      i = end;
+    } else {
+      ++i;
+    }
+  }
+  return tokens;
+}
+
+// Returns the files that compiling the program with `tokens` reads, besides
+// the program itself: the serialized assertions and signatures of its
+// imports and the keys it binds. The paths are relative to the working
+// directory, as the compiler opens them. Returns std::nullopt if the program
+// exports assertions or cannot be scanned.
+std::optional<std::vector<std::string>> GetReferencedFiles(
+    const std::vector<absl::string_view> &tokens) {
+  std::vector<std::string> files;
+  for (size_t i = 0; i < tokens.size(); ++i) {
+    // The compiler drops the quotes of these IDs.
+    auto get_id = [&](size_t offset) -> std::optional<std::string> {
+      if (i + offset >= tokens.size()) return std::nullopt;
+      return absl::StrReplaceAll(tokens[i + offset], {{"\"", ""}});
+    };
+    if (tokens[i] == "exportTo") return std::nullopt;
+    if (tokens[i] == "import") {
+      // import <principal> says <ID>
+      std::optional<std::string> id = get_id(3);
+      if (!id.has_value()) return std::nullopt;
+      files.push_back(absl::StrCat(*id, ".obj"));
+      files.push_back(absl::StrCat(*id, ".sig"));
+    } else if (tokens[i] == "BindPubKey" || tokens[i] == "BindPrivKey") {
+      // Bind{Pub,Priv}Key <principal> <ID>
+      std::optional<std::string> id = get_id(2);
+      if (!id.has_value()) return std::nullopt;
+      files.push_back(*std::move(id));
+    }
+  }
+  return files;
+}
+
+// Adds `field` to `sha256`, prefixed by its size so that the fields are
+// unambiguous.
+void AddField(utils::Sha256 &sha256, absl::string_view field) {
+  sha256.Update(absl::StrCat(field.size(), ":"));
+  sha256.Update(field);
+}
+
+}  // namespace
+
+AuthorizationLogicCache::AuthorizationLogicCache(
+    std::filesystem::path cache_dir, std::string compiler_version)
+    : cache_dir_(std::move(cache_dir)),
+      compiler_version_(std::move(compiler_version)) {
+  std::error_code error;
+  std::filesystem::create_directories(cache_dir_, error);
+  if (error) {
+    LOG(WARNING) << "Error creating the authorization logic cache "
+                 << cache_dir_ << ":" << error.message();
+  }
+}
+
+std::string AuthorizationLogicCache::GetLinkedCompilerVersion() {
+  std::error_code error;
+  std::filesystem::path binary =
+      std::filesystem::read_symlink("/proc/self/exe", error);
+  if (error) return std::string(kCompilerCrateVersion);
+  uintmax_t size = std::filesystem::file_size(binary, error);
+  auto write_time = std::filesystem::last_write_time(binary, error);
+  if (error) return std::string(kCompilerCrateVersion);
+  return absl::StrCat(kCompilerCrateVersion, " ", binary.string(), " ", size,
+                      " ", write_time.time_since_epoch().count());
+}
+
+std::optional<std::string> AuthorizationLogicCache::GetKey(
+    const std::filesystem::path &program_dir, absl::string_view program,
+    absl::string_view relations_to_not_declare) const {
+  std::optional<std::string> source =
+      ReadFile(program_dir / std::string(program));
+  if (!source.has_value()) return std::nullopt;
+  std::optional<std::vector<std::string>> referenced_files =
+      GetReferencedFiles(GetTokens(*source));
+  if (!referenced_files.has_value()) return std::nullopt;
+
+  utils::Sha256 sha256;
+  AddField(sha256, kEntryHeader);
+  AddField(sha256, compiler_version_);
+  AddField(sha256, relations_to_not_declare);
+  AddField(sha256, program);
+  AddField(sha256, *source);
+  for (const std::string &file : *referenced_files) {
+    std::optional<std::string> contents = ReadFile(file);
+    if (!contents.has_value()) return std::nullopt;
+    AddField(sha256, file);
+    AddField(sha256, *contents);
+  }
+  return sha256.HexDigest();
+}
+
+std::filesystem::path AuthorizationLogicCache::GetEntryPath(
+    absl::string_view key) const {
+  return cache_dir_ / absl::StrCat(key, ".dl");
+}
+
+std::optional<std::string> AuthorizationLogicCache::Lookup(
+    absl::string_view key) const {
+  std::optional<std::string> entry = ReadFile(GetEntryPath(key));
+  if (!entry.has_value()) return std::nullopt;
+  // Entries are renamed into place once written, so a malformed entry was
+  // not written by this version.
+  std::pair<absl::string_view, absl::string_view> header_and_datalog =
+      absl::StrSplit(*entry, absl::MaxSplits('\n', 1));
+  absl::string_view size_text = header_and_datalog.first;
+  uint64_t size;
+  if (!absl::ConsumePrefix(&size_text, kEntryHeader) ||
+      !absl::ConsumePrefix(&size_text, " ") ||
+      !absl::SimpleAtoi(size_text, &size) ||
+      header_and_datalog.second.size() != size) {
+    LOG(WARNING) << "Ignoring the malformed authorization logic cache entry "
+                 << GetEntryPath(key);
+    return std::nullopt;
+  }
+  return std::string(header_and_datalog.second);
+}
+
+bool AuthorizationLogicCache::Store(absl::string_view key,
+                                    absl::string_view datalog) const {
+  std::filesystem::path entry_path = GetEntryPath(key);
+  std::string temp_path = absl::StrCat(entry_path.string(), ".XXXXXX");
+  int fd = mkstemp(temp_path.data());
+  if (fd < 0) {
+    LOG(WARNING) << "Error creating an authorization logic cache entry in "
+                 << cache_dir_ << ":" << strerror(errno);
+    return false;
+  }
+  std::string entry =
+      absl::StrCat(kEntryHeader, " ", datalog.size(), "\n", datalog);
+  absl::string_view rest(entry);
+  while (!rest.empty()) {
+    ssize_t num_written = write(fd, rest.data(), rest.size());
+    if (num_written < 0 && errno == EINTR) continue;
+    if (num_written <= 0) break;
+    rest.remove_prefix(num_written);
+  }
+  // The entry must be whole on disk before it is renamed into place.
+  bool written = rest.empty() && fsync(fd) == 0;
+  written = (close(fd) == 0) && written;
+  if (!written || rename(temp_path.c_str(), entry_path.c_str()) != 0) {
+    LOG(WARNING) << "Error writing the authorization logic cache entry "
+                 << entry_path << ":" << strerror(errno);
+    unlink(temp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+std::optional<std::string> AuthorizationLogicCache::GetOrCompile(
+    const std::filesystem::path &program_dir, absl::string_view program,
+    absl::string_view relations_to_not_declare,
+    absl::FunctionRef<std::optional<std::string>()> compile) {
+  std::optional<std::string> key =
+      GetKey(program_dir, program, relations_to_not_declare);
+  if (!key.has_value()) {
+    ++stats_.uncacheable;
+    return compile();
+  }
+  if (std::optional<std::string> datalog = Lookup(*key); datalog.has_value()) {
+    ++stats_.hits;
+    return datalog;
+  }
+  ++stats_.misses;
+  std::optional<std::string> datalog = compile();
+  if (datalog.has_value()) Store(*key, *datalog);
+  return datalog;
+}
+
+}  // namespace raksha::xform_to_datalog
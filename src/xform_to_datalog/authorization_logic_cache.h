@@ -0,0 +1,94 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_AUTHORIZATION_LOGIC_CACHE_H_
+#define SRC_XFORM_TO_DATALOG_AUTHORIZATION_LOGIC_CACHE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+#include "absl/functional/function_ref.h"
+#include "absl/strings/string_view.h"
+
+namespace raksha::xform_to_datalog {
+
+// A cache of the datalog that the authorization logic compiler generates,
+// in a directory that may be shared by concurrent processes. Entries are
+// named by a digest of everything the output depends on: the program, the
+// files it imports and the keys it binds, the relations that are not
+// declared and the version of the compiler. Entries are written to a
+// temporary file and renamed into place, so readers see either a whole
+// entry or none.
+class AuthorizationLogicCache {
+ public:
+  // How the lookups of a cache went.
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    // Programs whose output cannot be cached, which are always compiled.
+    uint64_t uncacheable = 0;
+  };
+
+  // Uses the cache in `cache_dir`, which is created if it does not exist,
+  // for the output of the compiler with version `compiler_version`.
+  explicit AuthorizationLogicCache(
+      std::filesystem::path cache_dir,
+      std::string compiler_version = GetLinkedCompilerVersion());
+
+  // Returns the version of the compiler linked into this binary. This
+  // includes the identity of the binary, as the version of the crate is not
+  // bumped on every change to the compiler.
+  static std::string GetLinkedCompilerVersion();
+
+  // Returns the key of the output of compiling `program` in `program_dir`
+  // without declaring `relations_to_not_declare`. Returns std::nullopt if
+  // the output cannot be cached: if the program exports assertions, which
+  // the compiler writes as a side effect, or a file it refers to cannot be
+  // read.
+  std::optional<std::string> GetKey(
+      const std::filesystem::path &program_dir, absl::string_view program,
+      absl::string_view relations_to_not_declare) const;
+
+  // Returns the datalog stored under `key`, if any.
+  std::optional<std::string> Lookup(absl::string_view key) const;
+
+  // Stores `datalog` under `key`. Returns false and logs a warning if it
+  // cannot be written; the cache is then only slower.
+  bool Store(absl::string_view key, absl::string_view datalog) const;
+
+  // Returns the datalog of `program` from the cache or, if it is not
+  // cached, from `compile`, whose result is then stored. Errors of
+  // `compile` are returned and not cached.
+  std::optional<std::string> GetOrCompile(
+      const std::filesystem::path &program_dir, absl::string_view program,
+      absl::string_view relations_to_not_declare,
+      absl::FunctionRef<std::optional<std::string>()> compile);
+
+  const Stats &stats() const { return stats_; }
+
+ private:
+  std::filesystem::path GetEntryPath(absl::string_view key) const;
+
+  std::filesystem::path cache_dir_;
+  std::string compiler_version_;
+  Stats stats_;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_AUTHORIZATION_LOGIC_CACHE_H_
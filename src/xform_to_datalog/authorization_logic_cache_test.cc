@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/authorization_logic_cache.h"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "src/common/testing/gtest.h"
+
+namespace raksha::xform_to_datalog {
+
+static constexpr char kProgram[] =
+    R"("EndUser" says "P1" canSay ownsTag("P1", "userSelection").)";
+
+static constexpr char kRelationsToNotDeclare[] = "says_ownsTag,says_hasTag";
+
+class AuthorizationLogicCacheTest : public testing::Test {
+ public:
+  AuthorizationLogicCacheTest()
+      : test_dir_(
+            std::filesystem::path(testing::TempDir()) /
+            testing::UnitTest::GetInstance()->current_test_info()->name()),
+        cache_dir_(test_dir_ / "cache") {
+    std::filesystem::remove_all(test_dir_);
+    std::filesystem::create_directories(test_dir_);
+  }
+
+ protected:
+  // Writes `contents` to the file `name` of the test directory and returns
+  // its path.
+  std::filesystem::path WriteFile(const std::string &name,
+                                  const std::string &contents) {
+    std::filesystem::path path = test_dir_ / name;
+    std::ofstream(path, std::ios::out | std::ios::trunc | std::ios::binary)
+        << contents;
+    return path;
+  }
+
+  std::filesystem::path test_dir_;
+  std::filesystem::path cache_dir_;
+};
+
+TEST_F(AuthorizationLogicCacheTest, StoresAndLooksUpEntries) {
+  AuthorizationLogicCache cache(cache_dir_, "v1");
+  EXPECT_EQ(cache.Lookup("key"), std::nullopt);
+  ASSERT_TRUE(cache.Store("key", "says_may(\"a\").\n"));
+  EXPECT_EQ(cache.Lookup("key"), "says_may(\"a\").\n");
+  // Entries are replaced as a whole.
+  ASSERT_TRUE(cache.Store("key", ""));
+  EXPECT_EQ(cache.Lookup("key"), "");
+}
+
+TEST_F(AuthorizationLogicCacheTest, KeysDependOnEverythingTheOutputDoesOn) {
+  std::filesystem::path key_file = WriteFile("p1_pub.json", "key 1");
+  WriteFile("program", absl::StrCat(kProgram, "\nBindPubKey \"P1\" \"",
+                                    key_file.string(), "\"\n"));
+  AuthorizationLogicCache cache(cache_dir_, "v1");
+  std::optional<std::string> key =
+      cache.GetKey(test_dir_, "program", kRelationsToNotDeclare);
+  ASSERT_TRUE(key.has_value());
+  EXPECT_EQ(cache.GetKey(test_dir_, "program", kRelationsToNotDeclare), key);
+
+  EXPECT_NE(cache.GetKey(test_dir_, "program", "says_ownsTag"), key);
+  EXPECT_NE(AuthorizationLogicCache(cache_dir_, "v2")
+                .GetKey(test_dir_, "program", kRelationsToNotDeclare),
+            key);
+  WriteFile("p1_pub.json", "key 2");
+  EXPECT_NE(cache.GetKey(test_dir_, "program", kRelationsToNotDeclare), key);
+  WriteFile("program", kProgram);
+  EXPECT_NE(cache.GetKey(test_dir_, "program", kRelationsToNotDeclare), key);
+}
+
+TEST_F(AuthorizationLogicCacheTest, DoesNotKeyProgramsWithSideEffects) {
+  AuthorizationLogicCache cache(cache_dir_, "v1");
+  WriteFile("exporting",
+            "\"P1\" says ownsTag(\"P1\", \"t\") exportTo out\n");
+  EXPECT_EQ(cache.GetKey(test_dir_, "exporting", kRelationsToNotDeclare),
+            std::nullopt);
+  WriteFile("importing", "import \"P1\" says missing\n");
+  EXPECT_EQ(cache.GetKey(test_dir_, "importing", kRelationsToNotDeclare),
+            std::nullopt);
+  EXPECT_EQ(cache.GetKey(test_dir_, "missing", kRelationsToNotDeclare),
+            std::nullopt);
+  // Keywords in comments are ignored.
+  WriteFile("commented", absl::StrCat(kProgram, "\n// exportTo out\n"));
+  EXPECT_NE(cache.GetKey(test_dir_, "commented", kRelationsToNotDeclare),
+            std::nullopt);
+}
+
+TEST_F(AuthorizationLogicCacheTest, CompilesOnlyOnMisses) {
+  WriteFile("program", kProgram);
+  AuthorizationLogicCache cache(cache_dir_, "v1");
+  int num_compilations = 0;
+  auto compile = [&]() -> std::optional<std::string> {
+    ++num_compilations;
+    return "facts";
+  };
+  EXPECT_EQ(cache.GetOrCompile(test_dir_, "program", kRelationsToNotDeclare,
+                               compile),
+            "facts");
+  EXPECT_EQ(cache.GetOrCompile(test_dir_, "program", kRelationsToNotDeclare,
+                               compile),
+            "facts");
+  EXPECT_EQ(num_compilations, 1);
+  EXPECT_EQ(cache.stats().misses, 1);
+  EXPECT_EQ(cache.stats().hits, 1);
+
+  // Errors are not cached.
+  auto fail = []() -> std::optional<std::string> { return std::nullopt; };
+  EXPECT_EQ(cache.GetOrCompile(test_dir_, "program", "other", fail),
+            std::nullopt);
+  EXPECT_EQ(cache.GetOrCompile(test_dir_, "program", "other", compile),
+            "facts");
+  EXPECT_EQ(cache.stats().misses, 3);
+  EXPECT_EQ(cache.stats().uncacheable, 0);
+}
+
+TEST_F(AuthorizationLogicCacheTest, IgnoresMalformedEntries) {
+  AuthorizationLogicCache cache(cache_dir_, "v1");
+  ASSERT_TRUE(cache.Store("key", "facts"));
+  for (const auto &entry : std::filesystem::directory_iterator(cache_dir_)) {
+    std::ofstream(entry.path(), std::ios::out | std::ios::trunc) << "facts";
+  }
+  EXPECT_EQ(cache.Lookup("key"), std::nullopt);
+}
+
+TEST_F(AuthorizationLogicCacheTest, ReadersSeeWholeEntries) {
+  AuthorizationLogicCache cache(cache_dir_, "v1");
+  std::string facts(1 << 20, 'x');
+  std::vector<std::thread> threads;
+  std::atomic<int> num_partial_reads = 0;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 20; ++j) {
+        EXPECT_TRUE(cache.Store("key", facts));
+        std::optional<std::string> read = cache.Lookup("key");
+        if (!read.has_value() || *read != facts) ++num_partial_reads;
+      }
+    });
+  }
+  for (std::thread &thread : threads) thread.join();
+  EXPECT_EQ(num_partial_reads, 0);
+  // The temporary files are renamed into place.
+  EXPECT_EQ(std::distance(std::filesystem::directory_iterator(cache_dir_),
+                          std::filesystem::directory_iterator()),
+            1);
+}
+
+}  // namespace raksha::xform_to_datalog
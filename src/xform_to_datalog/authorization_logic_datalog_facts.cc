@@ -30,7 +30,8 @@ namespace raksha::xform_to_datalog {
 
 std::optional<AuthorizationLogicDatalogFacts>
 AuthorizationLogicDatalogFacts::create(
-  const std::filesystem::path &program_dir, absl::string_view program) {
+  const std::filesystem::path &program_dir, absl::string_view program,
+  AuthorizationLogicCache *cache) {
   auto result_dir = std::filesystem::temp_directory_path();
 
   // List of relations to not declare in the generated auth logic code
@@ -51,38 +52,49 @@ AuthorizationLogicDatalogFacts::create(
       "isTag",
       "isPrincipal"
   };
-  int res = generate_datalog_facts_from_authorization_logic(
-    program.data(), program_dir.c_str(), result_dir.c_str(),
-    absl::StrJoin(kRelationsToNotDeclare, ",").c_str());
-  if (res) {
-    LOG(ERROR) << "Failure running the authorization logic compiler.\n";
-    return std::nullopt;
-  }
-  // Read the file into a string.
-  std::filesystem::path result = result_dir / (absl::StrCat(program, ".dl"));
-  std::ifstream file_stream(result);
-  if (!file_stream) {
-    LOG(ERROR) << "Unable to read result of authorization logic compiler.\n";
-    return std::nullopt;
-  }
+  std::string relations_to_not_declare =
+      absl::StrJoin(kRelationsToNotDeclare, ",");
+  auto compile = [&]() -> std::optional<std::string> {
+    int res = generate_datalog_facts_from_authorization_logic(
+      program.data(), program_dir.c_str(), result_dir.c_str(),
+      relations_to_not_declare.c_str());
+    if (res) {
+      LOG(ERROR) << "Failure running the authorization logic compiler.\n";
+      return std::nullopt;
+    }
+    // Read the file into a string.
+    std::filesystem::path result = result_dir / (absl::StrCat(program, ".dl"));
+    std::ifstream file_stream(result);
+    if (!file_stream) {
+      LOG(ERROR) << "Unable to read result of authorization logic compiler.\n";
+      return std::nullopt;
+    }
 
-  // Determine file size.
-  file_stream.seekg(0, std::ios::end);
-  std::ifstream::pos_type filesize = file_stream.tellg();
-  if (filesize == -1) {
-    LOG(ERROR) << "Unable to determine the size of the result file.\n";
-    return std::nullopt;
-  }
-  // Initialize and set size of buffer to avoid reallocations.
-  std::string datalog_program(filesize, '\0');
+    // Determine file size.
+    file_stream.seekg(0, std::ios::end);
+    std::ifstream::pos_type filesize = file_stream.tellg();
+    if (filesize == -1) {
+      LOG(ERROR) << "Unable to determine the size of the result file.\n";
+      return std::nullopt;
+    }
+    // Initialize and set size of buffer to avoid reallocations.
+    std::string datalog_program(filesize, '\0');
 
-  // Read the contents of the file into string buffer.
-  file_stream.seekg(0, std::ios::beg);
-  file_stream.read(datalog_program.data(), datalog_program.size());
-  CHECK(file_stream.gcount() == filesize)
-    << "Failure reading bytes from the result file.\n";
+    // Read the contents of the file into string buffer.
+    file_stream.seekg(0, std::ios::beg);
+    file_stream.read(datalog_program.data(), datalog_program.size());
+    CHECK(file_stream.gcount() == filesize)
+      << "Failure reading bytes from the result file.\n";
+    return datalog_program;
+  };
 
-  return AuthorizationLogicDatalogFacts(datalog_program);
+  std::optional<std::string> datalog_program =
+      (cache == nullptr) ? compile()
+                         : cache->GetOrCompile(program_dir, program,
+                                               relations_to_not_declare,
+                                               compile);
+  if (!datalog_program.has_value()) return std::nullopt;
+  return AuthorizationLogicDatalogFacts(*std::move(datalog_program));
 }
 
 }  // namespace raksha::xform_to_datalog
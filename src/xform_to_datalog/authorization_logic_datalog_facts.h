@@ -21,6 +21,7 @@
 #include <string>
 
 #include "absl/strings/string_view.h"
+#include "src/xform_to_datalog/authorization_logic_cache.h"
 
 namespace raksha::xform_to_datalog {
 
@@ -28,10 +29,13 @@ class AuthorizationLogicDatalogFacts {
  public:
   // Creates the datalog logic facts from the given authorization logic program.
   // Returns std::nullopt if there is any error due to processing of the program.
+  // If `cache` is given, the facts are taken from it when the program and the
+  // files it refers to have been compiled before.
   //
   static std::optional<AuthorizationLogicDatalogFacts> create(
       const std::filesystem::path &path,
-      absl::string_view authorization_logic_filename);
+      absl::string_view authorization_logic_filename,
+      AuthorizationLogicCache *cache = nullptr);
 
   AuthorizationLogicDatalogFacts(std::string datalog_facts):
       datalog_facts_(std::move(datalog_facts)) {}
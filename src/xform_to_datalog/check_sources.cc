@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/check_sources.h"
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/datalog_print_context.h"
+
+namespace raksha::xform_to_datalog {
+
+namespace {
+
+// The number of fields of a CheckSource.
+constexpr size_t kNumFields = 7;
+
+// Keeps the fields of a source on one line of the text format.
+std::string ToField(absl::string_view value) {
+  return absl::StrReplaceAll(value, {{"\t", " "}, {"\n", " "}});
+}
+
+}  // namespace
+
+CheckSources::CheckSources(std::vector<CheckSource> sources)
+    : sources_(std::move(sources)) {
+  for (size_t i = 0; i < sources_.size(); ++i) {
+    index_by_label_.insert({sources_[i].label, i});
+  }
+}
+
+CheckSource CheckSources::GetCheckSource(
+    const ManifestDatalogFacts::Particle &particle, const ir::TagCheck &check,
+    ir::DatalogPrintContext &ctxt) {
+  ctxt.set_instantiation_map(&particle.instantiation_map());
+  // The particle and the handle connection are set below if known.
+  CheckSource source{.label = ctxt.GetUniqueCheckLabel(),
+                     .recipe = particle.recipe_name(),
+                     .particle = "",
+                     .particle_spec = particle.spec()->name(),
+                     .handle_connection = "",
+                     .access_path = check.access_path().ToDatalog(ctxt),
+                     .predicate = check.predicate().ToDatalogRuleBody(
+                         check.access_path(), ctxt)};
+  const ir::AccessPathRoot &root = check.access_path().root();
+  if (const auto *spec_root =
+          std::get_if<ir::HandleConnectionSpecAccessPathRoot>(
+              &root.GetRootVariant())) {
+    source.handle_connection = spec_root->handle_connection_spec_name();
+  }
+  auto find_result = particle.instantiation_map().find(root);
+  if (find_result != particle.instantiation_map().end()) {
+    if (const auto *instance_root =
+            std::get_if<ir::HandleConnectionAccessPathRoot>(
+                &find_result->second.GetRootVariant())) {
+      source.particle = instance_root->particle_name();
+    }
+  }
+  return source;
+}
+
+CheckSources CheckSources::Create(const ManifestDatalogFacts &manifest_facts) {
+  std::vector<CheckSource> sources;
+  ir::DatalogPrintContext ctxt;
+  for (const auto &particle : manifest_facts.particle_instances()) {
+    for (const ir::TagCheck &check : particle.spec()->checks()) {
+      sources.push_back(GetCheckSource(particle, check, ctxt));
+    }
+  }
+  return CheckSources(std::move(sources));
+}
+
+std::optional<CheckSources> CheckSources::Parse(absl::string_view text) {
+  std::vector<CheckSource> sources;
+  for (absl::string_view line : absl::StrSplit(text, '\n')) {
+    if (line.empty()) continue;
+    std::vector<std::string> fields = absl::StrSplit(line, '\t');
+    if (fields.size() != kNumFields) {
+      LOG(ERROR) << "Malformed check source: " << line;
+      return std::nullopt;
+    }
+    sources.push_back({.label = std::move(fields[0]),
+                       .recipe = std::move(fields[1]),
+                       .particle = std::move(fields[2]),
+                       .particle_spec = std::move(fields[3]),
+                       .handle_connection = std::move(fields[4]),
+                       .access_path = std::move(fields[5]),
+                       .predicate = std::move(fields[6])});
+  }
+  return CheckSources(std::move(sources));
+}
+
+const CheckSource *CheckSources::Find(absl::string_view label) const {
+  auto find_result = index_by_label_.find(label);
+  return (find_result == index_by_label_.end())
+             ? nullptr
+             : &sources_[find_result->second];
+}
+
+std::string CheckSources::ToText() const {
+  std::string result;
+  for (const CheckSource &source : sources_) {
+    absl::StrAppend(
+        &result,
+        absl::StrJoin({ToField(source.label), ToField(source.recipe),
+                       ToField(source.particle), ToField(source.particle_spec),
+                       ToField(source.handle_connection),
+                       ToField(source.access_path), ToField(source.predicate)},
+                      "\t"),
+        "\n");
+  }
+  return result;
+}
+
+}  // namespace raksha::xform_to_datalog
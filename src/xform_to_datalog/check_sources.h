@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+#ifndef SRC_XFORM_TO_DATALOG_CHECK_SOURCES_H_
+#define SRC_XFORM_TO_DATALOG_CHECK_SOURCES_H_
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+
+namespace raksha::xform_to_datalog {
+
+// Where a check that ManifestDatalogFacts::ToDatalog prints comes from. The
+// analysis only knows a check by its label, such as "check_num_3".
+struct CheckSource {
+  std::string label;
+  std::string recipe;
+  // The name of the particle in the recipe, such as "P#2".
+  std::string particle;
+  std::string particle_spec;
+  std::string handle_connection;
+  // The checked access path, as in the isCheck fact.
+  std::string access_path;
+  // The predicate of the check as the body of its check rule.
+  std::string predicate;
+
+  bool operator==(const CheckSource &other) const {
+    return label == other.label && recipe == other.recipe &&
+           particle == other.particle &&
+           particle_spec == other.particle_spec &&
+           handle_connection == other.handle_connection &&
+           access_path == other.access_path && predicate == other.predicate;
+  }
+};
+
+// The sources of the checks of a manifest, for mapping the labels in the
+// results of the analysis back to the particles and checks they stand for.
+class CheckSources {
+ public:
+  // Labels the checks as ToDatalog does with a fresh DatalogPrintContext.
+  static CheckSources Create(const ManifestDatalogFacts &manifest_facts);
+
+  // Returns the source of `check` of `particle`, labeled with the next check
+  // label of `ctxt`. This sets the instantiation map of `ctxt`.
+  static CheckSource GetCheckSource(
+      const ManifestDatalogFacts::Particle &particle,
+      const ir::TagCheck &check, ir::DatalogPrintContext &ctxt);
+
+  // Recreates CheckSources from the output of `ToText`. Returns std::nullopt
+  // if `text` is malformed.
+  static std::optional<CheckSources> Parse(absl::string_view text);
+
+  explicit CheckSources(std::vector<CheckSource> sources);
+
+  // Returns the source of the check with `label`, or nullptr if there is
+  // none.
+  const CheckSource *Find(absl::string_view label) const;
+
+  // Returns the sources as text, with one tab-separated line per check in
+  // the order of the fields of CheckSource.
+  std::string ToText() const;
+
+  const std::vector<CheckSource> &sources() const { return sources_; }
+
+ private:
+  std::vector<CheckSource> sources_;
+  // The index of the source of each label in sources_.
+  absl::flat_hash_map<std::string, size_t> index_by_label_;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_CHECK_SOURCES_H_
@@ -0,0 +1,113 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/check_sources.h"
+
+#include <google/protobuf/text_format.h>
+
+#include "absl/strings/str_cat.h"
+#include "src/common/testing/gtest.h"
+#include "src/ir/datalog_print_context.h"
+#include "src/ir/proto/system_spec.h"
+
+namespace raksha::xform_to_datalog {
+
+// A Source particle claims a tag on its output, which two Sink particles
+// check on their inputs.
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Source" connections: [
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: { particle_spec: "Source", handle_connection: "out" } }
+            predicate: { label: { semantic_tag: "tag"} } } } ] },
+    { name: "Sink" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } } ]
+      checks: [
+        { access_path: {
+            handle: { particle_spec: "Sink", handle_connection: "in" } }
+          predicate: { label: { semantic_tag: "tag"} } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Source" connections: [
+              { name: "out" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } } ] } ] } ]
+)";
+
+class CheckSourcesTest : public testing::Test {
+ public:
+  CheckSourcesTest() {
+    arcs::ManifestProto manifest_proto;
+    CHECK(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                        &manifest_proto));
+    system_spec_ = ir::proto::Decode(manifest_proto);
+    CHECK(system_spec_ != nullptr);
+    manifest_facts_ = ManifestDatalogFacts::CreateFromManifestProto(
+        *system_spec_, manifest_proto);
+  }
+
+ protected:
+  std::unique_ptr<ir::SystemSpec> system_spec_;
+  ManifestDatalogFacts manifest_facts_;
+};
+
+TEST_F(CheckSourcesTest, MapsLabelsToParticlesAndPredicates) {
+  CheckSources check_sources = CheckSources::Create(manifest_facts_);
+  ASSERT_EQ(check_sources.sources().size(), 2);
+  const CheckSource *source = check_sources.Find("check_num_1");
+  ASSERT_NE(source, nullptr);
+  EXPECT_EQ(source->recipe, "R");
+  EXPECT_EQ(source->particle, "Sink#2");
+  EXPECT_EQ(source->particle_spec, "Sink");
+  EXPECT_EQ(source->handle_connection, "in");
+  EXPECT_EQ(source->access_path, "R.Sink#2.in");
+  EXPECT_THAT(source->predicate, testing::HasSubstr("\"tag\""));
+  EXPECT_EQ(check_sources.Find("check_num_2"), nullptr);
+}
+
+TEST_F(CheckSourcesTest, LabelsMatchThoseOfToDatalog) {
+  ir::DatalogPrintContext ctxt;
+  std::string datalog = manifest_facts_.ToDatalog(ctxt);
+  CheckSources check_sources = CheckSources::Create(manifest_facts_);
+  for (const CheckSource &source : check_sources.sources()) {
+    EXPECT_THAT(datalog,
+                testing::HasSubstr(absl::StrCat("isCheck(\"", source.label,
+                                                "\", \"", source.access_path,
+                                                "\")")));
+  }
+}
+
+TEST_F(CheckSourcesTest, ParseOfToTextIsIdentity) {
+  CheckSources check_sources = CheckSources::Create(manifest_facts_);
+  std::optional<CheckSources> parsed =
+      CheckSources::Parse(check_sources.ToText());
+  ASSERT_TRUE(parsed.has_value());
+  EXPECT_EQ(parsed->sources(), check_sources.sources());
+  EXPECT_NE(parsed->Find("check_num_0"), nullptr);
+}
+
+TEST(CheckSourcesParseTest, RejectsMalformedLines) {
+  EXPECT_EQ(CheckSources::Parse("check_num_0\tR\n"), std::nullopt);
+  EXPECT_THAT(CheckSources::Parse("")->sources(), testing::IsEmpty());
+}
+
+}  // namespace raksha::xform_to_datalog
@@ -0,0 +1,89 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+// Tool that compiles the facts of a manifest proto into a policy bundle,
+// which generate_datalog_program maps with --policy_bundle instead of
+// parsing and instantiating the manifest again on every run.
+
+#include <filesystem>
+#include <fstream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "src/xform_to_datalog/policy_bundle.h"
+
+ABSL_FLAG(std::string, manifest_proto, "", "The manifest proto file.");
+ABSL_FLAG(std::string, policy_bundle, "", "The policy bundle file to write.");
+ABSL_FLAG(bool, midpoint_default_derivation, false,
+          "Route the default dataflow of each particle through a single "
+          "midpoint access path instead of drawing an edge from every input "
+          "to every output.");
+
+constexpr char kUsageMessage[] =
+    "This tool compiles the claims, checks and edges of a manifest proto "
+    "into a policy bundle for generate_datalog_program.";
+
+using PolicyBundle = raksha::xform_to_datalog::PolicyBundle;
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("compile_policy_bundle");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::filesystem::path manifest_filepath(absl::GetFlag(FLAGS_manifest_proto));
+  std::unique_ptr<raksha::ir::proto::ManifestFile> manifest_file =
+      raksha::ir::proto::ManifestFile::Load(manifest_filepath);
+  if (manifest_file == nullptr) return 1;
+
+  const raksha::ir::ParticleSpec::DefaultDerivationMode
+      default_derivation_mode =
+          absl::GetFlag(FLAGS_midpoint_default_derivation)
+              ? raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint
+              : raksha::ir::ParticleSpec::DefaultDerivationMode::kCartesian;
+  std::unique_ptr<raksha::ir::SystemSpec> system_spec =
+      raksha::ir::proto::Decode(manifest_file->manifest_proto(),
+                                default_derivation_mode);
+  CHECK(system_spec != nullptr);
+  raksha::xform_to_datalog::ManifestDatalogFacts manifest_datalog_facts =
+      raksha::xform_to_datalog::ManifestDatalogFacts::CreateFromManifestProto(
+          *system_spec, manifest_file->manifest_proto());
+  raksha::xform_to_datalog::ManifestDatalogFacts::DuplicateCounts
+      num_duplicates = manifest_datalog_facts.GetNumDuplicates();
+  LOG(INFO) << "Dropped " << num_duplicates.tag_claims << " duplicate claims, "
+            << num_duplicates.checks << " duplicate checks and "
+            << num_duplicates.edges << " duplicate edges.";
+
+  std::string policy_bundle =
+      PolicyBundle::Compile(manifest_datalog_facts, default_derivation_mode);
+
+  std::filesystem::path policy_bundle_filepath(
+      absl::GetFlag(FLAGS_policy_bundle));
+  std::ofstream policy_bundle_file(
+      policy_bundle_filepath,
+      std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!policy_bundle_file ||
+      !policy_bundle_file.write(policy_bundle.data(), policy_bundle.size())) {
+    LOG(ERROR) << "Error writing " << policy_bundle_filepath << " :"
+               << strerror(errno);
+    return 1;
+  }
+  return 0;
+}
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "absl/strings/str_format.h"
+#include "absl/strings/str_split.h"
 #include "src/ir/datalog_print_context.h"
 #include "src/ir/edge.h"
 #include "src/ir/tag_check.h"
@@ -40,12 +41,24 @@ class DatalogFacts {
       auth_logic_datalog_facts_(std::move(auth_logic_datalog_facts))
   {}
 
-  // Returns the datalog program with necessary headers.
-  std::string ToDatalog(raksha::ir::DatalogPrintContext &ctxt) const {
-    return absl::StrFormat(
-        kDatalogFileFormat,
-        manifest_datalog_facts_.ToDatalog(ctxt),
-        auth_logic_datalog_facts_.ToDatalog());
+  // Returns the datalog program with necessary headers. If
+  // `manifest_section_sizes` is given, it is set to the sizes of the sections
+  // of the manifest facts.
+  std::string ToDatalog(
+      raksha::ir::DatalogPrintContext &ctxt,
+      ManifestDatalogFacts::SectionSizes *manifest_section_sizes =
+          nullptr) const {
+    std::string manifest_datalog = manifest_datalog_facts_.ToDatalog(
+        ctxt, /*separator=*/"\n", manifest_section_sizes);
+    return absl::StrFormat(kDatalogFileFormat, manifest_datalog,
+                           auth_logic_datalog_facts_.ToDatalog());
+  }
+
+  // Returns the text of the datalog program before the manifest facts,
+  // between them and the authorization logic facts, and after those, for
+  // writing the program piece by piece.
+  static std::vector<absl::string_view> GetFileFormatPieces() {
+    return absl::StrSplit(kDatalogFileFormat, "%s");
   }
 
  private:
@@ -70,11 +83,15 @@ class DatalogFacts {
 
 .decl isCheck(check_index: symbol, path: AccessPath)
 .decl check(check_index: symbol, owner: Principal, path: AccessPath)
+.decl checkFailure(check_index: symbol, owner: Principal, path: AccessPath)
+.output checkFailure(IO=stdout)
 
 allTests(check_index) :- isCheck(check_index, _).
-testFails(cat(check_index, "-", owner, "-", path)) :-
+checkFailure(check_index, owner, path) :-
   isCheck(check_index, path), ownsAccessPath(owner, path),
   !check(check_index, owner, path).
+testFails(cat(check_index, "-", owner, "-", path)) :-
+  checkFailure(check_index, owner, path).
 
 testFails("may_will") :- disallowedUsage(_, _, _, _).
 
@@ -72,11 +72,15 @@ INSTANTIATE_TEST_SUITE_P(
 
 .decl isCheck(check_index: symbol, path: AccessPath)
 .decl check(check_index: symbol, owner: Principal, path: AccessPath)
+.decl checkFailure(check_index: symbol, owner: Principal, path: AccessPath)
+.output checkFailure(IO=stdout)
 
 allTests(check_index) :- isCheck(check_index, _).
-testFails(cat(check_index, "-", owner, "-", path)) :-
+checkFailure(check_index, owner, path) :-
   isCheck(check_index, path), ownsAccessPath(owner, path),
   !check(check_index, owner, path).
+testFails(cat(check_index, "-", owner, "-", path)) :-
+  checkFailure(check_index, owner, path).
 
 testFails("may_will") :- disallowedUsage(_, _, _, _).
 
@@ -119,11 +123,15 @@ grounded_dummy("dummy_var").
 
 .decl isCheck(check_index: symbol, path: AccessPath)
 .decl check(check_index: symbol, owner: Principal, path: AccessPath)
+.decl checkFailure(check_index: symbol, owner: Principal, path: AccessPath)
+.output checkFailure(IO=stdout)
 
 allTests(check_index) :- isCheck(check_index, _).
-testFails(cat(check_index, "-", owner, "-", path)) :-
+checkFailure(check_index, owner, path) :-
   isCheck(check_index, path), ownsAccessPath(owner, path),
   !check(check_index, owner, path).
+testFails(cat(check_index, "-", owner, "-", path)) :-
+  checkFailure(check_index, owner, path).
 
 testFails("may_will") :- disallowedUsage(_, _, _, _).
 
@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Tool that explains how tags may reach the access path of a failed check,
+// by printing the shortest chain of edges from a claim of each tag to it.
+//
+// Example:
+//   bazel run //src/xform_to_datalog:explain_witness_path --
+//     --manifest_proto=<manifest proto> --access_path=R.Sink#2.in
+//     --tags=tag0,tag1
+
+#include <filesystem>
+#include <iostream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/ir/system_spec.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "src/xform_to_datalog/witness_path.h"
+
+ABSL_FLAG(std::string, manifest_proto, "", "The manifest proto file.");
+ABSL_FLAG(bool, midpoint_default_derivation, false,
+          "Explain the graph generate_datalog_program draws with "
+          "--midpoint_default_derivation.");
+ABSL_FLAG(std::string, access_path, "",
+          "The access path of the failed check, as in its isCheck fact or "
+          "the access path of its failure.");
+ABSL_FLAG(std::vector<std::string>, tags, {},
+          "The tags to explain, such as those of the predicate of the check.");
+ABSL_FLAG(uint64_t, max_edges, 1000, "The most edges of a witness path.");
+ABSL_FLAG(uint64_t, max_visited, 1000000,
+          "The most access paths to visit per tag before giving up.");
+
+constexpr char kUsageMessage[] =
+    "This tool takes a manifest proto, an access path and tags and prints "
+    "the shortest chain of dataflow edges along which each tag may reach "
+    "the access path from a claim, without passing a claim that removes it.";
+
+using raksha::xform_to_datalog::ManifestDatalogFacts;
+using raksha::xform_to_datalog::WitnessPath;
+using raksha::xform_to_datalog::WitnessPathExplainer;
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("explain_witness_path");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::filesystem::path manifest_filepath(absl::GetFlag(FLAGS_manifest_proto));
+  std::unique_ptr<raksha::ir::proto::ManifestFile> manifest_file =
+      raksha::ir::proto::ManifestFile::Load(manifest_filepath);
+  if (manifest_file == nullptr) return 1;
+  const arcs::ManifestProto &manifest_proto = manifest_file->manifest_proto();
+
+  std::unique_ptr<raksha::ir::SystemSpec> system_spec =
+      raksha::ir::proto::Decode(
+          manifest_proto,
+          absl::GetFlag(FLAGS_midpoint_default_derivation)
+              ? raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint
+              : raksha::ir::ParticleSpec::DefaultDerivationMode::kCartesian);
+  CHECK(system_spec != nullptr);
+  WitnessPathExplainer explainer = WitnessPathExplainer::Create(
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec,
+                                                    manifest_proto));
+
+  raksha::xform_to_datalog::WitnessSearchLimits limits{
+      .max_edges = absl::GetFlag(FLAGS_max_edges),
+      .max_visited = absl::GetFlag(FLAGS_max_visited)};
+  std::string access_path = absl::GetFlag(FLAGS_access_path);
+  for (const std::string &tag : absl::GetFlag(FLAGS_tags)) {
+    std::optional<WitnessPath> path =
+        explainer.Explain(access_path, tag, limits);
+    if (path.has_value()) {
+      std::cout << path->ToString();
+    } else {
+      std::cout << tag << " does not reach " << access_path
+                << " within the limits\n";
+    }
+  }
+  return 0;
+}
@@ -16,34 +16,213 @@
 //
 // Tool that takes a manifest proto and generates corresponding datalog facts.
 
+#include <unistd.h>
+
 #include <filesystem>
 #include <fstream>
+#include <future>
 #include <iostream>
+#include <optional>
 
 #include "absl/flags/flag.h"
 #include "absl/flags/parse.h"
 #include "absl/flags/usage.h"
+#include "absl/strings/str_cat.h"
 #include "src/common/logging/logging.h"
 #include "src/ir/datalog_print_context.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/manifest_stream.h"
 #include "src/ir/proto/system_spec.h"
 #include "src/ir/system_spec.h"
+#include "src/utils/phase_stats.h"
+#include "src/xform_to_datalog/authorization_logic_cache.h"
 #include "src/xform_to_datalog/authorization_logic_datalog_facts.h"
+#include "src/xform_to_datalog/check_sources.h"
 #include "src/xform_to_datalog/datalog_facts.h"
 #include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "src/xform_to_datalog/policy_bundle.h"
+#include "src/xform_to_datalog/streaming_datalog_writer.h"
 
 ABSL_FLAG(std::string, datalog_file, "", "output file for the datalog facts");
 ABSL_FLAG(std::string, manifest_proto, "", "The manifest proto file.");
+ABSL_FLAG(std::string, manifest_stream, "",
+          "A manifest stream file, as written by write_manifest_stream, to "
+          "read instead of --manifest_proto. Its recipes are processed one at "
+          "a time, so memory is bounded by the largest recipe rather than "
+          "the whole manifest.");
+ABSL_FLAG(std::string, policy_bundle, "",
+          "A policy bundle file, as written by compile_policy_bundle, to map "
+          "instead of reading --manifest_proto. Its facts are printed as they "
+          "were compiled, without decoding or instantiating the manifest.");
 ABSL_FLAG(std::string, auth_logic_file, "",
           "The file with authorization logic facts.");
+ABSL_FLAG(std::string, auth_logic_cache_dir, "",
+          "If set, cache the datalog generated from the authorization logic "
+          "in this directory, keyed by a digest of the authorization logic "
+          "and the files it imports, and reuse it while they are unchanged.");
 ABSL_FLAG(bool, overwrite, false,
           "Should we overwrite the output file if it exists.");
+ABSL_FLAG(bool, midpoint_default_derivation, false,
+          "Route the default dataflow of each particle through a single "
+          "midpoint access path instead of drawing an edge from every input "
+          "to every output.");
+ABSL_FLAG(std::string, check_sources_file, "",
+          "If set, write the recipe, particle, handle connection and "
+          "predicate of each check label to this file, for mapping the "
+          "failures reported by the analysis back to the manifest.");
+
+ABSL_FLAG(std::string, stats, "",
+          "If set, write a JSON report with the wall time, CPU time, "
+          "allocations and peak memory of each phase and the sizes of the "
+          "sections of the output to this file.");
+ABSL_FLAG(std::string, trace, "",
+          "If set, write the phases as a Chrome trace-event file, for viewing "
+          "in chrome://tracing or Perfetto, to this file.");
 
 constexpr char kUsageMessage[] =
     "This tool takes a manifest proto and generates a datalog program.";
 
 using ManifestDatalogFacts = raksha::xform_to_datalog::ManifestDatalogFacts;
+using AuthorizationLogicCache =
+    raksha::xform_to_datalog::AuthorizationLogicCache;
 using AuthorizationLogicDatalogFacts =
     raksha::xform_to_datalog::AuthorizationLogicDatalogFacts;
+using DatalogFacts = raksha::xform_to_datalog::DatalogFacts;
+using PhaseStats = raksha::utils::PhaseStats;
+using PolicyBundle = raksha::xform_to_datalog::PolicyBundle;
+using StreamingDatalogWriter =
+    raksha::xform_to_datalog::StreamingDatalogWriter;
+
+// Writes `contents` to the file at `path`, unless `path` is empty.
+static bool WriteReport(const std::filesystem::path &path,
+                        absl::string_view contents) {
+  if (path.empty()) return true;
+  std::ofstream report_file(path,
+                            std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!report_file) {
+    LOG(ERROR) << "Error creating " << path << " :" << strerror(errno);
+    return false;
+  }
+  report_file << contents;
+  return true;
+}
+
+// The file the datalog program is written to, next to the output file, which
+// it replaces only once the program is complete. Otherwise it is removed, so
+// that a failed run neither leaves a truncated output file nor keeps the
+// next run without --overwrite from writing one.
+class TemporaryDatalogFile {
+ public:
+  explicit TemporaryDatalogFile(std::filesystem::path output_path)
+      : output_path_(std::move(output_path)),
+        path_(absl::StrCat(output_path_.string(), ".tmp.", getpid())) {}
+
+  ~TemporaryDatalogFile() {
+    if (committed_) return;
+    std::error_code error;
+    std::filesystem::remove(path_, error);
+  }
+
+  TemporaryDatalogFile(const TemporaryDatalogFile &) = delete;
+  TemporaryDatalogFile &operator=(const TemporaryDatalogFile &) = delete;
+
+  const std::filesystem::path &path() const { return path_; }
+
+  // Renames the file to the output file. Returns false on errors.
+  bool Commit() {
+    std::error_code error;
+    std::filesystem::rename(path_, output_path_, error);
+    if (error) {
+      LOG(ERROR) << "Error renaming " << path_ << " to " << output_path_
+                 << ": " << error.message();
+      return false;
+    }
+    committed_ = true;
+    return true;
+  }
+
+ private:
+  std::filesystem::path output_path_;
+  std::filesystem::path path_;
+  bool committed_ = false;
+};
+
+// The authorization logic facts, compiled concurrently with the decoding and
+// rendering of the manifest. They are empty if compilation failed.
+using AuthLogicFuture =
+    std::shared_future<std::optional<AuthorizationLogicDatalogFacts>>;
+
+// Waits for the authorization logic facts. Returns nullptr if they could not
+// be compiled.
+static const AuthorizationLogicDatalogFacts *WaitForAuthLogic(
+    const AuthLogicFuture &auth_logic_datalog_facts,
+    PhaseStats &phase_stats) {
+  PhaseStats::ScopedPhase phase(phase_stats, "wait_auth_logic");
+  const std::optional<AuthorizationLogicDatalogFacts> &facts =
+      auth_logic_datalog_facts.get();
+  if (!facts.has_value()) {
+    LOG(ERROR) << "Unable to parse authorization logic file.\n";
+    return nullptr;
+  }
+  return &*facts;
+}
+
+// Generates the datalog program of the manifest stream at `filepath` one
+// recipe at a time, so that only the SystemSpec and the current recipe are in
+// memory, and writes it to `datalog_file`. The recipes are written while the
+// authorization logic facts are compiled, which are only waited for to end
+// the program. Sets `section_sizes` and `num_duplicates` to the totals over
+// the recipes. Returns false on errors.
+static bool StreamDatalogProgram(
+    const std::filesystem::path &filepath,
+    raksha::ir::ParticleSpec::DefaultDerivationMode default_derivation_mode,
+    const AuthLogicFuture &auth_logic_datalog_facts,
+    raksha::ir::DatalogPrintContext &ctxt, std::ofstream &datalog_file,
+    PhaseStats &phase_stats, ManifestDatalogFacts::SectionSizes &section_sizes,
+    ManifestDatalogFacts::DuplicateCounts &num_duplicates) {
+  std::ifstream manifest_stream(filepath, std::ios::in | std::ios::binary);
+  if (!manifest_stream) {
+    LOG(ERROR) << "Error reading manifest stream " << filepath << ":"
+               << strerror(errno);
+    return false;
+  }
+  std::unique_ptr<raksha::ir::proto::ManifestStreamReader> reader;
+  {
+    PhaseStats::ScopedPhase phase(phase_stats, "parse_particle_specs");
+    reader = raksha::ir::proto::ManifestStreamReader::Create(manifest_stream);
+  }
+  if (reader == nullptr) return false;
+  std::unique_ptr<raksha::ir::SystemSpec> system_spec;
+  {
+    PhaseStats::ScopedPhase phase(phase_stats, "decode_system_spec");
+    system_spec = raksha::ir::proto::Decode(reader->particle_specs(),
+                                            default_derivation_mode);
+  }
+  CHECK(system_spec != nullptr);
+
+  StreamingDatalogWriter writer(*system_spec, ctxt, datalog_file);
+  {
+    PhaseStats::ScopedPhase phase(phase_stats, "stream_recipes");
+    arcs::RecipeProto recipe_proto;
+    while (reader->ReadRecipe(recipe_proto)) writer.WriteRecipe(recipe_proto);
+  }
+  if (reader->failed()) return false;
+  datalog_file.flush();
+  const AuthorizationLogicDatalogFacts *auth_logic =
+      WaitForAuthLogic(auth_logic_datalog_facts, phase_stats);
+  if (auth_logic == nullptr) return false;
+  {
+    PhaseStats::ScopedPhase phase(phase_stats, "write_datalog");
+    writer.Finish(*auth_logic);
+    datalog_file.flush();
+  }
+  section_sizes = writer.section_sizes();
+  num_duplicates = writer.num_duplicates();
+  LOG(INFO) << "Streamed " << writer.num_recipes()
+            << " recipes with at most " << writer.max_recipe_particles()
+            << " particles each.";
+  return true;
+}
 
 int main(int argc, char *argv[]) {
   google::InitGoogleLogging("generate_datalog_program");
@@ -52,9 +231,27 @@ int main(int argc, char *argv[]) {
 
   // Verify command line arguments
   std::filesystem::path manifest_filepath(absl::GetFlag(FLAGS_manifest_proto));
-  if (!std::filesystem::exists(manifest_filepath)) {
-    LOG(ERROR) << "Manifest proto file " << manifest_filepath
-               << " does not exist!";
+  std::filesystem::path manifest_stream_filepath(
+      absl::GetFlag(FLAGS_manifest_stream));
+  std::filesystem::path policy_bundle_filepath(
+      absl::GetFlag(FLAGS_policy_bundle));
+  bool streaming = !manifest_stream_filepath.empty();
+  bool bundled = !policy_bundle_filepath.empty();
+  if (!manifest_filepath.empty() + streaming + bundled != 1) {
+    LOG(ERROR) << "Exactly one of --manifest_proto, --manifest_stream and "
+                  "--policy_bundle must be given!";
+    return 1;
+  }
+  if (streaming && !absl::GetFlag(FLAGS_check_sources_file).empty()) {
+    LOG(ERROR) << "--check_sources_file needs the whole manifest and cannot "
+                  "be used with --manifest_stream!";
+    return 1;
+  }
+  const std::filesystem::path &input_filepath =
+      streaming ? manifest_stream_filepath
+                : (bundled ? policy_bundle_filepath : manifest_filepath);
+  if (!std::filesystem::exists(input_filepath)) {
+    LOG(ERROR) << "Manifest file " << input_filepath << " does not exist!";
     return 1;
   }
 
@@ -74,51 +271,183 @@ int main(int argc, char *argv[]) {
     return 1;
   }
 
-  // Parse manifest stream and dump as datalog program.
-  std::ifstream manifest_proto_stream(manifest_filepath);
-  if (!manifest_proto_stream) {
-    LOG(ERROR) << "Error reading manifest proto file " << manifest_filepath
-               << ":" << strerror(errno);
-    return 1;
+  PhaseStats phase_stats;
+
+  // Compile the authorization logic on its own thread while the manifest is
+  // decoded and rendered. Its facts are only needed after those of the
+  // manifest, and waiting for them is the wait_auth_logic phase.
+  std::filesystem::path auth_logic_filename = auth_logic_filepath.filename();
+  auth_logic_filepath.remove_filename();
+  std::optional<AuthorizationLogicCache> auth_logic_cache;
+  if (!absl::GetFlag(FLAGS_auth_logic_cache_dir).empty()) {
+    auth_logic_cache.emplace(absl::GetFlag(FLAGS_auth_logic_cache_dir));
   }
+  AuthLogicFuture auth_logic_datalog_facts =
+      std::async(std::launch::async, [&] {
+        // The allocations of the Rust compiler are not counted in this
+        // phase (see phase_stats.h).
+        PhaseStats::ScopedPhase phase(phase_stats, "compile_auth_logic");
+        return AuthorizationLogicDatalogFacts::create(
+            auth_logic_filepath.c_str(), auth_logic_filename.c_str(),
+            auth_logic_cache.has_value() ? &*auth_logic_cache : nullptr);
+      }).share();
 
-  arcs::ManifestProto manifest_proto;
-  if (!manifest_proto.ParseFromIstream(&manifest_proto_stream)) {
-    LOG(ERROR) << "Error parsing the manifest proto " << manifest_filepath;
+  TemporaryDatalogFile temporary_datalog_file(datalog_filepath);
+  std::ofstream datalog_file(
+      temporary_datalog_file.path(),
+      std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!datalog_file) {
+    LOG(ERROR) << "Error creating " << temporary_datalog_file.path() << " :"
+               << strerror(errno);
+    return 1;
   }
 
-  // Turn each ParticleSpecProto indicated in the manifest_proto into a
+  // Turn each ParticleSpecProto indicated in the manifest into a
   // ParticleSpec object, which we can use directly.
-  std::unique_ptr<raksha::ir::SystemSpec> system_spec =
-      raksha::ir::proto::Decode(manifest_proto);
-  CHECK(system_spec != nullptr);
-  auto manifest_datalog_facts = ManifestDatalogFacts::CreateFromManifestProto(
-      *system_spec, manifest_proto);
+  const raksha::ir::ParticleSpec::DefaultDerivationMode
+      default_derivation_mode =
+          absl::GetFlag(FLAGS_midpoint_default_derivation)
+              ? raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint
+              : raksha::ir::ParticleSpec::DefaultDerivationMode::kCartesian;
+  std::unique_ptr<raksha::ir::SystemSpec> system_spec;
+  std::optional<ManifestDatalogFacts> manifest_datalog_facts;
+  std::unique_ptr<PolicyBundle> policy_bundle;
+  std::vector<absl::string_view> file_format_pieces =
+      DatalogFacts::GetFileFormatPieces();
+  CHECK_EQ(file_format_pieces.size(), 3);
+  if (!streaming) {
+    // The header does not depend on the manifest, so it is written before
+    // the manifest is read.
+    datalog_file << file_format_pieces[0];
+    datalog_file.flush();
+  }
+  if (bundled) {
+    {
+      PhaseStats::ScopedPhase phase(phase_stats, "map_policy_bundle");
+      policy_bundle = PolicyBundle::Load(policy_bundle_filepath);
+    }
+    if (policy_bundle == nullptr) return 1;
+    if (policy_bundle->default_derivation_mode() != default_derivation_mode) {
+      bool bundle_uses_midpoint =
+          policy_bundle->default_derivation_mode() ==
+          raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint;
+      LOG(ERROR) << "The policy bundle " << policy_bundle_filepath
+                 << " was compiled "
+                 << (bundle_uses_midpoint ? "with" : "without")
+                 << " --midpoint_default_derivation, but it was "
+                 << (bundle_uses_midpoint ? "not given" : "given")
+                 << " here!";
+      return 1;
+    }
+  } else if (!streaming) {
+    // Map and parse the manifest proto file.
+    std::unique_ptr<raksha::ir::proto::ManifestFile> manifest_file;
+    {
+      PhaseStats::ScopedPhase phase(phase_stats, "parse_manifest_proto");
+      manifest_file = raksha::ir::proto::ManifestFile::Load(manifest_filepath);
+    }
+    if (manifest_file == nullptr) return 1;
+    const arcs::ManifestProto &manifest_proto = manifest_file->manifest_proto();
 
-  std::filesystem::path auth_logic_filename = auth_logic_filepath.filename();
-  auth_logic_filepath.remove_filename();
-  std::optional<AuthorizationLogicDatalogFacts> auth_logic_datalog_facts =
-      AuthorizationLogicDatalogFacts::create(auth_logic_filepath.c_str(),
-                                             auth_logic_filename.c_str());
+    {
+      PhaseStats::ScopedPhase phase(phase_stats, "decode_system_spec");
+      system_spec =
+          raksha::ir::proto::Decode(manifest_proto, default_derivation_mode);
+    }
+    CHECK(system_spec != nullptr);
+    {
+      PhaseStats::ScopedPhase phase(phase_stats, "create_manifest_facts");
+      manifest_datalog_facts = ManifestDatalogFacts::CreateFromManifestProto(
+          *system_spec, manifest_proto);
+    }
+  }
 
-  if (!auth_logic_datalog_facts.has_value()) {
-    LOG(ERROR) << "Unable to parse authorization logic file.\n";
+  raksha::ir::DatalogPrintContext ctxt;
+  ManifestDatalogFacts::SectionSizes section_sizes;
+  // The duplicates dropped from the facts of the manifest. Those of a policy
+  // bundle were dropped when it was compiled.
+  std::optional<ManifestDatalogFacts::DuplicateCounts> num_duplicates;
+  const AuthorizationLogicDatalogFacts *auth_logic = nullptr;
+  if (streaming) {
+    if (!StreamDatalogProgram(manifest_stream_filepath, default_derivation_mode,
+                              auth_logic_datalog_facts, ctxt, datalog_file,
+                              phase_stats, section_sizes,
+                              num_duplicates.emplace())) {
+      return 1;
+    }
+    auth_logic = &*auth_logic_datalog_facts.get();
+  } else {
+    if (!bundled) {
+      num_duplicates = manifest_datalog_facts->GetNumDuplicates();
+    }
+    // The manifest facts are written before the authorization logic facts
+    // are waited for. They are written to the file as they are printed, one
+    // particle or fact at a time, rather than collected in a string first.
+    {
+      PhaseStats::ScopedPhase phase(phase_stats, "write_manifest_datalog");
+      if (bundled) {
+        policy_bundle->WriteDatalog(ctxt, datalog_file, /*separator=*/"\n",
+                                    &section_sizes);
+      } else {
+        manifest_datalog_facts->WriteDatalog(ctxt, datalog_file,
+                                             /*separator=*/"\n",
+                                             &section_sizes);
+      }
+      datalog_file.flush();
+    }
+    auth_logic = WaitForAuthLogic(auth_logic_datalog_facts, phase_stats);
+    if (auth_logic == nullptr) return 1;
+    {
+      PhaseStats::ScopedPhase phase(phase_stats, "write_datalog");
+      datalog_file << file_format_pieces[1]
+                   << auth_logic->ToDatalog()
+                   << file_format_pieces[2];
+      datalog_file.flush();
+    }
+  }
+  uint64_t datalog_file_size = datalog_file.tellp();
+  datalog_file.close();
+  if (!datalog_file) {
+    LOG(ERROR) << "Error writing " << temporary_datalog_file.path();
     return 1;
   }
+  if (!temporary_datalog_file.Commit()) return 1;
 
-  auto datalog_facts = raksha::xform_to_datalog::DatalogFacts(
-      manifest_datalog_facts, *auth_logic_datalog_facts);
+  if (num_duplicates.has_value()) {
+    phase_stats.AddCounter("duplicate_claims", num_duplicates->tag_claims);
+    phase_stats.AddCounter("duplicate_checks", num_duplicates->checks);
+    phase_stats.AddCounter("duplicate_edges", num_duplicates->edges);
+  }
+  if (auth_logic_cache.has_value()) {
+    const AuthorizationLogicCache::Stats &cache_stats =
+        auth_logic_cache->stats();
+    phase_stats.AddCounter("auth_logic_cache_hits", cache_stats.hits);
+    phase_stats.AddCounter("auth_logic_cache_misses", cache_stats.misses);
+    phase_stats.AddCounter("auth_logic_cache_uncacheable",
+                           cache_stats.uncacheable);
+  }
+  phase_stats.AddOutputSize("claims", section_sizes.claims);
+  phase_stats.AddOutputSize("checks", section_sizes.checks);
+  phase_stats.AddOutputSize("edges", section_sizes.edges);
+  phase_stats.AddOutputSize("auth_logic_facts",
+                            auth_logic->ToDatalog().size());
+  phase_stats.AddOutputSize("datalog_file", datalog_file_size);
 
-  std::ofstream datalog_file(datalog_filepath, std::ios::out | std::ios::trunc |
-                                                   std::ios::binary);
-  if (!datalog_file) {
-    LOG(ERROR) << "Error creating " << datalog_filepath << " :"
-               << strerror(errno);
+  std::filesystem::path check_sources_filepath(
+      absl::GetFlag(FLAGS_check_sources_file));
+  if (!check_sources_filepath.empty() &&
+      !WriteReport(check_sources_filepath,
+                   (bundled ? policy_bundle->GetCheckSources()
+                            : raksha::xform_to_datalog::CheckSources::Create(
+                                  *manifest_datalog_facts))
+                       .ToText())) {
     return 1;
   }
 
-  raksha::ir::DatalogPrintContext ctxt;
-  datalog_file << datalog_facts.ToDatalog(ctxt);
+  if (!WriteReport(absl::GetFlag(FLAGS_stats), phase_stats.ToJson()) ||
+      !WriteReport(absl::GetFlag(FLAGS_trace), phase_stats.ToChromeTrace())) {
+    return 1;
+  }
 
   return 0;
 }
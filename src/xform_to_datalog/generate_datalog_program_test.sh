@@ -3,14 +3,79 @@
 # A simple script to test the generate_datalog_program command line.
 ROOT_DIR=$TEST_SRCDIR/$TEST_WORKSPACE/src/xform_to_datalog
 CMD=$ROOT_DIR/generate_datalog_program
+WRITE_MANIFEST_STREAM=$ROOT_DIR/write_manifest_stream
+COMPILE_POLICY_BUNDLE=$ROOT_DIR/compile_policy_bundle
 
 AUTH_FILE=$ROOT_DIR/testdata/ok_claim_propagates.auth
 MANIFEST_FILE=$ROOT_DIR/testdata/ok_claim_propagates_proto.binarypb
 DATALOG_FILE=$ROOT_DIR/testdata/ok_claim_propagates.dl
 GENERATED_DATALOG_FILE=`mktemp`
+STATS_FILE=`mktemp`
+TRACE_FILE=`mktemp`
+MANIFEST_STREAM_FILE=`mktemp`
+POLICY_BUNDLE_FILE=`mktemp`
+AUTH_LOGIC_CACHE_DIR=`mktemp -d`
 
 $CMD --auth_logic_file=$AUTH_FILE --manifest_proto=$MANIFEST_FILE \
-  --datalog_file=$GENERATED_DATALOG_FILE --overwrite
+  --datalog_file=$GENERATED_DATALOG_FILE --overwrite \
+  --stats=$STATS_FILE --trace=$TRACE_FILE || exit 1
+
+# The reports must mention the last phase.
+grep -q '"name": "write_datalog"' $STATS_FILE || exit 1
+grep -q '"name": "write_datalog", "ph": "X"' $TRACE_FILE || exit 1
+# The authorization logic is compiled on a thread of its own.
+grep -q '"name": "compile_auth_logic", "ph": "X", "pid": 1, "tid": 2' \
+  $TRACE_FILE || exit 1
+
+diff $GENERATED_DATALOG_FILE $DATALOG_FILE || exit 1
+
+# The second run takes the authorization logic facts from the cache, which
+# must not change the output.
+for i in 1 2; do
+  $CMD --auth_logic_file=$AUTH_FILE --manifest_proto=$MANIFEST_FILE \
+    --datalog_file=$GENERATED_DATALOG_FILE --overwrite --stats=$STATS_FILE \
+    --auth_logic_cache_dir=$AUTH_LOGIC_CACHE_DIR || exit 1
+  diff $GENERATED_DATALOG_FILE $DATALOG_FILE || exit 1
+done
+grep -q '"auth_logic_cache_hits": 1' $STATS_FILE || exit 1
+
+# The manifest has a single recipe, so reading it as a manifest stream must
+# not change the output either.
+$WRITE_MANIFEST_STREAM --manifest_proto=$MANIFEST_FILE \
+  --manifest_stream=$MANIFEST_STREAM_FILE || exit 1
+$CMD --auth_logic_file=$AUTH_FILE --manifest_stream=$MANIFEST_STREAM_FILE \
+  --datalog_file=$GENERATED_DATALOG_FILE --overwrite --stats=$STATS_FILE \
+  || exit 1
+grep -q '"name": "stream_recipes"' $STATS_FILE || exit 1
+diff $GENERATED_DATALOG_FILE $DATALOG_FILE || exit 1
+
+# Printing the facts of a policy bundle must not change the output.
+$COMPILE_POLICY_BUNDLE --manifest_proto=$MANIFEST_FILE \
+  --policy_bundle=$POLICY_BUNDLE_FILE || exit 1
+$CMD --auth_logic_file=$AUTH_FILE --policy_bundle=$POLICY_BUNDLE_FILE \
+  --datalog_file=$GENERATED_DATALOG_FILE --overwrite --stats=$STATS_FILE \
+  || exit 1
+grep -q '"name": "map_policy_bundle"' $STATS_FILE || exit 1
+
+# A bundle must be loaded with the default derivation mode it was compiled
+# with, in either direction.
+$CMD --auth_logic_file=$AUTH_FILE --policy_bundle=$POLICY_BUNDLE_FILE \
+  --datalog_file=`mktemp` --overwrite --midpoint_default_derivation \
+  && exit 1
+MIDPOINT_POLICY_BUNDLE_FILE=`mktemp`
+$COMPILE_POLICY_BUNDLE --manifest_proto=$MANIFEST_FILE \
+  --policy_bundle=$MIDPOINT_POLICY_BUNDLE_FILE \
+  --midpoint_default_derivation || exit 1
+$CMD --auth_logic_file=$AUTH_FILE \
+  --policy_bundle=$MIDPOINT_POLICY_BUNDLE_FILE --datalog_file=`mktemp` \
+  --overwrite && exit 1
+
+# A failed run must leave neither the output file nor its temporary file, so
+# that the next run does not need --overwrite.
+FAILED_DATALOG_FILE=`mktemp -u`
+$CMD --auth_logic_file=$AUTH_FILE --policy_bundle=$POLICY_BUNDLE_FILE \
+  --datalog_file=$FAILED_DATALOG_FILE --midpoint_default_derivation && exit 1
+ls $FAILED_DATALOG_FILE* 2>/dev/null && exit 1
 
 # Return the result of comparing generated and golden file.
 diff $GENERATED_DATALOG_FILE $DATALOG_FILE
@@ -0,0 +1,590 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//----------------------------------------------------------------------------
+// Benchmarks for the stages of the pipeline that turns a manifest into a
+// datalog program, on synthetic manifests. Every benchmark reports the
+// allocations made by the timed code per iteration. The manifest benchmarks
+// are parameterized by the number of particles, the ParticleSpec benchmark
+// by the width of the schema of its handle connections. The witness path
+// and reachability benchmarks time tools that work on the same facts
+// instead of the results of the analysis. The transitive closure benchmarks
+// compare the bit matrix closure with a semi-naive evaluation of the path
+// rules of dataflow_graph.dl, on manifests and on single long pipelines.
+// The policy bundle benchmark compares printing the facts of a manifest
+// file with printing those of a precompiled bundle, from a cold start.
+//
+// Example:
+//   bazel run -c opt //src/xform_to_datalog:ir_pipeline_benchmark --
+//     --benchmark_filter=ToDatalog
+
+#include <fcntl.h>
+#include <malloc.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_cat.h"
+
+#include "benchmark/benchmark.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/datalog_print_context.h"
+#include "src/ir/particle_spec.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/handle_connection_spec.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/ir/proto/tag_check.h"
+#include "src/ir/proto/tag_claim.h"
+#include "src/ir/proto/type.h"
+#include "src/ir/system_spec.h"
+#include "src/utils/allocation_counter.h"
+#include "src/test_utils/synthetic_manifest/synthetic_manifest.h"
+#include "src/xform_to_datalog/authorization_logic_datalog_facts.h"
+#include "src/xform_to_datalog/datalog_facts.h"
+#include "src/xform_to_datalog/access_path_graph.h"
+#include "src/xform_to_datalog/check_sources.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "src/xform_to_datalog/policy_bundle.h"
+#include "src/xform_to_datalog/reachability_index.h"
+#include "src/xform_to_datalog/transitive_closure.h"
+#include "src/xform_to_datalog/witness_path.h"
+
+namespace raksha::xform_to_datalog {
+namespace {
+
+namespace ir = raksha::ir;
+using utils::AllocationCounts;
+using utils::ScopedAllocationCounter;
+using test_utils::SyntheticManifestOptions;
+
+constexpr uint64_t kParticlesPerRecipe = 10;
+
+// The shape of the manifests of the manifest benchmarks. Recipes are
+// pipelines of at most `kParticlesPerRecipe` particles.
+SyntheticManifestOptions GetManifestOptions(uint64_t num_particles) {
+  uint64_t particles_per_recipe = std::min(num_particles, kParticlesPerRecipe);
+  return SyntheticManifestOptions{
+      .num_recipes = num_particles / particles_per_recipe,
+      .particles_per_recipe = particles_per_recipe,
+      .connections_per_particle = 2,
+      .schema_depth = 1,
+      .schema_width = 2,
+      .checks_per_particle = 1,
+      .claims_per_particle = 1};
+}
+
+// Reports the given allocations, made over all iterations of `state`.
+void ReportAllocations(benchmark::State &state,
+                       const AllocationCounts &allocations) {
+  state.counters["allocs"] = benchmark::Counter(
+      allocations.num_allocations, benchmark::Counter::kAvgIterations);
+  state.counters["alloc_bytes"] = benchmark::Counter(
+      allocations.num_bytes, benchmark::Counter::kAvgIterations);
+}
+
+void ReportParticles(benchmark::State &state) {
+  state.SetComplexityN(state.range(0));
+  state.counters["particles"] = state.range(0);
+}
+
+void BM_DecodeManifest(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ir::proto::Decode(manifest));
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  ReportParticles(state);
+}
+
+void BM_GetAccessPathSelectorsSet(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  // The schemas of all handle connections of all particles, as they are
+  // looked at when the manifest facts are created.
+  std::vector<std::unique_ptr<ir::types::Type>> types;
+  for (const arcs::RecipeProto &recipe : manifest.recipes()) {
+    for (const arcs::ParticleProto &particle : recipe.particles()) {
+      for (const arcs::HandleConnectionProto &connection :
+           particle.connections()) {
+        types.push_back(ir::types::proto::Decode(connection.type()));
+      }
+    }
+  }
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    for (const std::unique_ptr<ir::types::Type> &type : types) {
+      benchmark::DoNotOptimize(type->GetAccessPathSelectorsSet());
+    }
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  ReportParticles(state);
+}
+
+// ParticleSpec::GenerateEdges runs when a ParticleSpec is created. This
+// benchmark times ParticleSpec::Create, with the components of the spec
+// decoded outside of the timed region.
+void BM_GenerateEdges(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(SyntheticManifestOptions{
+          .connections_per_particle = 4,
+          .schema_depth = 2,
+          .schema_width = static_cast<uint64_t>(state.range(0)),
+          .checks_per_particle = 1,
+          .claims_per_particle = 1});
+  const arcs::ParticleSpecProto &spec_proto = manifest.particle_specs(0);
+  AllocationCounts allocations;
+  for (auto _ : state) {
+    state.PauseTiming();
+    std::vector<ir::HandleConnectionSpec> connection_specs;
+    for (const arcs::HandleConnectionSpecProto &connection_proto :
+         spec_proto.connections()) {
+      connection_specs.push_back(ir::proto::Decode(connection_proto));
+    }
+    std::vector<ir::TagClaim> tag_claims;
+    for (const arcs::ClaimProto &claim : spec_proto.claims()) {
+      for (ir::TagClaim &tag_claim :
+           ir::proto::Decode(spec_proto.name(), claim.assume())) {
+        tag_claims.push_back(std::move(tag_claim));
+      }
+    }
+    std::vector<ir::TagCheck> checks;
+    for (const arcs::CheckProto &check : spec_proto.checks()) {
+      checks.push_back(ir::proto::Decode(check));
+    }
+    state.ResumeTiming();
+
+    ScopedAllocationCounter allocation_counter;
+    std::unique_ptr<ir::ParticleSpec> spec = ir::ParticleSpec::Create(
+        spec_proto.name(), std::move(checks), std::move(tag_claims),
+        /*derives_from_claims=*/{}, std::move(connection_specs));
+    AllocationCounts iteration_allocations = allocation_counter.Get();
+    allocations.num_allocations += iteration_allocations.num_allocations;
+    allocations.num_bytes += iteration_allocations.num_bytes;
+
+    state.PauseTiming();
+    spec.reset();
+    state.ResumeTiming();
+  }
+  ReportAllocations(state, allocations);
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_CreateFromManifestProto(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        ManifestDatalogFacts::CreateFromManifestProto(*system_spec, manifest));
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  ReportParticles(state);
+}
+
+void BM_ToDatalog(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  DatalogFacts datalog_facts(
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec, manifest),
+      AuthorizationLogicDatalogFacts(""));
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    ir::DatalogPrintContext ctxt;
+    benchmark::DoNotOptimize(datalog_facts.ToDatalog(ctxt));
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  ReportParticles(state);
+}
+
+void BM_CreateWitnessPathExplainer(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  ManifestDatalogFacts manifest_facts =
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec, manifest);
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(WitnessPathExplainer::Create(manifest_facts));
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  ReportParticles(state);
+}
+
+// Explains the check of the last particle of a pipeline of particles, of
+// which only the first claims the tag, so that the witness path runs through
+// the whole pipeline.
+void BM_ExplainWitnessPath(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(SyntheticManifestOptions{
+          .particles_per_recipe = static_cast<uint64_t>(state.range(0)),
+          .checks_per_particle = 1,
+          .claims_per_particle = 1});
+  for (int i = 1; i < manifest.particle_specs_size(); ++i) {
+    manifest.mutable_particle_specs(i)->clear_claims();
+  }
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  ManifestDatalogFacts manifest_facts =
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec, manifest);
+  WitnessPathExplainer explainer =
+      WitnessPathExplainer::Create(manifest_facts);
+  CheckSources check_sources = CheckSources::Create(manifest_facts);
+  const CheckSource &last_check = check_sources.sources().back();
+  WitnessSearchLimits unlimited{
+      .max_edges = std::numeric_limits<uint64_t>::max(),
+      .max_visited = std::numeric_limits<uint64_t>::max()};
+  CHECK(explainer.Explain(last_check.access_path, "tag0", unlimited)
+            .has_value());
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        explainer.Explain(last_check.access_path, "tag0", unlimited));
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  ReportParticles(state);
+}
+
+void BM_CreateReachabilityIndex(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  AccessPathGraph graph = AccessPathGraph::Create(
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec, manifest));
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ReachabilityIndex::Create(graph));
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  ReportParticles(state);
+}
+
+// Asks whether pseudo-random pairs of access paths can reach each other.
+void BM_CanReach(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  AccessPathGraph graph = AccessPathGraph::Create(
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec, manifest));
+  ReachabilityIndex index = ReachabilityIndex::Create(graph);
+  constexpr size_t kNumQueries = 1024;
+  std::vector<std::pair<std::string, std::string>> queries;
+  uint64_t random = 1;
+  for (size_t i = 0; i < kNumQueries; ++i) {
+    random = random * 6364136223846793005 + 1442695040888963407;
+    uint32_t from = (random >> 33) % graph.num_nodes();
+    random = random * 6364136223846793005 + 1442695040888963407;
+    uint32_t to = (random >> 33) % graph.num_nodes();
+    queries.push_back({graph.name(from), graph.name(to)});
+  }
+  for (auto _ : state) {
+    for (const auto &[from, to] : queries) {
+      benchmark::DoNotOptimize(index.CanReach(from, to));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kNumQueries);
+  ReportParticles(state);
+}
+
+AccessPathGraph CreateManifestGraph(uint64_t num_particles) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(num_particles));
+  std::unique_ptr<ir::SystemSpec> system_spec = ir::proto::Decode(manifest);
+  return AccessPathGraph::Create(
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec, manifest));
+}
+
+// A single pipeline of `num_nodes` access paths, whose closure has every
+// pair of them in order.
+AccessPathGraph CreatePipelineGraph(uint64_t num_nodes) {
+  AccessPathGraph graph;
+  for (uint64_t node = 0; node < num_nodes; ++node) {
+    graph.GetNode(absl::StrCat("P.h", node));
+    if (node > 0) graph.AddEdge(node - 1, node);
+  }
+  return graph;
+}
+
+// Evaluates the path rules of dataflow_graph.dl semi-naively, materializing
+// a tuple per pair of nodes as Souffle does, and returns the number of
+// tuples.
+uint64_t EvaluatePathRules(const AccessPathGraph &graph) {
+  std::vector<std::vector<uint32_t>> predecessors(graph.num_nodes());
+  absl::flat_hash_set<std::pair<uint32_t, uint32_t>> paths;
+  std::vector<std::pair<uint32_t, uint32_t>> delta;
+  for (uint32_t from = 0; from < graph.num_nodes(); ++from) {
+    for (uint32_t to : graph.successors(from)) {
+      predecessors[to].push_back(from);
+      if (paths.insert({from, to}).second) delta.push_back({from, to});
+    }
+  }
+  std::vector<std::pair<uint32_t, uint32_t>> next_delta;
+  while (!delta.empty()) {
+    next_delta.clear();
+    for (const auto &[intermediate, to] : delta) {
+      for (uint32_t from : predecessors[intermediate]) {
+        if (paths.insert({from, to}).second) next_delta.push_back({from, to});
+      }
+    }
+    std::swap(delta, next_delta);
+  }
+  return paths.size();
+}
+
+void RunTransitiveClosure(benchmark::State &state,
+                          const AccessPathGraph &graph) {
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(TransitiveClosure::Create(graph));
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  TransitiveClosure closure = TransitiveClosure::Create(graph);
+  state.counters["closure_bytes"] = closure.num_bytes();
+  state.counters["paths"] = closure.NumPaths();
+}
+
+void RunPathRules(benchmark::State &state, const AccessPathGraph &graph) {
+  uint64_t num_paths = 0;
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) num_paths = EvaluatePathRules(graph);
+  ReportAllocations(state, allocation_counter.Get());
+  state.counters["paths"] = num_paths;
+}
+
+void BM_TransitiveClosure(benchmark::State &state) {
+  RunTransitiveClosure(state, CreateManifestGraph(state.range(0)));
+  ReportParticles(state);
+}
+
+void BM_PathRules(benchmark::State &state) {
+  RunPathRules(state, CreateManifestGraph(state.range(0)));
+  ReportParticles(state);
+}
+
+void BM_TransitiveClosureOfPipeline(benchmark::State &state) {
+  RunTransitiveClosure(state, CreatePipelineGraph(state.range(0)));
+  state.SetComplexityN(state.range(0));
+}
+
+void BM_PathRulesOfPipeline(benchmark::State &state) {
+  RunPathRules(state, CreatePipelineGraph(state.range(0)));
+  state.SetComplexityN(state.range(0));
+}
+
+// Returns by how many KiB calling `load` once raises the peak resident set
+// size. `load` runs in a child process, which first returns the free memory
+// of its heap to the system and resets its peak to its current resident
+// set. Otherwise, `load` would reuse the memory freed by earlier benchmarks
+// without raising the peak, or stay below their peak.
+template <typename Load>
+int64_t MeasurePeakRssGrowthKib(Load load) {
+  int fds[2];
+  CHECK_EQ(pipe(fds), 0);
+  pid_t pid = fork();
+  CHECK_GE(pid, 0);
+  if (pid == 0) {
+    close(fds[0]);
+    malloc_trim(0);
+    int clear_refs = open("/proc/self/clear_refs", O_WRONLY);
+    CHECK(clear_refs >= 0 && write(clear_refs, "5", 1) == 1)
+        << "Resetting the peak resident set size needs Linux 4.0 or later.";
+    close(clear_refs);
+    rusage before;
+    getrusage(RUSAGE_SELF, &before);
+    load();
+    rusage after;
+    getrusage(RUSAGE_SELF, &after);
+    int64_t growth = after.ru_maxrss - before.ru_maxrss;
+    bool written = write(fds[1], &growth, sizeof(growth)) == sizeof(growth);
+    _exit(written ? 0 : 1);
+  }
+  close(fds[1]);
+  int64_t growth = 0;
+  bool read_growth = read(fds[0], &growth, sizeof(growth)) == sizeof(growth);
+  close(fds[0]);
+  int status;
+  CHECK_EQ(waitpid(pid, &status, 0), pid);
+  CHECK(read_growth && WIFEXITED(status) && WEXITSTATUS(status) == 0);
+  return growth;
+}
+
+// Loads a synthetic manifest from a file, either by parsing an ifstream into
+// a heap-allocated message, as the tools used to, or with ManifestFile. The
+// peak RSS counter is the growth of the peak resident set size during one
+// load. The pages of the mapped file count towards it while they are
+// resident, although the kernel may drop them as they are clean.
+void BM_LoadManifest(benchmark::State &state) {
+  std::filesystem::path manifest_filepath =
+      std::filesystem::temp_directory_path() /
+      absl::StrCat("ir_pipeline_benchmark_", state.range(0), ".pb");
+  {
+    std::ofstream manifest_file(manifest_filepath, std::ios::out |
+                                                       std::ios::trunc |
+                                                       std::ios::binary);
+    CHECK(test_utils::GenerateSyntheticManifest(
+              GetManifestOptions(state.range(0)))
+              .SerializeToOstream(&manifest_file));
+  }
+  bool use_manifest_file = state.range(1) != 0;
+  auto load = [&] {
+    if (use_manifest_file) {
+      std::unique_ptr<ir::proto::ManifestFile> manifest =
+          ir::proto::ManifestFile::Load(manifest_filepath);
+      CHECK(manifest != nullptr);
+      benchmark::DoNotOptimize(manifest->manifest_proto().recipes_size());
+    } else {
+      std::ifstream manifest_stream(manifest_filepath);
+      arcs::ManifestProto manifest;
+      CHECK(manifest.ParseFromIstream(&manifest_stream));
+      benchmark::DoNotOptimize(manifest.recipes_size());
+    }
+  };
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) load();
+  ReportAllocations(state, allocation_counter.Get());
+  state.counters["peak_rss_kib"] = MeasurePeakRssGrowthKib(load);
+  state.counters["file_bytes"] = std::filesystem::file_size(manifest_filepath);
+  ReportParticles(state);
+  std::filesystem::remove(manifest_filepath);
+}
+
+// Prints the facts of a synthetic manifest, starting either from the
+// manifest file, which is parsed, decoded and instantiated, or from a policy
+// bundle compiled from it, which is mapped and printed.
+void BM_StartFromPolicyBundle(benchmark::State &state) {
+  arcs::ManifestProto manifest =
+      test_utils::GenerateSyntheticManifest(GetManifestOptions(state.range(0)));
+  bool use_policy_bundle = state.range(1) != 0;
+  std::filesystem::path filepath =
+      std::filesystem::temp_directory_path() /
+      absl::StrCat("ir_pipeline_benchmark_", state.range(0),
+                   use_policy_bundle ? ".bundle" : ".pb");
+  {
+    std::ofstream file(filepath,
+                       std::ios::out | std::ios::trunc | std::ios::binary);
+    if (use_policy_bundle) {
+      std::unique_ptr<ir::SystemSpec> system_spec =
+          ir::proto::Decode(manifest);
+      file << PolicyBundle::Compile(
+          ManifestDatalogFacts::CreateFromManifestProto(*system_spec,
+                                                        manifest),
+          ir::ParticleSpec::DefaultDerivationMode::kCartesian);
+    } else {
+      CHECK(manifest.SerializeToOstream(&file));
+    }
+  }
+  ScopedAllocationCounter allocation_counter;
+  for (auto _ : state) {
+    ir::DatalogPrintContext ctxt;
+    if (use_policy_bundle) {
+      std::unique_ptr<PolicyBundle> policy_bundle =
+          PolicyBundle::Load(filepath);
+      CHECK(policy_bundle != nullptr);
+      benchmark::DoNotOptimize(policy_bundle->ToDatalog(ctxt));
+    } else {
+      std::unique_ptr<ir::proto::ManifestFile> manifest_file =
+          ir::proto::ManifestFile::Load(filepath);
+      CHECK(manifest_file != nullptr);
+      std::unique_ptr<ir::SystemSpec> system_spec =
+          ir::proto::Decode(manifest_file->manifest_proto());
+      benchmark::DoNotOptimize(
+          ManifestDatalogFacts::CreateFromManifestProto(
+              *system_spec, manifest_file->manifest_proto())
+              .ToDatalog(ctxt));
+    }
+  }
+  ReportAllocations(state, allocation_counter.Get());
+  state.counters["file_bytes"] = std::filesystem::file_size(filepath);
+  ReportParticles(state);
+  std::filesystem::remove(filepath);
+}
+
+// Registers a manifest benchmark for 10 to 1M particles.
+#define RAKSHA_MANIFEST_BENCHMARK(name) \
+  BENCHMARK(name)                       \
+      ->RangeMultiplier(10)             \
+      ->Range(10, 1000000)              \
+      ->Unit(benchmark::kMillisecond)   \
+      ->Complexity()
+
+RAKSHA_MANIFEST_BENCHMARK(BM_DecodeManifest);
+RAKSHA_MANIFEST_BENCHMARK(BM_GetAccessPathSelectorsSet);
+RAKSHA_MANIFEST_BENCHMARK(BM_CreateFromManifestProto);
+RAKSHA_MANIFEST_BENCHMARK(BM_ToDatalog);
+RAKSHA_MANIFEST_BENCHMARK(BM_CreateWitnessPathExplainer);
+RAKSHA_MANIFEST_BENCHMARK(BM_CreateReachabilityIndex);
+BENCHMARK(BM_CanReach)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ExplainWitnessPath)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+BENCHMARK(BM_LoadManifest)
+    ->ArgNames({"particles", "mapped"})
+    ->Apply([](benchmark::internal::Benchmark *benchmark) {
+      for (int64_t num_particles : {1000, 10000, 100000}) {
+        benchmark->Args({num_particles, 0});
+        benchmark->Args({num_particles, 1});
+      }
+    })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StartFromPolicyBundle)
+    ->ArgNames({"particles", "bundled"})
+    ->Apply([](benchmark::internal::Benchmark *benchmark) {
+      for (int64_t num_particles : {1000, 10000, 100000}) {
+        benchmark->Args({num_particles, 0});
+        benchmark->Args({num_particles, 1});
+      }
+    })
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TransitiveClosure)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PathRules)
+    ->RangeMultiplier(10)
+    ->Range(10, 100000)
+    ->Unit(benchmark::kMillisecond);
+// The path rules hold a tuple per pair of access paths of the pipeline:
+// 8M tuples at 4096 of them, and 2G at the 64k of the last closure.
+BENCHMARK(BM_TransitiveClosureOfPipeline)
+    ->RangeMultiplier(4)
+    ->Range(256, 65536)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+BENCHMARK(BM_PathRulesOfPipeline)
+    ->RangeMultiplier(4)
+    ->Range(256, 4096)
+    ->Unit(benchmark::kMillisecond)
+    ->Complexity();
+BENCHMARK(BM_GenerateEdges)->RangeMultiplier(2)->Range(1, 16)->Complexity();
+
+}  // namespace
+}  // namespace raksha::xform_to_datalog
+
+BENCHMARK_MAIN();
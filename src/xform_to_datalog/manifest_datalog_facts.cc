@@ -26,6 +26,20 @@ namespace raksha::xform_to_datalog {
 namespace ir = raksha::ir;
 namespace types = raksha::ir::types;
 
+std::string ManifestDatalogFacts::GetRecipeName(
+    const arcs::RecipeProto &recipe_proto, uint64_t &num_generated_names) {
+  // To allow recipes to be distinguished as a component of an AccessPath, we
+  // provide each recipe a unique name. For recipes that have a name
+  // provided by the user, we use the user-provided name. For those recipes
+  // where the user did not provide a name, we generate a name by combining a
+  // prefix and the number of names generated so far.
+  constexpr absl::string_view kGeneratedRecipeNamePrefix =
+      "GENERATED_RECIPE_NAME";
+  return recipe_proto.name().empty()
+             ? absl::StrCat(kGeneratedRecipeNamePrefix, num_generated_names++)
+             : recipe_proto.name();
+}
+
 // Traverse the substructures of the manifest proto to create datalog fact
 // objects.
 // #TODO(#107): In the interest of prototyping speed, I wrote out the
@@ -40,120 +54,132 @@ ManifestDatalogFacts ManifestDatalogFacts::CreateFromManifestProto(
   std::vector<Particle> particle_instances;
 
   // This loop looks at each recipe in the manifest proto and instantiates
-  // the ParticleSpecs indicated by the ParticleProtos in that recipe. It
-  // additionally generates the edges in and out of the Particle to Handles
-  // as indicated by the HandleConnections on the Particles.
-  //
-  // To allow recipes to be distinguished as a component of an AccessPath, we
-  // provide each recipe a unique name. For recipes that have a name
-  // provided by the user, we use the user-provided name. For those recipes
-  // where the user did not provide a name, we generate a name by combining the
-  // generated_recipe_name_prefix and a recipe_num counter that we increment
-  // for each generated recipe name.
-  const std::string generated_recipe_name_prefix = "GENERATED_RECIPE_NAME";
-  uint64_t recipe_num = 0;
+  // the ParticleSpecs indicated by the ParticleProtos in that recipe.
+  uint64_t num_generated_recipe_names = 0;
   for (const arcs::RecipeProto &recipe_proto : manifest_proto.recipes()) {
-    const std::string &recipe_name =
-        recipe_proto.name().empty()
-          ? absl::StrCat(generated_recipe_name_prefix, recipe_num++)
-          : recipe_proto.name();
-
-    // For each Particle, generate the relevant facts for that particle.
-    // These fall into two categories: facts that lie within the ParticleSpec
-    // that just need to be instantiated for this particular Particle, and
-    // edges that connect this Particle to input/output Handles.
-    uint64_t particle_num = 0;
-    for (const arcs::ParticleProto &particle_proto : recipe_proto.particles()) {
-      const std::string &particle_spec_name = particle_proto.spec_name();
-      CHECK(!particle_spec_name.empty())
-        << "Particle with empty spec_name field not allowed.";
-      const std::string particle_name =
-          absl::StrCat(particle_spec_name, "#", particle_num++);
-
-      // Find the ParticleSpec referenced by this Particle. The information
-      // contained in the spec will be needed for all facts produced within a
-      // Particle.
-      const ir::ParticleSpec &particle_spec =
-          *CHECK_NOTNULL(system_spec.GetParticleSpec(particle_spec_name));
-
-      // Each ParticleSpec already contains lists of TagClaims, TagChecks,
-      // and Edges that shall be generated for each Particle implementing that
-      // Spec, but which are rooted at the ParticleSpec rather than the
-      // implementing Recipe and Particle. Most of the work of generating the
-      // facts for a particular Particle just comes down to swapping out the
-      // ParticleSpec roots for the corresponding Particle roots. The
-      // instantiation_map describing how that swapping should be done is
-      // populated by iterating over all HandleConnectionProtos and, for each
-      // HandleConnectionSpec and HandleConnection pair indicated, adding
-      // that pair to the instantiation_map.
-      ir::DatalogPrintContext::AccessPathInstantiationMap instantiation_map;
-      std::vector<ir::Edge> particle_edges;
-      for (const arcs::HandleConnectionProto &connection_proto :
-        particle_proto.connections()) {
-        const std::string &handle_spec_name = connection_proto.name();
-        CHECK(!handle_spec_name.empty())
-          << "Handle connection with empty name field not allowed.";
-        std::string handle_name = connection_proto.handle();
-        CHECK(!handle_name.empty())
-          << "Handle with empty handle field not allowed.";
-
-        raksha::ir::HandleConnectionSpecAccessPathRoot spec_handle_root(
-            particle_spec_name, handle_spec_name);
-        raksha::ir::HandleConnectionAccessPathRoot
-          instantiated_handle_root(
-              recipe_name, particle_name, handle_spec_name);
-
-        // Set up the map to replace the HandleConnectionSpec root with the
-        // HandleConnection root when instantiating the Particle.
-        instantiation_map.insert({
-          ir::AccessPathRoot(std::move(spec_handle_root)),
-          ir::AccessPathRoot(instantiated_handle_root) });
-
-        raksha::ir::HandleAccessPathRoot handle_root(
-            recipe_name, std::move(handle_name));
-
-        CHECK(connection_proto.has_type())
-          << "Handle connection with absent type not allowed.";
-        std::unique_ptr<types::Type> connection_type =
-            ir::types::proto::Decode(connection_proto.type());
-        ir::AccessPathSelectorsSet access_path_selectors_set =
-            connection_type->GetAccessPathSelectorsSet();
-
-        // Look up the HandleConnectionSpec to see if the handle connection
-        // will read and/or write.
-        const ir::HandleConnectionSpec &handle_connection_spec =
-            particle_spec.getHandleConnectionSpec(handle_spec_name);
-        const bool handle_connection_reads = handle_connection_spec.reads();
-        const bool handle_connection_writes = handle_connection_spec.writes();
-
-        for (const ir::AccessPathSelectors &selectors :
-             ir::AccessPathSelectorsSet::CreateAbslSet(
-                 access_path_selectors_set)) {
-          ir::AccessPath handle_access_path(
-              ir::AccessPathRoot(handle_root), selectors);
-          ir::AccessPath handle_connection_access_path(
-              ir::AccessPathRoot(instantiated_handle_root), selectors);
-
-          // If the handle connection reads, draw a dataflow edge from the
-          // handle to the handle connection.
-          if (handle_connection_reads) {
-            particle_edges.push_back(
-                ir::Edge(handle_access_path, handle_connection_access_path));
-          }
-
-          // If the handle connection writes, draw a dataflow edge from the
-          // handle connection to the handle.
-          if (handle_connection_writes) {
-            particle_edges.push_back(
-                ir::Edge(handle_connection_access_path, handle_access_path));
-          }
+    ManifestDatalogFacts recipe_facts = CreateFromRecipeProto(
+        system_spec, recipe_proto,
+        GetRecipeName(recipe_proto, num_generated_recipe_names));
+    for (Particle &particle : recipe_facts.particle_instances_) {
+      particle_instances.push_back(std::move(particle));
+    }
+  }
+
+  return ManifestDatalogFacts(std::move(particle_instances));
+}
+
+// Instantiates the ParticleSpecs indicated by the ParticleProtos in the
+// recipe. It additionally generates the edges in and out of the Particle to
+// Handles as indicated by the HandleConnections on the Particles.
+ManifestDatalogFacts ManifestDatalogFacts::CreateFromRecipeProto(
+    const ir::SystemSpec &system_spec, const arcs::RecipeProto &recipe_proto,
+    const std::string &recipe_name) {
+  std::vector<Particle> particle_instances;
+  // For each Particle, generate the relevant facts for that particle.
+  // These fall into two categories: facts that lie within the ParticleSpec
+  // that just need to be instantiated for this particular Particle, and
+  // edges that connect this Particle to input/output Handles.
+  uint64_t particle_num = 0;
+  for (const arcs::ParticleProto &particle_proto : recipe_proto.particles()) {
+    const std::string &particle_spec_name = particle_proto.spec_name();
+    CHECK(!particle_spec_name.empty())
+      << "Particle with empty spec_name field not allowed.";
+    const std::string particle_name =
+        absl::StrCat(particle_spec_name, "#", particle_num++);
+
+    // Find the ParticleSpec referenced by this Particle. The information
+    // contained in the spec will be needed for all facts produced within a
+    // Particle.
+    const ir::ParticleSpec &particle_spec =
+        *CHECK_NOTNULL(system_spec.GetParticleSpec(particle_spec_name));
+
+    // Each ParticleSpec already contains lists of TagClaims, TagChecks,
+    // and Edges that shall be generated for each Particle implementing that
+    // Spec, but which are rooted at the ParticleSpec rather than the
+    // implementing Recipe and Particle. Most of the work of generating the
+    // facts for a particular Particle just comes down to swapping out the
+    // ParticleSpec roots for the corresponding Particle roots. The
+    // instantiation_map describing how that swapping should be done is
+    // populated by iterating over all HandleConnectionProtos and, for each
+    // HandleConnectionSpec and HandleConnection pair indicated, adding
+    // that pair to the instantiation_map.
+    ir::DatalogPrintContext::AccessPathInstantiationMap instantiation_map;
+    std::vector<ir::Edge> particle_edges;
+    for (const arcs::HandleConnectionProto &connection_proto :
+      particle_proto.connections()) {
+      const std::string &handle_spec_name = connection_proto.name();
+      CHECK(!handle_spec_name.empty())
+        << "Handle connection with empty name field not allowed.";
+      std::string handle_name = connection_proto.handle();
+      CHECK(!handle_name.empty())
+        << "Handle with empty handle field not allowed.";
+
+      raksha::ir::HandleConnectionSpecAccessPathRoot spec_handle_root(
+          particle_spec_name, handle_spec_name);
+      raksha::ir::HandleConnectionAccessPathRoot
+        instantiated_handle_root(
+            recipe_name, particle_name, handle_spec_name);
+
+      // Set up the map to replace the HandleConnectionSpec root with the
+      // HandleConnection root when instantiating the Particle.
+      instantiation_map.insert({
+        ir::AccessPathRoot(std::move(spec_handle_root)),
+        ir::AccessPathRoot(instantiated_handle_root) });
+
+      raksha::ir::HandleAccessPathRoot handle_root(
+          recipe_name, std::move(handle_name));
+
+      CHECK(connection_proto.has_type())
+        << "Handle connection with absent type not allowed.";
+      std::unique_ptr<types::Type> connection_type =
+          ir::types::proto::Decode(connection_proto.type());
+      ir::AccessPathSelectorsSet access_path_selectors_set =
+          connection_type->GetAccessPathSelectorsSet();
+
+      // Look up the HandleConnectionSpec to see if the handle connection
+      // will read and/or write.
+      const ir::HandleConnectionSpec &handle_connection_spec =
+          particle_spec.getHandleConnectionSpec(handle_spec_name);
+      const bool handle_connection_reads = handle_connection_spec.reads();
+      const bool handle_connection_writes = handle_connection_spec.writes();
+
+      for (const ir::AccessPathSelectors &selectors :
+           ir::AccessPathSelectorsSet::CreateAbslSet(
+               access_path_selectors_set)) {
+        ir::AccessPath handle_access_path(
+            ir::AccessPathRoot(handle_root), selectors);
+        ir::AccessPath handle_connection_access_path(
+            ir::AccessPathRoot(instantiated_handle_root), selectors);
+
+        // If the handle connection reads, draw a dataflow edge from the
+        // handle to the handle connection.
+        if (handle_connection_reads) {
+          particle_edges.push_back(
+              ir::Edge(handle_access_path, handle_connection_access_path));
         }
-      }
 
-      particle_instances.push_back(Particle(&particle_spec,
-                                            std::move(instantiation_map),
-                                            std::move(particle_edges)));
+        // If the handle connection writes, draw a dataflow edge from the
+        // handle connection to the handle.
+        if (handle_connection_writes) {
+          particle_edges.push_back(
+              ir::Edge(handle_connection_access_path, handle_access_path));
+        }
+      }
     }
+
+    // The midpoint of the ParticleSpec, if it has one, is instantiated once
+    // per Particle, just like the HandleConnectionSpecs.
+    instantiation_map.insert(
+        {ir::ParticleSpec::GetMidpointAccessPathRoot(particle_spec_name),
+         ir::AccessPathRoot(ir::HandleConnectionAccessPathRoot(
+             recipe_name, particle_name,
+             std::string(ir::ParticleSpec::
+                             kMidpointHandleConnectionSpecName)))});
+
+    particle_instances.push_back(Particle(&particle_spec,
+                                          std::move(instantiation_map),
+                                          std::move(particle_edges),
+                                          recipe_name));
   }
 
   return ManifestDatalogFacts(std::move(particle_instances));
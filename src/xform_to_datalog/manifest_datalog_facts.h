@@ -17,21 +17,28 @@
 #ifndef SRC_XFORM_TO_DATALOG_MANIFEST_DATALOG_FACTS_H_
 #define SRC_XFORM_TO_DATALOG_MANIFEST_DATALOG_FACTS_H_
 
+#include <ostream>
+#include <sstream>
+#include <string>
 #include <vector>
 
 #include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
 #include "src/ir/datalog_print_context.h"
 #include "src/ir/edge.h"
 #include "src/ir/particle_spec.h"
 #include "src/ir/system_spec.h"
 #include "src/ir/tag_check.h"
 #include "src/ir/tag_claim.h"
+#include "src/utils/remove_duplicates.h"
 #include "third_party/arcs/proto/manifest.pb.h"
 
 namespace raksha::xform_to_datalog {
 
 class ManifestDatalogFacts {
  public:
+  using DuplicateCounts = ir::ParticleSpec::DuplicateCounts;
+
   // A hacky class with just enough information about a particle instances for
   // the purpose of datalog generation. Specifically, instantiation_map is
   // passed to the `ToDatalog` methods. When the data structures are all fleshed
@@ -40,29 +47,57 @@ class ManifestDatalogFacts {
   // where the instance of a particle will be clear from the visit context.
   class Particle {
    public:
+    // Duplicates in `edges`, such as those drawn for two connections of the
+    // particle to the same handle, are dropped.
     Particle(const ir::ParticleSpec *spec,
              ir::DatalogPrintContext::AccessPathInstantiationMap
                  &&instantiation_map,
-             std::vector<ir::Edge> &&edges)
-        : spec_(spec), instantiation_map_(instantiation_map), edges_(edges) {}
+             std::vector<ir::Edge> &&edges, std::string recipe_name = "")
+        : spec_(spec),
+          instantiation_map_(instantiation_map),
+          edges_(edges),
+          recipe_name_(std::move(recipe_name)) {
+      num_duplicate_edges_ = utils::RemoveDuplicates(edges_);
+    }
 
     const ir::ParticleSpec *spec() const { return spec_; }
+    // The name of the recipe this particle belongs to, as used in its
+    // access paths.
+    const std::string &recipe_name() const { return recipe_name_; }
     const ir::DatalogPrintContext::AccessPathInstantiationMap &
     instantiation_map() const {
       return instantiation_map_;
     }
     const std::vector<ir::Edge> &edges() const { return edges_; }
+    // The number of duplicates dropped from the edges given to the
+    // constructor.
+    uint64_t num_duplicate_edges() const { return num_duplicate_edges_; }
 
    private:
     const ir::ParticleSpec *spec_;
     ir::DatalogPrintContext::AccessPathInstantiationMap instantiation_map_;
     std::vector<ir::Edge> edges_;
+    std::string recipe_name_;
+    uint64_t num_duplicate_edges_ = 0;
   };
 
   static ManifestDatalogFacts CreateFromManifestProto(
       const ir::SystemSpec& system_spec,
       const arcs::ManifestProto &manifest_proto);
 
+  // Instantiates the particles of a single recipe, whose access paths are
+  // rooted at `recipe_name`. Instantiating the recipes of a manifest one by
+  // one yields the particles of CreateFromManifestProto in the same order.
+  static ManifestDatalogFacts CreateFromRecipeProto(
+      const ir::SystemSpec &system_spec, const arcs::RecipeProto &recipe_proto,
+      const std::string &recipe_name);
+
+  // Returns the name of `recipe_proto` in access paths: its own name or, if
+  // it has none, one generated from `num_generated_names`, which is then
+  // incremented. The count starts at 0 for each manifest.
+  static std::string GetRecipeName(const arcs::RecipeProto &recipe_proto,
+                                   uint64_t &num_generated_names);
+
   // A default constructor creates a sensible, legal state (no facts) and
   // allows a bit more flexibility in constructing objects within which
   // ManifestDatalogFacts are embedded.
@@ -71,34 +106,90 @@ class ManifestDatalogFacts {
   ManifestDatalogFacts(std::vector<Particle> particle_instances)
       : particle_instances_(std::move(particle_instances)) {}
 
+  const std::vector<Particle> &particle_instances() const {
+    return particle_instances_;
+  }
+
+  // The sizes in bytes of the sections of the output of `ToDatalog`,
+  // excluding their headings.
+  struct SectionSizes {
+    uint64_t claims = 0;
+    uint64_t checks = 0;
+    uint64_t edges = 0;
+  };
+
+  // Returns the numbers of facts that are not printed because they duplicate
+  // others of the same particle: those of the duplicates dropped from the
+  // particle specs, once per particle, and the duplicate edges dropped from
+  // the particles. Facts of different particles never coincide, as their
+  // access paths are rooted at the particles.
+  DuplicateCounts GetNumDuplicates() const {
+    DuplicateCounts num_duplicates;
+    for (const auto &particle : particle_instances_) {
+      const DuplicateCounts &spec_duplicates =
+          particle.spec()->num_duplicates();
+      num_duplicates.tag_claims += spec_duplicates.tag_claims;
+      num_duplicates.checks += spec_duplicates.checks;
+      num_duplicates.edges +=
+          spec_duplicates.edges + particle.num_duplicate_edges();
+    }
+    return num_duplicates;
+  }
+
   // Print out all contained facts as a single datalog string. Note: this
   // does not contain the header files that would be necessary to run this
-  // against the datalog scripts; it contains only facts and comments.
+  // against the datalog scripts; it contains only facts and comments. If
+  // `section_sizes` is given, it is set to the sizes of the sections of the
+  // result.
   std::string ToDatalog(raksha::ir::DatalogPrintContext &ctxt,
-                        std::string separator = "\n") const {
-    std::string claims;
-    std::string checks;
-    std::string edges;
-    for (const auto &particle : particle_instances_) {
-      ctxt.set_instantiation_map(&particle.instantiation_map());
-      AppendElements(&claims, ctxt, particle.spec()->tag_claims(), separator);
-      AppendElements(&checks, ctxt, particle.spec()->checks(), separator);
-      AppendElements(&edges, ctxt, particle.edges(), separator);
-      AppendElements(&edges, ctxt, particle.spec()->edges(), separator);
-    }
+                        std::string separator = "\n",
+                        SectionSizes *section_sizes = nullptr) const {
+    std::ostringstream output;
+    WriteDatalog(ctxt, output, separator, section_sizes);
+    return output.str();
+  }
+
+  // Writes the output of `ToDatalog` to `output` one section and one
+  // particle at a time, so that only the facts of a single particle are
+  // held in memory.
+  void WriteDatalog(raksha::ir::DatalogPrintContext &ctxt,
+                    std::ostream &output, const std::string &separator = "\n",
+                    SectionSizes *section_sizes = nullptr) const {
+    std::string facts;
+    // Writes the facts that `append_facts` appends for each particle under
+    // `heading` and returns their size.
+    auto write_section = [&](absl::string_view heading, auto append_facts) {
+      uint64_t size = 0;
+      WriteSectionHeading(output, heading, separator);
+      for (const auto &particle : particle_instances_) {
+        ctxt.set_instantiation_map(&particle.instantiation_map());
+        facts.clear();
+        append_facts(particle);
+        size += facts.size();
+        output << facts;
+      }
+      output << separator;
+      return size;
+    };
+    SectionSizes sizes;
+    sizes.claims = write_section("Claims", [&](const Particle &particle) {
+      AppendElements(&facts, ctxt, particle.spec()->tag_claims(), separator);
+    });
+    sizes.checks = write_section("Checks", [&](const Particle &particle) {
+      AppendElements(&facts, ctxt, particle.spec()->checks(), separator);
+    });
+    sizes.edges = write_section("Edges", [&](const Particle &particle) {
+      AppendElements(&facts, ctxt, particle.edges(), separator);
+      AppendElements(&facts, ctxt, particle.spec()->edges(), separator);
+    });
+    if (section_sizes != nullptr) *section_sizes = sizes;
+  }
 
-    // Assemble the output and return the result.
-    std::string result;
-    absl::StrAppend(&result, absl::StrFormat("// Claims:%s", separator));
-    absl::StrAppend(&result, claims);
-    absl::StrAppend(&result, separator);
-    absl::StrAppend(&result, absl::StrFormat("// Checks:%s", separator));
-    absl::StrAppend(&result, checks);
-    absl::StrAppend(&result, separator);
-    absl::StrAppend(&result, absl::StrFormat("// Edges:%s", separator));
-    absl::StrAppend(&result, edges);
-    absl::StrAppend(&result, separator);
-    return result;
+  // Writes the heading of a section of the output of `ToDatalog`.
+  static void WriteSectionHeading(std::ostream &output,
+                                  absl::string_view heading,
+                                  const std::string &separator) {
+    output << "// " << heading << ":" << separator;
   }
 
  private:
@@ -86,6 +86,13 @@ static std::unique_ptr<ir::ParticleSpec> particle_spec(ir::ParticleSpec::Create(
     /*derives_from_claims=*/{},
     /*handle_connection_specs=*/GetHandleConnectionSpecs()));
 
+static std::unique_ptr<ir::ParticleSpec> midpoint_particle_spec(
+    ir::ParticleSpec::Create(
+        "particle", /*checks=*/{}, /*tag_claims=*/{},
+        /*derives_from_claims=*/{},
+        /*handle_connection_specs=*/GetHandleConnectionSpecs(),
+        ir::ParticleSpec::DefaultDerivationMode::kMidpoint));
+
 static std::tuple<ManifestDatalogFacts, std::string>
     datalog_facts_and_output_strings[] = {
         {ManifestDatalogFacts(),
@@ -124,12 +131,54 @@ edge("recipe.h1", "recipe.particle.in").
 edge("recipe.particle.out", "recipe.h2").
 edge("recipe.particle.in", "recipe.particle.out").
 
+)"},
+        {ManifestDatalogFacts({ManifestDatalogFacts::Particle(
+             midpoint_particle_spec.get(),
+             /*instantiation_map*/
+             {
+                 {ir::AccessPathRoot(
+                      ir::HandleConnectionSpecAccessPathRoot("particle", "in")),
+                  ir::AccessPathRoot(ir::HandleConnectionAccessPathRoot(
+                      "recipe", "particle", "in"))},
+                 {ir::AccessPathRoot(ir::HandleConnectionSpecAccessPathRoot(
+                      "particle", "out")),
+                  ir::AccessPathRoot(ir::HandleConnectionAccessPathRoot(
+                      "recipe", "particle", "out"))},
+                 {ir::ParticleSpec::GetMidpointAccessPathRoot("particle"),
+                  ir::AccessPathRoot(ir::HandleConnectionAccessPathRoot(
+                      "recipe", "particle", "$midpoint"))},
+             },
+             /*edges*/ {})}),
+         R"(// Claims:
+
+// Checks:
+
+// Edges:
+edge("recipe.particle.in", "recipe.particle.$midpoint").
+edge("recipe.particle.$midpoint", "recipe.particle.out").
+
 )"}};
 
 INSTANTIATE_TEST_SUITE_P(
     ManifestDatalogFactsToDatalogTest, ManifestDatalogFactsToDatalogTest,
     testing::ValuesIn(datalog_facts_and_output_strings));
 
+TEST(ManifestDatalogFactsToDatalogTest, ReportsSectionSizes) {
+  const ManifestDatalogFacts &datalog_facts =
+      std::get<0>(datalog_facts_and_output_strings[1]);
+  ir::DatalogPrintContext ctxt;
+  ManifestDatalogFacts::SectionSizes section_sizes;
+  std::string datalog = datalog_facts.ToDatalog(ctxt, "\n", &section_sizes);
+  EXPECT_GT(section_sizes.claims, 0);
+  EXPECT_GT(section_sizes.checks, 0);
+  EXPECT_GT(section_sizes.edges, 0);
+  // Each section is followed by an empty line and preceded by a heading.
+  EXPECT_EQ(datalog.size(),
+            section_sizes.claims + section_sizes.checks + section_sizes.edges +
+                strlen("// Claims:\n\n") + strlen("// Checks:\n\n") +
+                strlen("// Edges:\n\n"));
+}
+
 // Create a manifest textproto to test constructing ManifestDatalogFacts from
 // a ManifestProto. The ParticleSpecs will be pretty simple, as we have
 // tested creating ParticleSpecs from ParticleSpecProtos in more depth
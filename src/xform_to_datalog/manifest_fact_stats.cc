@@ -0,0 +1,465 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+#include "src/xform_to_datalog/manifest_fact_stats.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "src/ir/access_path_selectors_set.h"
+#include "src/ir/proto/type.h"
+#include "src/xform_to_datalog/access_path_graph.h"
+
+namespace raksha::xform_to_datalog {
+
+namespace {
+
+using Metrics = std::vector<std::pair<std::string, uint64_t>>;
+
+void AddParticle(const ManifestDatalogFacts::Particle &particle,
+                 ManifestFactStats::ParticleGroupStats &group) {
+  const ir::ParticleSpec &spec = *particle.spec();
+  ++group.num_particles;
+  group.num_connection_edges += particle.edges().size();
+  group.num_internal_edges += spec.edges().size();
+  group.num_default_derivation_edges += spec.num_default_derivation_edges();
+  group.num_checks += spec.checks().size();
+  group.num_claims += spec.tag_claims().size();
+}
+
+// Returns the groups in `groups_by_name`, ordered by `greater` and then by
+// name.
+template <typename Greater>
+std::vector<ManifestFactStats::ParticleGroupStats> SortGroups(
+    absl::flat_hash_map<std::string, ManifestFactStats::ParticleGroupStats>
+        groups_by_name,
+    Greater greater) {
+  std::vector<ManifestFactStats::ParticleGroupStats> groups;
+  for (auto &[name, group] : groups_by_name) {
+    groups.push_back(std::move(group));
+  }
+  std::sort(groups.begin(), groups.end(),
+            [&greater](const auto &lhs, const auto &rhs) {
+              if (greater(lhs, rhs)) return true;
+              if (greater(rhs, lhs)) return false;
+              return lhs.name < rhs.name;
+            });
+  return groups;
+}
+
+// The name under which the access paths of a connection of type
+// `type_proto` are counted.
+std::string SchemaName(const arcs::TypeProto &type_proto) {
+  if (!type_proto.has_entity()) return "<primitive>";
+  const arcs::SchemaProto &schema = type_proto.entity().schema();
+  return schema.names().empty() ? "<anonymous>" : schema.names(0);
+}
+
+std::vector<ManifestFactStats::SchemaStats> GetSchemaStats(
+    const arcs::ManifestProto &manifest_proto) {
+  absl::flat_hash_map<std::string, ManifestFactStats::SchemaStats>
+      schemas_by_name;
+  for (const arcs::RecipeProto &recipe_proto : manifest_proto.recipes()) {
+    for (const arcs::ParticleProto &particle_proto :
+         recipe_proto.particles()) {
+      for (const arcs::HandleConnectionProto &connection_proto :
+           particle_proto.connections()) {
+        std::string name = SchemaName(connection_proto.type());
+        uint64_t num_access_paths =
+            ir::AccessPathSelectorsSet::CreateAbslSet(
+                ir::types::proto::Decode(connection_proto.type())
+                    ->GetAccessPathSelectorsSet())
+                .size();
+        ManifestFactStats::SchemaStats &schema = schemas_by_name[name];
+        schema.name = std::move(name);
+        ++schema.num_connections;
+        schema.access_paths_per_connection =
+            std::max(schema.access_paths_per_connection, num_access_paths);
+        schema.num_access_paths += num_access_paths;
+      }
+    }
+  }
+  std::vector<ManifestFactStats::SchemaStats> schemas;
+  for (auto &[name, schema] : schemas_by_name) {
+    schemas.push_back(std::move(schema));
+  }
+  std::sort(schemas.begin(), schemas.end(),
+            [](const auto &lhs, const auto &rhs) {
+              return std::make_pair(rhs.num_access_paths, lhs.name) <
+                     std::make_pair(lhs.num_access_paths, rhs.name);
+            });
+  return schemas;
+}
+
+// Returns the histogram of `degree` over the nodes of `graph`. Bucket 0
+// holds degree 0 and bucket k > 0 holds degrees [2^(k-1), 2^k - 1].
+template <typename Degree>
+std::vector<ManifestFactStats::DegreeBucket> GetDegreeHistogram(
+    const AccessPathGraph &graph, Degree degree) {
+  std::vector<ManifestFactStats::DegreeBucket> histogram;
+  for (uint32_t node = 0; node < graph.num_nodes(); ++node) {
+    uint64_t node_degree = degree(node);
+    size_t bucket = 0;
+    while ((node_degree >> bucket) != 0) ++bucket;
+    while (histogram.size() <= bucket) {
+      size_t k = histogram.size();
+      histogram.push_back(ManifestFactStats::DegreeBucket{
+          .min_degree = (k == 0) ? 0 : (uint64_t{1} << (k - 1)),
+          .max_degree = (k == 0) ? 0 : (uint64_t{1} << k) - 1});
+    }
+    ++histogram[bucket].num_access_paths;
+  }
+  return histogram;
+}
+
+template <typename Degree>
+std::vector<ManifestFactStats::AccessPathDegree> GetTopDegrees(
+    const AccessPathGraph &graph, Degree degree, uint64_t top_n) {
+  std::vector<uint32_t> nodes(graph.num_nodes());
+  for (uint32_t node = 0; node < nodes.size(); ++node) nodes[node] = node;
+  auto middle = nodes.begin() + std::min<uint64_t>(top_n, nodes.size());
+  std::partial_sort(nodes.begin(), middle, nodes.end(),
+                    [&degree](uint32_t lhs, uint32_t rhs) {
+                      return std::make_pair(degree(rhs), lhs) <
+                             std::make_pair(degree(lhs), rhs);
+                    });
+  std::vector<ManifestFactStats::AccessPathDegree> result;
+  for (auto it = nodes.begin(); it != middle; ++it) {
+    result.push_back({.access_path = graph.name(*it), .degree = degree(*it)});
+  }
+  return result;
+}
+
+// Component sizes indexed by the smallest node of the component.
+using ComponentSizes = absl::flat_hash_map<uint32_t, uint64_t>;
+
+ComponentSizes GetWeaklyConnectedComponents(const AccessPathGraph &graph) {
+  // Union-find, where the smallest node of a set is its root.
+  std::vector<uint32_t> parent(graph.num_nodes());
+  for (uint32_t node = 0; node < parent.size(); ++node) parent[node] = node;
+  auto find = [&parent](uint32_t node) {
+    while (parent[node] != node) {
+      parent[node] = parent[parent[node]];
+      node = parent[node];
+    }
+    return node;
+  };
+  for (uint32_t node = 0; node < graph.num_nodes(); ++node) {
+    for (uint32_t successor : graph.successors(node)) {
+      uint32_t node_root = find(node);
+      uint32_t successor_root = find(successor);
+      if (node_root < successor_root) {
+        parent[successor_root] = node_root;
+      } else {
+        parent[node_root] = successor_root;
+      }
+    }
+  }
+  ComponentSizes sizes;
+  for (uint32_t node = 0; node < graph.num_nodes(); ++node) {
+    ++sizes[find(node)];
+  }
+  return sizes;
+}
+
+// Returns the sizes of the strongly connected components of `graph`.
+ComponentSizes GetStronglyConnectedComponentSizes(
+    const AccessPathGraph &graph) {
+  StronglyConnectedComponents sccs = GetStronglyConnectedComponents(graph);
+  constexpr uint32_t kNone = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> smallest(sccs.num_components(), kNone);
+  for (uint32_t node = 0; node < graph.num_nodes(); ++node) {
+    uint32_t &component_smallest = smallest[sccs.component_of_node[node]];
+    component_smallest = std::min(component_smallest, node);
+  }
+  ComponentSizes sizes;
+  for (uint32_t component = 0; component < sccs.num_components();
+       ++component) {
+    sizes[smallest[component]] = sccs.component_sizes[component];
+  }
+  return sizes;
+}
+
+// Returns the `top_n` largest of the components of at least `min_size`
+// nodes.
+std::vector<ManifestFactStats::Component> GetLargestComponents(
+    const AccessPathGraph &graph, const ComponentSizes &sizes,
+    uint64_t min_size, uint64_t top_n) {
+  std::vector<std::pair<uint64_t, uint32_t>> components;
+  for (const auto &[node, size] : sizes) {
+    if (size >= min_size) components.push_back({size, node});
+  }
+  auto middle =
+      components.begin() + std::min<uint64_t>(top_n, components.size());
+  std::partial_sort(components.begin(), middle, components.end(),
+                    [](const auto &lhs, const auto &rhs) {
+                      return std::make_pair(rhs.first, lhs.second) <
+                             std::make_pair(lhs.first, rhs.second);
+                    });
+  std::vector<ManifestFactStats::Component> result;
+  for (auto it = components.begin(); it != middle; ++it) {
+    result.push_back(
+        {.representative = graph.name(it->second), .size = it->first});
+  }
+  return result;
+}
+
+Metrics GroupMetrics(const ManifestFactStats::ParticleGroupStats &group) {
+  return {{"particles", group.num_particles},
+          {"edges", group.NumEdges()},
+          {"connection_edges", group.num_connection_edges},
+          {"internal_edges", group.num_internal_edges},
+          {"default_derivation_edges", group.num_default_derivation_edges},
+          {"checks", group.num_checks},
+          {"claims", group.num_claims}};
+}
+
+Metrics SchemaMetrics(const ManifestFactStats::SchemaStats &schema) {
+  return {{"connections", schema.num_connections},
+          {"access_paths_per_connection", schema.access_paths_per_connection},
+          {"access_paths", schema.num_access_paths}};
+}
+
+std::string BucketName(const ManifestFactStats::DegreeBucket &bucket) {
+  return absl::StrCat(bucket.min_degree, "-", bucket.max_degree);
+}
+
+std::string JsonString(absl::string_view value) {
+  return absl::StrCat(
+      "\"", absl::StrReplaceAll(value, {{"\\", "\\\\"}, {"\"", "\\\""}}),
+      "\"");
+}
+
+// Renders a list of JSON objects, each with a name field and the metrics of
+// one element of `elements`.
+template <typename T, typename GetName, typename GetMetrics>
+std::string JsonList(const std::vector<T> &elements,
+                     absl::string_view name_field, GetName get_name,
+                     GetMetrics get_metrics) {
+  if (elements.empty()) return "[]";
+  auto formatter = [&](std::string *out, const T &element) {
+    auto metric_formatter = [](std::string *out, const auto &metric) {
+      absl::StrAppend(out, JsonString(metric.first), ": ", metric.second);
+    };
+    absl::StrAppend(out, "    {", JsonString(name_field), ": ",
+                    JsonString(get_name(element)), ", ",
+                    absl::StrJoin(get_metrics(element), ", ",
+                                  metric_formatter),
+                    "}");
+  };
+  return absl::StrCat("[\n", absl::StrJoin(elements, ",\n", formatter),
+                      "\n  ]");
+}
+
+std::string CsvField(absl::string_view value) {
+  if (value.find_first_of(",\"\n") == absl::string_view::npos) {
+    return std::string(value);
+  }
+  return absl::StrCat("\"", absl::StrReplaceAll(value, {{"\"", "\"\""}}),
+                      "\"");
+}
+
+template <typename T, typename GetName, typename GetMetrics>
+void AppendCsvRows(std::string *out, absl::string_view section,
+                   const std::vector<T> &elements, GetName get_name,
+                   GetMetrics get_metrics) {
+  for (const T &element : elements) {
+    std::string name = CsvField(get_name(element));
+    for (const auto &[metric, value] : get_metrics(element)) {
+      absl::StrAppend(out, section, ",", name, ",", metric, ",", value,
+                      "\n");
+    }
+  }
+}
+
+std::string GetGroupName(const ManifestFactStats::ParticleGroupStats &group) {
+  return group.name;
+}
+
+std::string GetSchemaName(const ManifestFactStats::SchemaStats &schema) {
+  return schema.name;
+}
+
+std::string GetAccessPath(const ManifestFactStats::AccessPathDegree &degree) {
+  return degree.access_path;
+}
+
+Metrics GetDegreeMetrics(const ManifestFactStats::AccessPathDegree &degree) {
+  return {{"degree", degree.degree}};
+}
+
+Metrics GetBucketMetrics(const ManifestFactStats::DegreeBucket &bucket) {
+  return {{"min_degree", bucket.min_degree},
+          {"max_degree", bucket.max_degree},
+          {"access_paths", bucket.num_access_paths}};
+}
+
+// The bucket bounds are already in the name column of the CSV rows.
+Metrics GetCsvBucketMetrics(const ManifestFactStats::DegreeBucket &bucket) {
+  return {{"access_paths", bucket.num_access_paths}};
+}
+
+std::string GetRepresentative(const ManifestFactStats::Component &component) {
+  return component.representative;
+}
+
+Metrics GetComponentMetrics(const ManifestFactStats::Component &component) {
+  return {{"size", component.size}};
+}
+
+}  // namespace
+
+ManifestFactStats ManifestFactStats::Create(
+    const arcs::ManifestProto &manifest_proto,
+    const ManifestDatalogFacts &facts, uint64_t top_n) {
+  ManifestFactStats stats;
+  AccessPathGraph graph;
+  absl::flat_hash_map<std::string, ParticleGroupStats> specs_by_name;
+  absl::flat_hash_map<std::string, ParticleGroupStats> recipes_by_name;
+  for (const ManifestDatalogFacts::Particle &particle :
+       facts.particle_instances()) {
+    graph.AddParticle(particle);
+    ParticleGroupStats &spec = specs_by_name[particle.spec()->name()];
+    spec.name = particle.spec()->name();
+    AddParticle(particle, spec);
+    ParticleGroupStats &recipe = recipes_by_name[particle.recipe_name()];
+    recipe.name = particle.recipe_name();
+    AddParticle(particle, recipe);
+    stats.num_checks_ += particle.spec()->checks().size();
+    stats.num_claims_ += particle.spec()->tag_claims().size();
+  }
+  stats.num_access_paths_ = graph.num_nodes();
+  stats.num_edges_ = graph.num_edges();
+
+  auto more_edges = [](const ParticleGroupStats &lhs,
+                       const ParticleGroupStats &rhs) {
+    return lhs.NumEdges() > rhs.NumEdges();
+  };
+  stats.particle_specs_ = SortGroups(specs_by_name, more_edges);
+  stats.recipes_ = SortGroups(std::move(recipes_by_name), more_edges);
+  stats.top_default_derivation_specs_ = SortGroups(
+      std::move(specs_by_name),
+      [](const ParticleGroupStats &lhs, const ParticleGroupStats &rhs) {
+        return lhs.num_default_derivation_edges >
+               rhs.num_default_derivation_edges;
+      });
+  if (stats.top_default_derivation_specs_.size() > top_n) {
+    stats.top_default_derivation_specs_.resize(top_n);
+  }
+  stats.schemas_ = GetSchemaStats(manifest_proto);
+
+  auto fan_in = [&graph](uint32_t node) { return graph.fan_in(node); };
+  auto fan_out = [&graph](uint32_t node) { return graph.fan_out(node); };
+  stats.fan_in_histogram_ = GetDegreeHistogram(graph, fan_in);
+  stats.fan_out_histogram_ = GetDegreeHistogram(graph, fan_out);
+  stats.top_fan_in_ = GetTopDegrees(graph, fan_in, top_n);
+  stats.top_fan_out_ = GetTopDegrees(graph, fan_out, top_n);
+
+  ComponentSizes components = GetWeaklyConnectedComponents(graph);
+  stats.num_components_ = components.size();
+  stats.largest_components_ =
+      GetLargestComponents(graph, components, /*min_size=*/1, top_n);
+  ComponentSizes sccs = GetStronglyConnectedComponentSizes(graph);
+  stats.num_cyclic_sccs_ =
+      std::count_if(sccs.begin(), sccs.end(),
+                    [](const auto &scc) { return scc.second > 1; });
+  stats.largest_sccs_ =
+      GetLargestComponents(graph, sccs, /*min_size=*/2, top_n);
+  return stats;
+}
+
+std::string ManifestFactStats::ToJson() const {
+  std::string result = "{\n";
+  absl::StrAppend(&result, "  \"access_paths\": ", num_access_paths_, ",\n",
+                  "  \"edges\": ", num_edges_, ",\n", "  \"checks\": ",
+                  num_checks_, ",\n", "  \"claims\": ", num_claims_, ",\n");
+  absl::StrAppend(
+      &result, "  \"particle_specs\": ",
+      JsonList(particle_specs_, "name", GetGroupName, GroupMetrics), ",\n");
+  absl::StrAppend(&result, "  \"recipes\": ",
+                  JsonList(recipes_, "name", GetGroupName, GroupMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"top_default_derivation_specs\": ",
+                  JsonList(top_default_derivation_specs_, "name",
+                           GetGroupName, GroupMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"schemas\": ",
+                  JsonList(schemas_, "name", GetSchemaName, SchemaMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"fan_in_histogram\": ",
+                  JsonList(fan_in_histogram_, "bucket", BucketName,
+                           GetBucketMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"fan_out_histogram\": ",
+                  JsonList(fan_out_histogram_, "bucket", BucketName,
+                           GetBucketMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"top_fan_in\": ",
+                  JsonList(top_fan_in_, "access_path", GetAccessPath,
+                           GetDegreeMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"top_fan_out\": ",
+                  JsonList(top_fan_out_, "access_path", GetAccessPath,
+                           GetDegreeMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"components\": ", num_components_, ",\n",
+                  "  \"largest_components\": ",
+                  JsonList(largest_components_, "representative",
+                           GetRepresentative, GetComponentMetrics),
+                  ",\n");
+  absl::StrAppend(&result, "  \"cyclic_sccs\": ", num_cyclic_sccs_, ",\n",
+                  "  \"largest_sccs\": ",
+                  JsonList(largest_sccs_, "representative", GetRepresentative,
+                           GetComponentMetrics),
+                  "\n");
+  absl::StrAppend(&result, "}\n");
+  return result;
+}
+
+std::string ManifestFactStats::ToCsv() const {
+  std::string result = "section,name,metric,value\n";
+  absl::StrAppend(&result, "graph,,access_paths,", num_access_paths_, "\n",
+                  "graph,,edges,", num_edges_, "\n", "graph,,checks,",
+                  num_checks_, "\n", "graph,,claims,", num_claims_, "\n",
+                  "graph,,components,", num_components_, "\n",
+                  "graph,,cyclic_sccs,", num_cyclic_sccs_, "\n");
+  AppendCsvRows(&result, "particle_spec", particle_specs_, GetGroupName,
+                GroupMetrics);
+  AppendCsvRows(&result, "recipe", recipes_, GetGroupName, GroupMetrics);
+  AppendCsvRows(&result, "top_default_derivation_spec",
+                top_default_derivation_specs_, GetGroupName, GroupMetrics);
+  AppendCsvRows(&result, "schema", schemas_, GetSchemaName, SchemaMetrics);
+  AppendCsvRows(&result, "fan_in_histogram", fan_in_histogram_, BucketName,
+                GetCsvBucketMetrics);
+  AppendCsvRows(&result, "fan_out_histogram", fan_out_histogram_, BucketName,
+                GetCsvBucketMetrics);
+  AppendCsvRows(&result, "top_fan_in", top_fan_in_, GetAccessPath,
+                GetDegreeMetrics);
+  AppendCsvRows(&result, "top_fan_out", top_fan_out_, GetAccessPath,
+                GetDegreeMetrics);
+  AppendCsvRows(&result, "component", largest_components_, GetRepresentative,
+                GetComponentMetrics);
+  AppendCsvRows(&result, "scc", largest_sccs_, GetRepresentative,
+                GetComponentMetrics);
+  return result;
+}
+
+}  // namespace raksha::xform_to_datalog
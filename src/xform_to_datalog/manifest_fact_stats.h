@@ -0,0 +1,157 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_MANIFEST_FACT_STATS_H_
+#define SRC_XFORM_TO_DATALOG_MANIFEST_FACT_STATS_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "third_party/arcs/proto/manifest.pb.h"
+
+namespace raksha::xform_to_datalog {
+
+// Statistics about the dataflow graph instantiated from a manifest. These
+// point at the particle specs, recipes, schemas and access paths that make
+// the analysis of a manifest expensive, without running the analysis.
+class ManifestFactStats {
+ public:
+  // The facts contributed by the particles of a single ParticleSpec or
+  // recipe.
+  struct ParticleGroupStats {
+    std::string name;
+    uint64_t num_particles = 0;
+    // Edges between handles and the handle connections of the particles.
+    uint64_t num_connection_edges = 0;
+    // Edges within the particles, as drawn by ParticleSpec::GenerateEdges.
+    uint64_t num_internal_edges = 0;
+    // The part of num_internal_edges drawn by the default-derivation rule.
+    uint64_t num_default_derivation_edges = 0;
+    uint64_t num_checks = 0;
+    uint64_t num_claims = 0;
+
+    uint64_t NumEdges() const {
+      return num_connection_edges + num_internal_edges;
+    }
+  };
+
+  // The access paths instantiated for the handle connections of a schema.
+  // Connections with a primitive type are grouped under "<primitive>" and
+  // those with an unnamed schema under "<anonymous>".
+  struct SchemaStats {
+    std::string name;
+    uint64_t num_connections = 0;
+    // The most access paths instantiated for a single connection.
+    uint64_t access_paths_per_connection = 0;
+    uint64_t num_access_paths = 0;
+  };
+
+  // The number of access paths whose fan-in or fan-out lies in
+  // [min_degree, max_degree]. Buckets double in width.
+  struct DegreeBucket {
+    uint64_t min_degree = 0;
+    uint64_t max_degree = 0;
+    uint64_t num_access_paths = 0;
+  };
+
+  // An access path together with its fan-in or fan-out.
+  struct AccessPathDegree {
+    std::string access_path;
+    uint64_t degree = 0;
+  };
+
+  // A component or SCC of the graph, named after its first access path.
+  struct Component {
+    std::string representative;
+    uint64_t size = 0;
+  };
+
+  // Computes the statistics of the facts instantiated from
+  // `manifest_proto`. Rankings are cut off after `top_n` entries.
+  static ManifestFactStats Create(const arcs::ManifestProto &manifest_proto,
+                                  const ManifestDatalogFacts &facts,
+                                  uint64_t top_n = 10);
+
+  uint64_t num_access_paths() const { return num_access_paths_; }
+  uint64_t num_edges() const { return num_edges_; }
+  uint64_t num_checks() const { return num_checks_; }
+  uint64_t num_claims() const { return num_claims_; }
+  // Sorted by decreasing number of edges.
+  const std::vector<ParticleGroupStats> &particle_specs() const {
+    return particle_specs_;
+  }
+  const std::vector<ParticleGroupStats> &recipes() const { return recipes_; }
+  // The particle specs with the most default-derivation edges, in
+  // decreasing order.
+  const std::vector<ParticleGroupStats> &top_default_derivation_specs()
+      const {
+    return top_default_derivation_specs_;
+  }
+  // Sorted by decreasing number of access paths.
+  const std::vector<SchemaStats> &schemas() const { return schemas_; }
+  const std::vector<DegreeBucket> &fan_in_histogram() const {
+    return fan_in_histogram_;
+  }
+  const std::vector<DegreeBucket> &fan_out_histogram() const {
+    return fan_out_histogram_;
+  }
+  const std::vector<AccessPathDegree> &top_fan_in() const {
+    return top_fan_in_;
+  }
+  const std::vector<AccessPathDegree> &top_fan_out() const {
+    return top_fan_out_;
+  }
+  // The number of weakly connected components and the largest of them.
+  uint64_t num_components() const { return num_components_; }
+  const std::vector<Component> &largest_components() const {
+    return largest_components_;
+  }
+  // The number of strongly connected components with more than one access
+  // path, that is, of dataflow cycles, and the largest of them.
+  uint64_t num_cyclic_sccs() const { return num_cyclic_sccs_; }
+  const std::vector<Component> &largest_sccs() const { return largest_sccs_; }
+
+  // Returns the statistics as a JSON object.
+  std::string ToJson() const;
+
+  // Returns the statistics as CSV with the columns section, name, metric and
+  // value, one row per number.
+  std::string ToCsv() const;
+
+ private:
+  uint64_t num_access_paths_ = 0;
+  uint64_t num_edges_ = 0;
+  uint64_t num_checks_ = 0;
+  uint64_t num_claims_ = 0;
+  std::vector<ParticleGroupStats> particle_specs_;
+  std::vector<ParticleGroupStats> recipes_;
+  std::vector<ParticleGroupStats> top_default_derivation_specs_;
+  std::vector<SchemaStats> schemas_;
+  std::vector<DegreeBucket> fan_in_histogram_;
+  std::vector<DegreeBucket> fan_out_histogram_;
+  std::vector<AccessPathDegree> top_fan_in_;
+  std::vector<AccessPathDegree> top_fan_out_;
+  uint64_t num_components_ = 0;
+  std::vector<Component> largest_components_;
+  uint64_t num_cyclic_sccs_ = 0;
+  std::vector<Component> largest_sccs_;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_MANIFEST_FACT_STATS_H_
@@ -0,0 +1,185 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+#include "src/xform_to_datalog/manifest_fact_stats.h"
+
+#include <google/protobuf/text_format.h>
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/proto/system_spec.h"
+
+namespace raksha::xform_to_datalog {
+
+// Two Relay particles in recipe R pass data from h1 to h2 and back, forming
+// a cycle. A Fan particle in recipe S reads and writes the two fields of a
+// Pair, drawing 2 * 2 default-derivation edges.
+static const std::string kManifestTextproto = R"(
+    particle_specs: [
+    { name: "Relay" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } },
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: { particle_spec: "Relay", handle_connection: "out" } }
+            predicate: { label: { semantic_tag: "tag"} } } } ] },
+    { name: "Fan" connections: [
+        { name: "in" direction: READS type: {
+            entity: { schema: { fields: [
+              { key: "a" value: { primitive: TEXT } },
+              { key: "b" value: { primitive: TEXT } } ] } } } },
+        { name: "out" direction: WRITES type: {
+            entity: { schema: { fields: [
+              { key: "a" value: { primitive: TEXT } },
+              { key: "b" value: { primitive: TEXT } } ] } } } } ]
+      checks: [
+        { access_path: {
+            handle: { particle_spec: "Fan", handle_connection: "in" }
+            selectors: { field: "a" } }
+          predicate: { label: { semantic_tag: "tag"} } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Relay" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } },
+              { name: "out" handle: "h2" type: { primitive: TEXT } } ] },
+          { spec_name: "Relay" connections: [
+              { name: "in" handle: "h2" type: { primitive: TEXT } },
+              { name: "out" handle: "h1" type: { primitive: TEXT } } ] } ] },
+      { name: "S"
+        particles: [
+          { spec_name: "Fan" connections: [
+              { name: "in" handle: "h3" type: {
+                  entity: { schema: { names: ["Pair"] fields: [
+                    { key: "a" value: { primitive: TEXT } },
+                    { key: "b" value: { primitive: TEXT } } ] } } } },
+              { name: "out" handle: "h4" type: {
+                  entity: { schema: { names: ["Pair"] fields: [
+                    { key: "a" value: { primitive: TEXT } },
+                    { key: "b" value: { primitive: TEXT } } ] } } } } ] } ] } ]
+)";
+
+class ManifestFactStatsTest : public testing::Test {
+ public:
+  ManifestFactStatsTest() {
+    arcs::ManifestProto manifest_proto;
+    CHECK(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                        &manifest_proto));
+    system_spec_ = ir::proto::Decode(manifest_proto);
+    CHECK(system_spec_ != nullptr);
+    ManifestDatalogFacts facts = ManifestDatalogFacts::CreateFromManifestProto(
+        *system_spec_, manifest_proto);
+    stats_ = ManifestFactStats::Create(manifest_proto, facts, /*top_n=*/1);
+  }
+
+ protected:
+  std::unique_ptr<ir::SystemSpec> system_spec_;
+  ManifestFactStats stats_;
+};
+
+TEST_F(ManifestFactStatsTest, CountsFacts) {
+  EXPECT_EQ(stats_.num_access_paths(), 14);
+  EXPECT_EQ(stats_.num_edges(), 14);
+  EXPECT_EQ(stats_.num_checks(), 1);
+  EXPECT_EQ(stats_.num_claims(), 2);
+}
+
+TEST_F(ManifestFactStatsTest, CountsFactsPerParticleSpecAndRecipe) {
+  ASSERT_EQ(stats_.particle_specs().size(), 2);
+  const ManifestFactStats::ParticleGroupStats &fan =
+      stats_.particle_specs().at(0);
+  EXPECT_EQ(fan.name, "Fan");
+  EXPECT_EQ(fan.num_particles, 1);
+  EXPECT_EQ(fan.num_connection_edges, 4);
+  EXPECT_EQ(fan.num_internal_edges, 4);
+  EXPECT_EQ(fan.num_default_derivation_edges, 4);
+  EXPECT_EQ(fan.num_checks, 1);
+  EXPECT_EQ(fan.num_claims, 0);
+  const ManifestFactStats::ParticleGroupStats &relay =
+      stats_.particle_specs().at(1);
+  EXPECT_EQ(relay.name, "Relay");
+  EXPECT_EQ(relay.num_particles, 2);
+  EXPECT_EQ(relay.NumEdges(), 6);
+  EXPECT_EQ(relay.num_claims, 2);
+
+  ASSERT_EQ(stats_.recipes().size(), 2);
+  EXPECT_EQ(stats_.recipes().at(0).name, "S");
+  EXPECT_EQ(stats_.recipes().at(0).NumEdges(), 8);
+  EXPECT_EQ(stats_.recipes().at(1).name, "R");
+  EXPECT_EQ(stats_.recipes().at(1).NumEdges(), 6);
+
+  ASSERT_EQ(stats_.top_default_derivation_specs().size(), 1);
+  EXPECT_EQ(stats_.top_default_derivation_specs().at(0).name, "Fan");
+}
+
+TEST_F(ManifestFactStatsTest, CountsAccessPathsPerSchema) {
+  ASSERT_EQ(stats_.schemas().size(), 2);
+  EXPECT_EQ(stats_.schemas().at(0).name, "<primitive>");
+  EXPECT_EQ(stats_.schemas().at(0).num_connections, 4);
+  EXPECT_EQ(stats_.schemas().at(0).num_access_paths, 4);
+  EXPECT_EQ(stats_.schemas().at(1).name, "Pair");
+  EXPECT_EQ(stats_.schemas().at(1).num_connections, 2);
+  EXPECT_EQ(stats_.schemas().at(1).access_paths_per_connection, 2);
+  EXPECT_EQ(stats_.schemas().at(1).num_access_paths, 4);
+}
+
+TEST_F(ManifestFactStatsTest, ComputesDegreeHistograms) {
+  // h3.a and h3.b have no incoming edges, the outputs of Fan have two.
+  ASSERT_EQ(stats_.fan_in_histogram().size(), 3);
+  EXPECT_EQ(stats_.fan_in_histogram().at(0).num_access_paths, 2);
+  EXPECT_EQ(stats_.fan_in_histogram().at(1).num_access_paths, 10);
+  EXPECT_EQ(stats_.fan_in_histogram().at(2).min_degree, 2);
+  EXPECT_EQ(stats_.fan_in_histogram().at(2).max_degree, 3);
+  EXPECT_EQ(stats_.fan_in_histogram().at(2).num_access_paths, 2);
+  ASSERT_EQ(stats_.top_fan_in().size(), 1);
+  EXPECT_EQ(stats_.top_fan_in().at(0).degree, 2);
+  EXPECT_THAT(stats_.top_fan_in().at(0).access_path,
+              testing::StartsWith("S.Fan#0.out."));
+
+  ASSERT_EQ(stats_.fan_out_histogram().size(), 3);
+  EXPECT_EQ(stats_.fan_out_histogram().at(0).num_access_paths, 2);
+  ASSERT_EQ(stats_.top_fan_out().size(), 1);
+  EXPECT_THAT(stats_.top_fan_out().at(0).access_path,
+              testing::StartsWith("S.Fan#0.in."));
+}
+
+TEST_F(ManifestFactStatsTest, FindsComponentsAndCycles) {
+  EXPECT_EQ(stats_.num_components(), 2);
+  ASSERT_EQ(stats_.largest_components().size(), 1);
+  EXPECT_EQ(stats_.largest_components().at(0).size, 8);
+
+  EXPECT_EQ(stats_.num_cyclic_sccs(), 1);
+  ASSERT_EQ(stats_.largest_sccs().size(), 1);
+  EXPECT_EQ(stats_.largest_sccs().at(0).representative, "R.h1");
+  EXPECT_EQ(stats_.largest_sccs().at(0).size, 6);
+}
+
+TEST_F(ManifestFactStatsTest, RendersJsonAndCsv) {
+  std::string json = stats_.ToJson();
+  EXPECT_THAT(json, testing::HasSubstr(R"("edges": 14,)"));
+  EXPECT_THAT(json,
+              testing::HasSubstr(
+                  R"({"name": "Relay", "particles": 2, "edges": 6, )"));
+  EXPECT_THAT(json, testing::HasSubstr(
+                        R"({"representative": "R.h1", "size": 6})"));
+
+  std::string csv = stats_.ToCsv();
+  EXPECT_THAT(csv, testing::StartsWith("section,name,metric,value\n"));
+  EXPECT_THAT(csv, testing::HasSubstr("recipe,S,edges,8\n"));
+  EXPECT_THAT(csv, testing::HasSubstr("schema,Pair,access_paths,4\n"));
+  EXPECT_THAT(csv, testing::HasSubstr("fan_in_histogram,2-3,access_paths,2\n"));
+}
+
+}  // namespace raksha::xform_to_datalog
@@ -0,0 +1,386 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/policy_bundle.h"
+
+#include <cstring>
+#include <sstream>
+#include <type_traits>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/edge.h"
+#include "src/ir/tag_check.h"
+#include "src/ir/tag_claim.h"
+
+namespace raksha::xform_to_datalog {
+
+namespace {
+
+constexpr char kMagic[8] = {'R', 'A', 'K', 'S', 'H', 'A', 'P', 'B'};
+// Written in the byte order of the compiling host, to detect bundles from
+// hosts of the other one.
+constexpr uint32_t kByteOrderMark = 0x01020304;
+// The alignment of every section, which is enough for all records.
+constexpr uint64_t kSectionAlignment = 8;
+
+// The records refer to strings by their index in the string table.
+struct ClaimRecord {
+  uint32_t claim_tag_is_present;
+  uint32_t claiming_particle_name;
+  uint32_t access_path;
+  uint32_t tag;
+};
+
+struct CheckRecord {
+  // The isCheck and check facts, as printed by the compile step.
+  uint32_t access_path;
+  uint32_t rule_body;
+  // The CheckSource of the check.
+  uint32_t recipe;
+  uint32_t particle;
+  uint32_t particle_spec;
+  uint32_t handle_connection;
+  uint32_t source_access_path;
+  uint32_t source_predicate;
+};
+
+struct EdgeRecord {
+  uint32_t from;
+  uint32_t to;
+};
+
+// A range of records, `count` of them starting at `offset` in the file.
+struct PolicyBundleSection {
+  uint64_t offset;
+  uint64_t count;
+};
+
+struct PolicyBundleSections {
+  // `string_offsets` has one more entry than there are strings: string `i`
+  // is the range [string_offsets[i], string_offsets[i + 1]) of
+  // `string_bytes`.
+  PolicyBundleSection string_offsets;
+  PolicyBundleSection string_bytes;
+  PolicyBundleSection claims;
+  PolicyBundleSection checks;
+  PolicyBundleSection edges;
+};
+
+}  // namespace
+
+struct PolicyBundle::Header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order_mark;
+  uint32_t default_derivation_mode;
+  uint32_t padding;
+  PolicyBundleSections sections;
+};
+
+namespace {
+
+// Collects the strings and records of a bundle and lays them out.
+class PolicyBundleBuilder {
+ public:
+  uint32_t Intern(absl::string_view value) {
+    auto [it, inserted] =
+        string_indices_.try_emplace(value, string_offsets_.size() - 1);
+    if (inserted) {
+      string_bytes_.insert(string_bytes_.end(), value.begin(), value.end());
+      string_offsets_.push_back(string_bytes_.size());
+    }
+    return it->second;
+  }
+
+  std::vector<ClaimRecord> &claims() { return claims_; }
+  std::vector<CheckRecord> &checks() { return checks_; }
+  std::vector<EdgeRecord> &edges() { return edges_; }
+
+  // Appends the sections to `result`, which holds the header, and returns
+  // where they are.
+  PolicyBundleSections Build(std::string &result) {
+    PolicyBundleSections sections;
+    sections.string_offsets = Append(result, string_offsets_);
+    sections.string_bytes = Append(result, string_bytes_);
+    sections.claims = Append(result, claims_);
+    sections.checks = Append(result, checks_);
+    sections.edges = Append(result, edges_);
+    return sections;
+  }
+
+ private:
+  template <typename Record>
+  static PolicyBundleSection Append(std::string &result,
+                                    const std::vector<Record> &records) {
+    static_assert(std::is_trivially_copyable_v<Record>);
+    result.resize((result.size() + kSectionAlignment - 1) /
+                  kSectionAlignment * kSectionAlignment);
+    PolicyBundleSection section{.offset = result.size(),
+                                .count = records.size()};
+    result.append(reinterpret_cast<const char *>(records.data()),
+                  records.size() * sizeof(Record));
+    return section;
+  }
+
+  // The string table: string `i` is the range [string_offsets_[i],
+  // string_offsets_[i + 1]) of `string_bytes_`.
+  std::vector<uint64_t> string_offsets_ = {0};
+  std::vector<char> string_bytes_;
+  absl::flat_hash_map<std::string, uint32_t> string_indices_;
+  std::vector<ClaimRecord> claims_;
+  std::vector<CheckRecord> checks_;
+  std::vector<EdgeRecord> edges_;
+};
+
+// Whether `section` lies within a file of `file_size` bytes and is aligned
+// for its records.
+template <typename Record>
+bool IsValidSection(const PolicyBundleSection &section, uint64_t file_size) {
+  return section.offset % kSectionAlignment == 0 &&
+         section.offset <= file_size &&
+         section.count <= (file_size - section.offset) / sizeof(Record);
+}
+
+}  // namespace
+
+std::string PolicyBundle::Compile(
+    const ManifestDatalogFacts &manifest_facts,
+    ir::ParticleSpec::DefaultDerivationMode default_derivation_mode) {
+  PolicyBundleBuilder builder;
+  // The facts are printed in the order of ManifestDatalogFacts::ToDatalog,
+  // section by section.
+  ir::DatalogPrintContext ctxt;
+  for (const auto &particle : manifest_facts.particle_instances()) {
+    ctxt.set_instantiation_map(&particle.instantiation_map());
+    for (const ir::TagClaim &claim : particle.spec()->tag_claims()) {
+      uint32_t claiming_particle_name =
+          builder.Intern(claim.claiming_particle_name());
+      uint32_t access_path =
+          builder.Intern(claim.access_path().ToDatalog(ctxt));
+      builder.claims().push_back(ClaimRecord{
+          .claim_tag_is_present = claim.claim_tag_is_present(),
+          .claiming_particle_name = claiming_particle_name,
+          .access_path = access_path,
+          .tag = builder.Intern(claim.tag())});
+    }
+  }
+  for (const auto &particle : manifest_facts.particle_instances()) {
+    ctxt.set_instantiation_map(&particle.instantiation_map());
+    for (const ir::TagCheck &check : particle.spec()->checks()) {
+      uint32_t access_path =
+          builder.Intern(check.access_path().ToDatalog(ctxt));
+      uint32_t rule_body = builder.Intern(
+          check.predicate().ToDatalogRuleBody(check.access_path(), ctxt));
+      CheckSource source = CheckSources::GetCheckSource(particle, check, ctxt);
+      builder.checks().push_back(CheckRecord{
+          .access_path = access_path,
+          .rule_body = rule_body,
+          .recipe = builder.Intern(source.recipe),
+          .particle = builder.Intern(source.particle),
+          .particle_spec = builder.Intern(source.particle_spec),
+          .handle_connection = builder.Intern(source.handle_connection),
+          .source_access_path = builder.Intern(source.access_path),
+          .source_predicate = builder.Intern(source.predicate)});
+    }
+  }
+  for (const auto &particle : manifest_facts.particle_instances()) {
+    ctxt.set_instantiation_map(&particle.instantiation_map());
+    auto add_edge = [&](const ir::AccessPath &from, const ir::AccessPath &to) {
+      uint32_t from_index = builder.Intern(from.ToDatalog(ctxt));
+      builder.edges().push_back(EdgeRecord{
+          .from = from_index, .to = builder.Intern(to.ToDatalog(ctxt))});
+    };
+    for (const ir::Edge &edge : particle.edges()) {
+      add_edge(edge.from(), edge.to());
+    }
+    for (const ir::Edge &edge : particle.spec()->edges()) {
+      add_edge(edge.from(), edge.to());
+    }
+  }
+
+  Header header{};
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kVersion;
+  header.byte_order_mark = kByteOrderMark;
+  header.default_derivation_mode =
+      static_cast<uint32_t>(default_derivation_mode);
+  std::string result(sizeof(header), '\0');
+  header.sections = builder.Build(result);
+  std::memcpy(result.data(), &header, sizeof(header));
+  return result;
+}
+
+std::unique_ptr<PolicyBundle> PolicyBundle::Load(
+    const std::filesystem::path &path) {
+  // The records are read in place, in order of the facts.
+  std::unique_ptr<utils::MappedFile> mapped_file =
+      utils::MappedFile::Open(path, MADV_SEQUENTIAL);
+  if (mapped_file == nullptr) return nullptr;
+  if (mapped_file->size() < sizeof(Header) ||
+      std::memcmp(mapped_file->data(), kMagic, sizeof(kMagic)) != 0) {
+    LOG(ERROR) << path << " is not a policy bundle.";
+    return nullptr;
+  }
+  std::unique_ptr<PolicyBundle> bundle(
+      new PolicyBundle(std::move(mapped_file)));
+  const Header &header = bundle->header();
+  if (header.version != kVersion ||
+      header.byte_order_mark != kByteOrderMark) {
+    LOG(ERROR) << "The policy bundle " << path << " has version "
+               << header.version << " or another byte order; version "
+               << kVersion << " is expected. Compile it again.";
+    return nullptr;
+  }
+  uint64_t file_size = bundle->file_size();
+  if (!IsValidSection<uint64_t>(header.sections.string_offsets, file_size) ||
+      header.sections.string_offsets.count == 0 ||
+      !IsValidSection<char>(header.sections.string_bytes, file_size) ||
+      !IsValidSection<ClaimRecord>(header.sections.claims, file_size) ||
+      !IsValidSection<CheckRecord>(header.sections.checks, file_size) ||
+      !IsValidSection<EdgeRecord>(header.sections.edges, file_size) ||
+      header.default_derivation_mode >
+          static_cast<uint32_t>(
+              ir::ParticleSpec::DefaultDerivationMode::kMidpoint)) {
+    LOG(ERROR) << "The policy bundle " << path << " is truncated or corrupt.";
+    return nullptr;
+  }
+  return bundle;
+}
+
+const PolicyBundle::Header &PolicyBundle::header() const {
+  return *reinterpret_cast<const Header *>(mapped_file_->data());
+}
+
+template <typename Record>
+const Record *PolicyBundle::GetRecords(uint64_t offset) const {
+  return reinterpret_cast<const Record *>(mapped_file_->data() + offset);
+}
+
+absl::string_view PolicyBundle::GetString(uint32_t index) const {
+  // Only the sections are checked by Load; the string offsets are checked
+  // as they are used.
+  CHECK_LT(index, num_strings());
+  const uint64_t *string_offsets =
+      GetRecords<uint64_t>(header().sections.string_offsets.offset);
+  uint64_t begin = string_offsets[index];
+  uint64_t end = string_offsets[index + 1];
+  CHECK(begin <= end && end <= header().sections.string_bytes.count)
+      << "Corrupt policy bundle string table.";
+  const char *string_bytes =
+      GetRecords<char>(header().sections.string_bytes.offset);
+  return absl::string_view(string_bytes + begin, end - begin);
+}
+
+std::string PolicyBundle::ToDatalog(
+    ir::DatalogPrintContext &ctxt, const std::string &separator,
+    ManifestDatalogFacts::SectionSizes *section_sizes) const {
+  std::ostringstream output;
+  WriteDatalog(ctxt, output, separator, section_sizes);
+  return output.str();
+}
+
+void PolicyBundle::WriteDatalog(
+    ir::DatalogPrintContext &ctxt, std::ostream &output,
+    const std::string &separator,
+    ManifestDatalogFacts::SectionSizes *section_sizes) const {
+  const PolicyBundleSections &sections = header().sections;
+  ManifestDatalogFacts::SectionSizes sizes;
+  // Writes a fact followed by `separator` and returns its size.
+  auto write_fact = [&](const std::string &fact) {
+    output << fact << separator;
+    return fact.size() + separator.size();
+  };
+
+  ManifestDatalogFacts::WriteSectionHeading(output, "Claims", separator);
+  const ClaimRecord *claim_records =
+      GetRecords<ClaimRecord>(sections.claims.offset);
+  for (uint64_t i = 0; i < sections.claims.count; ++i) {
+    const ClaimRecord &claim = claim_records[i];
+    sizes.claims += write_fact(ir::TagClaim::ToDatalog(
+        claim.claim_tag_is_present, GetString(claim.claiming_particle_name),
+        GetString(claim.access_path), GetString(claim.tag)));
+  }
+  output << separator;
+
+  ManifestDatalogFacts::WriteSectionHeading(output, "Checks", separator);
+  const CheckRecord *check_records =
+      GetRecords<CheckRecord>(sections.checks.offset);
+  for (uint64_t i = 0; i < sections.checks.count; ++i) {
+    const CheckRecord &check = check_records[i];
+    sizes.checks += write_fact(ir::TagCheck::ToDatalog(
+        ctxt.GetUniqueCheckLabel(), GetString(check.access_path),
+        GetString(check.rule_body)));
+  }
+  output << separator;
+
+  ManifestDatalogFacts::WriteSectionHeading(output, "Edges", separator);
+  const EdgeRecord *edge_records =
+      GetRecords<EdgeRecord>(sections.edges.offset);
+  for (uint64_t i = 0; i < sections.edges.count; ++i) {
+    const EdgeRecord &edge = edge_records[i];
+    sizes.edges += write_fact(
+        ir::Edge::ToDatalog(GetString(edge.from), GetString(edge.to)));
+  }
+  output << separator;
+
+  if (section_sizes != nullptr) *section_sizes = sizes;
+}
+
+CheckSources PolicyBundle::GetCheckSources() const {
+  std::vector<CheckSource> sources;
+  ir::DatalogPrintContext ctxt;
+  const CheckRecord *check_records =
+      GetRecords<CheckRecord>(header().sections.checks.offset);
+  for (uint64_t i = 0; i < num_checks(); ++i) {
+    const CheckRecord &check = check_records[i];
+    sources.push_back(CheckSource{
+        .label = ctxt.GetUniqueCheckLabel(),
+        .recipe = std::string(GetString(check.recipe)),
+        .particle = std::string(GetString(check.particle)),
+        .particle_spec = std::string(GetString(check.particle_spec)),
+        .handle_connection = std::string(GetString(check.handle_connection)),
+        .access_path = std::string(GetString(check.source_access_path)),
+        .predicate = std::string(GetString(check.source_predicate))});
+  }
+  return CheckSources(std::move(sources));
+}
+
+ir::ParticleSpec::DefaultDerivationMode PolicyBundle::default_derivation_mode()
+    const {
+  return static_cast<ir::ParticleSpec::DefaultDerivationMode>(
+      header().default_derivation_mode);
+}
+
+uint64_t PolicyBundle::num_claims() const {
+  return header().sections.claims.count;
+}
+
+uint64_t PolicyBundle::num_checks() const {
+  return header().sections.checks.count;
+}
+
+uint64_t PolicyBundle::num_edges() const {
+  return header().sections.edges.count;
+}
+
+uint64_t PolicyBundle::num_strings() const {
+  return header().sections.string_offsets.count - 1;
+}
+
+}  // namespace raksha::xform_to_datalog
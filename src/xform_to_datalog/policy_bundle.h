@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_POLICY_BUNDLE_H_
+#define SRC_XFORM_TO_DATALOG_POLICY_BUNDLE_H_
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "src/ir/datalog_print_context.h"
+#include "src/ir/particle_spec.h"
+#include "src/utils/mapped_file.h"
+#include "src/xform_to_datalog/check_sources.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+
+namespace raksha::xform_to_datalog {
+
+// The facts of a manifest, compiled once into a binary bundle that is mapped
+// into memory and used in place. Printing the datalog of a bundle skips
+// parsing the manifest proto, decoding its particle specs, expanding their
+// schemas and instantiating its recipes: loading it only checks its header.
+//
+// A bundle holds the claims, checks and edges of the manifest in the order
+// in which ManifestDatalogFacts::ToDatalog prints them, as records of fixed
+// size that refer to an interned table of strings. Access paths, particle
+// names, tags and predicates are stored instantiated and printed. The
+// records are laid out for the byte order of the compiling host; `Load` rejects bundles of
+// other byte orders or layout versions.
+class PolicyBundle {
+ public:
+  // The version of the layout, to be bumped on any change to it.
+  static constexpr uint32_t kVersion = 3;
+
+  // Returns the bundle of `manifest_facts`, whose particle specs were
+  // decoded with `default_derivation_mode`.
+  static std::string Compile(
+      const ManifestDatalogFacts &manifest_facts,
+      ir::ParticleSpec::DefaultDerivationMode default_derivation_mode);
+
+  // Maps the bundle at `path`. Returns nullptr and logs an error if it
+  // cannot be read or is not a bundle of this version.
+  static std::unique_ptr<PolicyBundle> Load(const std::filesystem::path &path);
+
+  PolicyBundle(const PolicyBundle &) = delete;
+  PolicyBundle &operator=(const PolicyBundle &) = delete;
+
+  // Returns the facts as ManifestDatalogFacts::ToDatalog prints them. The
+  // checks are labeled by `ctxt`.
+  std::string ToDatalog(
+      ir::DatalogPrintContext &ctxt, const std::string &separator = "\n",
+      ManifestDatalogFacts::SectionSizes *section_sizes = nullptr) const;
+
+  // Writes the output of `ToDatalog` to `output` one fact at a time.
+  void WriteDatalog(
+      ir::DatalogPrintContext &ctxt, std::ostream &output,
+      const std::string &separator = "\n",
+      ManifestDatalogFacts::SectionSizes *section_sizes = nullptr) const;
+
+  // Returns the sources of the checks, as CheckSources::Create returns them
+  // for the facts the bundle was compiled from.
+  CheckSources GetCheckSources() const;
+
+  ir::ParticleSpec::DefaultDerivationMode default_derivation_mode() const;
+
+  uint64_t num_claims() const;
+  uint64_t num_checks() const;
+  uint64_t num_edges() const;
+  uint64_t num_strings() const;
+  uint64_t file_size() const { return mapped_file_->size(); }
+
+ private:
+  struct Header;
+
+  explicit PolicyBundle(std::unique_ptr<utils::MappedFile> mapped_file)
+      : mapped_file_(std::move(mapped_file)) {}
+
+  const Header &header() const;
+  // Returns the records of a section of the bundle.
+  template <typename Record>
+  const Record *GetRecords(uint64_t offset) const;
+  // Returns the string with the given index in the string table.
+  absl::string_view GetString(uint32_t index) const;
+
+  std::unique_ptr<utils::MappedFile> mapped_file_;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_POLICY_BUNDLE_H_
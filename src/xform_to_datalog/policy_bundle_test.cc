@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/policy_bundle.h"
+
+#include <google/protobuf/text_format.h>
+
+#include <fstream>
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/datalog_print_context.h"
+#include "src/ir/proto/system_spec.h"
+
+namespace raksha::xform_to_datalog {
+
+// A Source particle claims a tag on its output, which two Sink particles
+// check on their inputs, and a Relay particle passes it on.
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Source" connections: [
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: { particle_spec: "Source", handle_connection: "out" } }
+            predicate: { label: { semantic_tag: "tag"} } } } ] },
+    { name: "Relay" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } },
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ] },
+    { name: "Sink" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } } ]
+      checks: [
+        { access_path: {
+            handle: { particle_spec: "Sink", handle_connection: "in" } }
+          predicate: { label: { semantic_tag: "tag"} } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Source" connections: [
+              { name: "out" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Relay" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } },
+              { name: "out" handle: "h2" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h2" type: { primitive: TEXT } } ] } ] } ]
+)";
+
+class PolicyBundleTest : public testing::Test {
+ public:
+  PolicyBundleTest() {
+    arcs::ManifestProto manifest_proto;
+    CHECK(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                        &manifest_proto));
+    system_spec_ = ir::proto::Decode(manifest_proto, kDefaultDerivationMode);
+    CHECK(system_spec_ != nullptr);
+    manifest_facts_ = ManifestDatalogFacts::CreateFromManifestProto(
+        *system_spec_, manifest_proto);
+  }
+
+ protected:
+  static constexpr ir::ParticleSpec::DefaultDerivationMode
+      kDefaultDerivationMode =
+          ir::ParticleSpec::DefaultDerivationMode::kMidpoint;
+
+  // Compiles the facts into a bundle file and loads it.
+  std::unique_ptr<PolicyBundle> CompileAndLoad() {
+    return PolicyBundle::Load(WriteFile(
+        "bundle",
+        PolicyBundle::Compile(manifest_facts_, kDefaultDerivationMode)));
+  }
+
+  static std::filesystem::path WriteFile(const std::string &name,
+                                         const std::string &contents) {
+    std::filesystem::path path =
+        std::filesystem::path(testing::TempDir()) / name;
+    std::ofstream(path, std::ios::out | std::ios::trunc | std::ios::binary)
+        << contents;
+    return path;
+  }
+
+  std::unique_ptr<ir::SystemSpec> system_spec_;
+  ManifestDatalogFacts manifest_facts_;
+};
+
+TEST_F(PolicyBundleTest, PrintsTheDatalogOfTheFacts) {
+  ir::DatalogPrintContext facts_ctxt;
+  ManifestDatalogFacts::SectionSizes facts_section_sizes;
+  std::string expected =
+      manifest_facts_.ToDatalog(facts_ctxt, "\n", &facts_section_sizes);
+
+  std::unique_ptr<PolicyBundle> bundle = CompileAndLoad();
+  ASSERT_NE(bundle, nullptr);
+  EXPECT_EQ(bundle->default_derivation_mode(), kDefaultDerivationMode);
+  EXPECT_EQ(bundle->num_claims(), 1);
+  EXPECT_EQ(bundle->num_checks(), 2);
+  ir::DatalogPrintContext bundle_ctxt;
+  ManifestDatalogFacts::SectionSizes bundle_section_sizes;
+  EXPECT_EQ(bundle->ToDatalog(bundle_ctxt, "\n", &bundle_section_sizes),
+            expected);
+  EXPECT_EQ(bundle_section_sizes.edges, facts_section_sizes.edges);
+}
+
+TEST_F(PolicyBundleTest, KeepsTheSourcesOfTheChecks) {
+  std::unique_ptr<PolicyBundle> bundle = CompileAndLoad();
+  ASSERT_NE(bundle, nullptr);
+  EXPECT_EQ(bundle->GetCheckSources().sources(),
+            CheckSources::Create(manifest_facts_).sources());
+}
+
+TEST_F(PolicyBundleTest, RejectsOtherFiles) {
+  EXPECT_EQ(PolicyBundle::Load(WriteFile("empty", "")), nullptr);
+  EXPECT_EQ(PolicyBundle::Load(WriteFile("text", "not a policy bundle")),
+            nullptr);
+
+  std::string bundle =
+      PolicyBundle::Compile(manifest_facts_, kDefaultDerivationMode);
+  std::string other_version = bundle;
+  ++other_version[8];
+  EXPECT_EQ(PolicyBundle::Load(WriteFile("other_version", other_version)),
+            nullptr);
+  EXPECT_EQ(PolicyBundle::Load(WriteFile(
+                "truncated", bundle.substr(0, bundle.size() - 1))),
+            nullptr);
+}
+
+}  // namespace raksha::xform_to_datalog
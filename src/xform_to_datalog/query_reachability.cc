@@ -0,0 +1,126 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Tool that answers whether data can flow between access paths of a
+// manifest, from a reachability index that it builds or loads from disk.
+//
+// Example:
+//   bazel run //src/xform_to_datalog:query_reachability --
+//     --manifest_proto=<manifest proto> --write_index=/tmp/index.binarypb
+//   bazel run //src/xform_to_datalog:query_reachability --
+//     --index=/tmp/index.binarypb --from=R.h1 --to=R.Sink#1.in
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/ir/system_spec.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "src/xform_to_datalog/reachability_index.h"
+
+ABSL_FLAG(std::string, manifest_proto, "",
+          "The manifest proto file to build the index from.");
+ABSL_FLAG(bool, midpoint_default_derivation, false,
+          "Index the graph generate_datalog_program draws with "
+          "--midpoint_default_derivation.");
+ABSL_FLAG(std::string, index, "",
+          "The index file to load instead of building the index.");
+ABSL_FLAG(std::string, write_index, "",
+          "If set, write the index to this file.");
+ABSL_FLAG(std::string, from, "", "The access path to query from.");
+ABSL_FLAG(std::string, to, "",
+          "If set, print whether --from can reach this access path. "
+          "Otherwise print all access paths that --from can reach.");
+
+constexpr char kUsageMessage[] =
+    "This tool builds or loads a reachability index of the dataflow graph of "
+    "a manifest and answers whether one access path can reach another.";
+
+using raksha::xform_to_datalog::ManifestDatalogFacts;
+using raksha::xform_to_datalog::ReachabilityIndex;
+using raksha::xform_to_datalog::ReachabilityIndexProto;
+
+namespace {
+
+std::optional<ReachabilityIndex> LoadIndex(
+    const std::filesystem::path &index_filepath) {
+  std::ifstream index_stream(index_filepath, std::ios::in | std::ios::binary);
+  ReachabilityIndexProto index_proto;
+  if (!index_stream || !index_proto.ParseFromIstream(&index_stream)) {
+    LOG(ERROR) << "Error reading the index " << index_filepath;
+    return std::nullopt;
+  }
+  return ReachabilityIndex::FromProto(index_proto);
+}
+
+std::optional<ReachabilityIndex> BuildIndex(
+    const std::filesystem::path &manifest_filepath) {
+  std::unique_ptr<raksha::ir::proto::ManifestFile> manifest_file =
+      raksha::ir::proto::ManifestFile::Load(manifest_filepath);
+  if (manifest_file == nullptr) return std::nullopt;
+  const arcs::ManifestProto &manifest_proto = manifest_file->manifest_proto();
+  std::unique_ptr<raksha::ir::SystemSpec> system_spec =
+      raksha::ir::proto::Decode(
+          manifest_proto,
+          absl::GetFlag(FLAGS_midpoint_default_derivation)
+              ? raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint
+              : raksha::ir::ParticleSpec::DefaultDerivationMode::kCartesian);
+  CHECK(system_spec != nullptr);
+  return ReachabilityIndex::Create(
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec,
+                                                    manifest_proto));
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("query_reachability");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::optional<ReachabilityIndex> index =
+      absl::GetFlag(FLAGS_index).empty()
+          ? BuildIndex(absl::GetFlag(FLAGS_manifest_proto))
+          : LoadIndex(absl::GetFlag(FLAGS_index));
+  if (!index.has_value()) return 1;
+
+  std::filesystem::path write_index_filepath(absl::GetFlag(FLAGS_write_index));
+  if (!write_index_filepath.empty()) {
+    std::ofstream index_file(write_index_filepath,
+                             std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!index_file || !index->ToProto().SerializeToOstream(&index_file)) {
+      LOG(ERROR) << "Error writing the index to " << write_index_filepath;
+      return 1;
+    }
+  }
+
+  std::string from = absl::GetFlag(FLAGS_from);
+  if (from.empty()) return 0;
+  std::string to = absl::GetFlag(FLAGS_to);
+  if (!to.empty()) {
+    std::cout << (index->CanReach(from, to) ? "true" : "false") << "\n";
+    return 0;
+  }
+  for (absl::string_view access_path : index->ReachableSet(from)) {
+    std::cout << access_path << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,235 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include "src/xform_to_datalog/reachability_index.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "src/common/logging/logging.h"
+
+namespace raksha::xform_to_datalog {
+
+ReachabilityIndex ReachabilityIndex::Create(
+    const ManifestDatalogFacts &manifest_facts) {
+  return Create(AccessPathGraph::Create(manifest_facts));
+}
+
+ReachabilityIndex ReachabilityIndex::Create(const AccessPathGraph &graph) {
+  StronglyConnectedComponents sccs = GetStronglyConnectedComponents(graph);
+  ReachabilityIndex index;
+  for (uint32_t node = 0; node < graph.num_nodes(); ++node) {
+    index.access_paths_.push_back(graph.name(node));
+  }
+  index.component_of_node_ = sccs.component_of_node;
+  index.is_cyclic_ = sccs.is_cyclic;
+
+  // The edges of the condensed graph lead to smaller components.
+  std::vector<std::vector<uint32_t>> successors =
+      GetComponentSuccessors(graph, sccs);
+
+  // Label the components in increasing order, so that the labels of their
+  // successors are done, merging those labels and the component itself.
+  std::vector<std::pair<uint32_t, uint32_t>> intervals;
+  index.interval_offsets_.push_back(0);
+  for (uint32_t component = 0; component < sccs.num_components();
+       ++component) {
+    intervals.clear();
+    intervals.push_back({component, component});
+    for (uint32_t successor : successors[component]) {
+      for (uint32_t i = index.interval_offsets_[successor];
+           i < index.interval_offsets_[successor + 1]; ++i) {
+        intervals.push_back({index.interval_bounds_[2 * i],
+                             index.interval_bounds_[2 * i + 1]});
+      }
+    }
+    std::sort(intervals.begin(), intervals.end());
+    uint32_t start = intervals.front().first;
+    uint32_t end = intervals.front().second;
+    auto add_interval = [&]() {
+      index.interval_bounds_.push_back(start);
+      index.interval_bounds_.push_back(end);
+    };
+    for (const auto &[next_start, next_end] : intervals) {
+      if (next_start > end + 1) {
+        add_interval();
+        start = next_start;
+      }
+      end = std::max(end, next_end);
+    }
+    add_interval();
+    index.interval_offsets_.push_back(index.interval_bounds_.size() / 2);
+  }
+  index.Index();
+  return index;
+}
+
+std::optional<ReachabilityIndex> ReachabilityIndex::FromProto(
+    const ReachabilityIndexProto &index_proto) {
+  ReachabilityIndex index;
+  index.access_paths_.assign(index_proto.access_paths().begin(),
+                             index_proto.access_paths().end());
+  index.component_of_node_.assign(index_proto.component_of_node().begin(),
+                                  index_proto.component_of_node().end());
+  index.interval_offsets_.assign(index_proto.interval_offsets().begin(),
+                                 index_proto.interval_offsets().end());
+  index.interval_bounds_.assign(index_proto.interval_bounds().begin(),
+                                index_proto.interval_bounds().end());
+
+  if (index.component_of_node_.size() != index.access_paths_.size() ||
+      index.interval_offsets_.empty() || index.interval_offsets_[0] != 0 ||
+      index.interval_bounds_.size() % 2 != 0 ||
+      index.interval_offsets_.back() != index.interval_bounds_.size() / 2 ||
+      !std::is_sorted(index.interval_offsets_.begin(),
+                      index.interval_offsets_.end())) {
+    LOG(ERROR) << "Malformed reachability index: inconsistent sizes";
+    return std::nullopt;
+  }
+  uint64_t num_components = index.num_components();
+  auto is_component = [num_components](uint32_t component) {
+    return component < num_components;
+  };
+  if (!std::all_of(index.component_of_node_.begin(),
+                   index.component_of_node_.end(), is_component) ||
+      !std::all_of(index.interval_bounds_.begin(),
+                   index.interval_bounds_.end(), is_component) ||
+      !std::all_of(index_proto.cyclic_components().begin(),
+                   index_proto.cyclic_components().end(), is_component)) {
+    LOG(ERROR) << "Malformed reachability index: unknown component";
+    return std::nullopt;
+  }
+  // ComponentCanReach binary-searches the intervals of a component, which
+  // must thus be sorted and disjoint.
+  for (uint32_t component = 0; component < num_components; ++component) {
+    for (uint32_t i = index.interval_offsets_[component];
+         i < index.interval_offsets_[component + 1]; ++i) {
+      if (index.interval_bounds_[2 * i] > index.interval_bounds_[2 * i + 1]) {
+        LOG(ERROR) << "Malformed reachability index: empty interval";
+        return std::nullopt;
+      }
+      if (i > index.interval_offsets_[component] &&
+          index.interval_bounds_[2 * i] <= index.interval_bounds_[2 * i - 1]) {
+        LOG(ERROR) << "Malformed reachability index: unsorted or overlapping "
+                      "intervals";
+        return std::nullopt;
+      }
+    }
+  }
+  index.is_cyclic_.resize(num_components, false);
+  for (uint32_t component : index_proto.cyclic_components()) {
+    index.is_cyclic_[component] = true;
+  }
+  index.Index();
+  if (index.node_ids_.size() != index.access_paths_.size()) {
+    LOG(ERROR) << "Malformed reachability index: duplicate access paths";
+    return std::nullopt;
+  }
+  return index;
+}
+
+ReachabilityIndexProto ReachabilityIndex::ToProto() const {
+  ReachabilityIndexProto index_proto;
+  index_proto.mutable_access_paths()->Add(access_paths_.begin(),
+                                          access_paths_.end());
+  index_proto.mutable_component_of_node()->Add(component_of_node_.begin(),
+                                               component_of_node_.end());
+  for (uint32_t component = 0; component < is_cyclic_.size(); ++component) {
+    if (is_cyclic_[component]) index_proto.add_cyclic_components(component);
+  }
+  index_proto.mutable_interval_offsets()->Add(interval_offsets_.begin(),
+                                              interval_offsets_.end());
+  index_proto.mutable_interval_bounds()->Add(interval_bounds_.begin(),
+                                             interval_bounds_.end());
+  return index_proto;
+}
+
+void ReachabilityIndex::Index() {
+  node_ids_.clear();
+  node_ids_.reserve(access_paths_.size());
+  for (uint32_t node = 0; node < access_paths_.size(); ++node) {
+    node_ids_.insert({access_paths_[node], node});
+  }
+  // A counting sort of the nodes by component.
+  component_node_offsets_.assign(num_components() + 1, 0);
+  for (uint32_t component : component_of_node_) {
+    ++component_node_offsets_[component + 1];
+  }
+  for (size_t i = 1; i < component_node_offsets_.size(); ++i) {
+    component_node_offsets_[i] += component_node_offsets_[i - 1];
+  }
+  component_nodes_.resize(component_of_node_.size());
+  std::vector<uint32_t> next_positions(component_node_offsets_.begin(),
+                                       component_node_offsets_.end() - 1);
+  for (uint32_t node = 0; node < component_of_node_.size(); ++node) {
+    component_nodes_[next_positions[component_of_node_[node]]++] = node;
+  }
+}
+
+bool ReachabilityIndex::ComponentCanReach(uint32_t from, uint32_t to) const {
+  if (from == to) return is_cyclic_[from];
+  // The last interval of `from` that starts at or before `to`.
+  auto begin = interval_bounds_.begin() + 2 * interval_offsets_[from];
+  auto end = interval_bounds_.begin() + 2 * interval_offsets_[from + 1];
+  uint32_t num_intervals = (end - begin) / 2;
+  uint32_t low = 0;
+  uint32_t high = num_intervals;
+  while (low < high) {
+    uint32_t middle = (low + high) / 2;
+    if (begin[2 * middle] <= to) {
+      low = middle + 1;
+    } else {
+      high = middle;
+    }
+  }
+  return low > 0 && begin[2 * (low - 1) + 1] >= to;
+}
+
+bool ReachabilityIndex::CanReach(absl::string_view from,
+                                 absl::string_view to) const {
+  auto from_result = node_ids_.find(from);
+  auto to_result = node_ids_.find(to);
+  if (from_result == node_ids_.end() || to_result == node_ids_.end()) {
+    return false;
+  }
+  return ComponentCanReach(component_of_node_[from_result->second],
+                           component_of_node_[to_result->second]);
+}
+
+std::vector<absl::string_view> ReachabilityIndex::ReachableSet(
+    absl::string_view from) const {
+  auto find_result = node_ids_.find(from);
+  if (find_result == node_ids_.end()) return {};
+  uint32_t from_component = component_of_node_[find_result->second];
+  std::vector<uint32_t> nodes;
+  for (uint32_t i = interval_offsets_[from_component];
+       i < interval_offsets_[from_component + 1]; ++i) {
+    for (uint32_t component = interval_bounds_[2 * i];
+         component <= interval_bounds_[2 * i + 1]; ++component) {
+      if (component == from_component && !is_cyclic_[component]) continue;
+      auto members = component_nodes_.begin();
+      nodes.insert(nodes.end(), members + component_node_offsets_[component],
+                   members + component_node_offsets_[component + 1]);
+    }
+  }
+  std::sort(nodes.begin(), nodes.end());
+  std::vector<absl::string_view> reachable;
+  reachable.reserve(nodes.size());
+  for (uint32_t node : nodes) reachable.push_back(access_paths_[node]);
+  return reachable;
+}
+
+}  // namespace raksha::xform_to_datalog
@@ -0,0 +1,99 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_REACHABILITY_INDEX_H_
+#define SRC_XFORM_TO_DATALOG_REACHABILITY_INDEX_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "src/xform_to_datalog/access_path_graph.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "src/xform_to_datalog/reachability_index.pb.h"
+
+namespace raksha::xform_to_datalog {
+
+// Answers whether data can flow from one access path to another, as in the
+// path relation of dataflow_graph.dl, without materializing all pairs.
+//
+// The graph is condensed into its strongly connected components, numbered
+// in the post-order of a depth-first search. Each component is labeled with
+// the intervals of the numbers of the components it reaches. The subtrees
+// of the search have consecutive numbers, so that pipelines and trees of
+// particles need few intervals per component.
+//
+// The index is built from the edges of the manifest alone. It does not
+// consider the claimNotEdge facts of the authorization logic, which remove
+// edges for some owners.
+class ReachabilityIndex {
+ public:
+  static ReachabilityIndex Create(const ManifestDatalogFacts &manifest_facts);
+  static ReachabilityIndex Create(const AccessPathGraph &graph);
+
+  // The index looks up access paths by views of its own strings, which
+  // moves keep valid but copies would not.
+  ReachabilityIndex(ReachabilityIndex &&) = default;
+  ReachabilityIndex &operator=(ReachabilityIndex &&) = default;
+  ReachabilityIndex(const ReachabilityIndex &) = delete;
+  ReachabilityIndex &operator=(const ReachabilityIndex &) = delete;
+
+  // Recreates an index from the output of `ToProto`. Returns std::nullopt
+  // if `index_proto` is inconsistent.
+  static std::optional<ReachabilityIndex> FromProto(
+      const ReachabilityIndexProto &index_proto);
+
+  ReachabilityIndexProto ToProto() const;
+
+  // Whether there is a path of one or more edges from `from` to `to`. It is
+  // false for access paths that are not in the graph.
+  bool CanReach(absl::string_view from, absl::string_view to) const;
+
+  // Returns the access paths that `from` can reach, in the order of their
+  // nodes. They point into the index.
+  std::vector<absl::string_view> ReachableSet(absl::string_view from) const;
+
+  uint64_t num_access_paths() const { return access_paths_.size(); }
+  uint64_t num_components() const { return interval_offsets_.size() - 1; }
+  uint64_t num_intervals() const { return interval_bounds_.size() / 2; }
+
+ private:
+  ReachabilityIndex() = default;
+
+  // Sets the fields derived from the persisted ones.
+  void Index();
+
+  bool ComponentCanReach(uint32_t from, uint32_t to) const;
+
+  std::vector<std::string> access_paths_;
+  std::vector<uint32_t> component_of_node_;
+  std::vector<bool> is_cyclic_;
+  std::vector<uint32_t> interval_offsets_;
+  std::vector<uint32_t> interval_bounds_;
+  // Derived from the above.
+  absl::flat_hash_map<absl::string_view, uint32_t> node_ids_;
+  // The nodes of component `c` are component_nodes_[i] for
+  // component_node_offsets_[c] <= i < component_node_offsets_[c + 1].
+  std::vector<uint32_t> component_node_offsets_;
+  std::vector<uint32_t> component_nodes_;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_REACHABILITY_INDEX_H_
@@ -0,0 +1,162 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+
+#include "src/xform_to_datalog/reachability_index.h"
+
+#include <google/protobuf/text_format.h>
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/proto/system_spec.h"
+
+namespace raksha::xform_to_datalog {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+// a -> b -> c <-> d -> e, b -> f, and g alone with a self-loop.
+AccessPathGraph MakeGraph() {
+  AccessPathGraph graph;
+  for (absl::string_view name : {"a", "b", "c", "d", "e", "f", "g"}) {
+    graph.GetNode(std::string(name));
+  }
+  auto add_edge = [&graph](absl::string_view from, absl::string_view to) {
+    graph.AddEdge(*graph.FindNode(from), *graph.FindNode(to));
+  };
+  add_edge("a", "b");
+  add_edge("b", "c");
+  add_edge("c", "d");
+  add_edge("d", "c");
+  add_edge("d", "e");
+  add_edge("b", "f");
+  add_edge("g", "g");
+  return graph;
+}
+
+TEST(ReachabilityIndexTest, AnswersLikeThePathRelation) {
+  ReachabilityIndex index = ReachabilityIndex::Create(MakeGraph());
+  EXPECT_EQ(index.num_access_paths(), 7);
+  EXPECT_EQ(index.num_components(), 6);
+  EXPECT_TRUE(index.CanReach("a", "e"));
+  EXPECT_TRUE(index.CanReach("a", "f"));
+  EXPECT_TRUE(index.CanReach("d", "c"));
+  EXPECT_TRUE(index.CanReach("c", "c"));
+  EXPECT_TRUE(index.CanReach("g", "g"));
+  EXPECT_FALSE(index.CanReach("a", "a"));
+  EXPECT_FALSE(index.CanReach("f", "e"));
+  EXPECT_FALSE(index.CanReach("e", "a"));
+  EXPECT_FALSE(index.CanReach("a", "g"));
+  EXPECT_FALSE(index.CanReach("a", "unknown"));
+}
+
+TEST(ReachabilityIndexTest, ReturnsReachableSets) {
+  ReachabilityIndex index = ReachabilityIndex::Create(MakeGraph());
+  EXPECT_THAT(index.ReachableSet("a"), ElementsAre("b", "c", "d", "e", "f"));
+  EXPECT_THAT(index.ReachableSet("c"), ElementsAre("c", "d", "e"));
+  EXPECT_THAT(index.ReachableSet("g"), ElementsAre("g"));
+  EXPECT_THAT(index.ReachableSet("e"), IsEmpty());
+  EXPECT_THAT(index.ReachableSet("unknown"), IsEmpty());
+}
+
+TEST(ReachabilityIndexTest, NeedsOneIntervalPerComponentOfATree) {
+  ReachabilityIndex index = ReachabilityIndex::Create(MakeGraph());
+  EXPECT_EQ(index.num_intervals(), index.num_components());
+}
+
+TEST(ReachabilityIndexTest, RoundTripsThroughProto) {
+  ReachabilityIndex index = ReachabilityIndex::Create(MakeGraph());
+  ReachabilityIndexProto index_proto;
+  ASSERT_TRUE(index_proto.ParseFromString(index.ToProto().SerializeAsString()));
+  std::optional<ReachabilityIndex> loaded =
+      ReachabilityIndex::FromProto(index_proto);
+  ASSERT_TRUE(loaded.has_value());
+  for (absl::string_view from : {"a", "b", "c", "d", "e", "f", "g"}) {
+    EXPECT_EQ(loaded->ReachableSet(from), index.ReachableSet(from)) << from;
+  }
+}
+
+TEST(ReachabilityIndexTest, RejectsInconsistentProtos) {
+  ReachabilityIndexProto index_proto =
+      ReachabilityIndex::Create(MakeGraph()).ToProto();
+  ReachabilityIndexProto missing_node = index_proto;
+  missing_node.mutable_component_of_node()->RemoveLast();
+  EXPECT_EQ(ReachabilityIndex::FromProto(missing_node), std::nullopt);
+  ReachabilityIndexProto unknown_component = index_proto;
+  unknown_component.set_interval_bounds(0, 100);
+  EXPECT_EQ(ReachabilityIndex::FromProto(unknown_component), std::nullopt);
+  ReachabilityIndexProto duplicate_path = index_proto;
+  duplicate_path.set_access_paths(1, "a");
+  EXPECT_EQ(ReachabilityIndex::FromProto(duplicate_path), std::nullopt);
+}
+
+TEST(ReachabilityIndexTest, RejectsMalformedIntervals) {
+  // Three components, the first of which reaches the other two.
+  ReachabilityIndexProto index_proto;
+  for (absl::string_view name : {"a", "b", "c"}) {
+    index_proto.add_access_paths(std::string(name));
+    index_proto.add_component_of_node(index_proto.component_of_node_size());
+  }
+  for (uint32_t offset : {0, 2, 2, 2}) index_proto.add_interval_offsets(offset);
+  auto with_bounds = [&index_proto](std::vector<uint32_t> bounds) {
+    ReachabilityIndexProto result = index_proto;
+    result.mutable_interval_bounds()->Add(bounds.begin(), bounds.end());
+    return ReachabilityIndex::FromProto(result);
+  };
+  std::optional<ReachabilityIndex> index = with_bounds({1, 1, 2, 2});
+  ASSERT_TRUE(index.has_value());
+  EXPECT_TRUE(index->CanReach("a", "c"));
+  EXPECT_EQ(with_bounds({2, 2, 1, 1}), std::nullopt);
+  EXPECT_EQ(with_bounds({1, 2, 2, 2}), std::nullopt);
+  EXPECT_EQ(with_bounds({2, 1, 2, 2}), std::nullopt);
+  EXPECT_EQ(with_bounds({1, 1, 2, 3}), std::nullopt);
+}
+
+// A handle read by two particles, one of which writes to another handle.
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Relay" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } },
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ] },
+    { name: "Sink" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Relay" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } },
+              { name: "out" handle: "h2" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } } ] } ] } ]
+)";
+
+TEST(ReachabilityIndexTest, IndexesTheEdgesOfAManifest) {
+  arcs::ManifestProto manifest_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                            &manifest_proto));
+  std::unique_ptr<ir::SystemSpec> system_spec =
+      ir::proto::Decode(manifest_proto);
+  ASSERT_NE(system_spec, nullptr);
+  ReachabilityIndex index =
+      ReachabilityIndex::Create(ManifestDatalogFacts::CreateFromManifestProto(
+          *system_spec, manifest_proto));
+  EXPECT_THAT(index.ReachableSet("R.h1"),
+              ElementsAre("R.Relay#0.in", "R.Relay#0.out", "R.h2",
+                          "R.Sink#1.in"));
+  EXPECT_TRUE(index.CanReach("R.Relay#0.in", "R.h2"));
+  EXPECT_FALSE(index.CanReach("R.Sink#1.in", "R.h2"));
+}
+
+}  // namespace raksha::xform_to_datalog
@@ -0,0 +1,98 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Tool that reports statistics about the dataflow graph instantiated from a
+// manifest proto, to find the particle specs and schemas that make its
+// analysis expensive before running it.
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/ir/system_spec.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "src/xform_to_datalog/manifest_fact_stats.h"
+
+ABSL_FLAG(std::string, manifest_proto, "", "The manifest proto file.");
+ABSL_FLAG(bool, midpoint_default_derivation, false,
+          "Report on the graph generate_datalog_program draws with "
+          "--midpoint_default_derivation.");
+ABSL_FLAG(std::string, format, "json", "The report format: json or csv.");
+ABSL_FLAG(uint64_t, top, 10,
+          "The number of entries in the rankings of access paths, components "
+          "and default-derivation edges.");
+ABSL_FLAG(std::string, output, "",
+          "The file to write the report to. Defaults to standard output.");
+
+constexpr char kUsageMessage[] =
+    "This tool takes a manifest proto and reports edge counts per particle "
+    "spec and recipe, fan-in and fan-out, components and cycles, access "
+    "paths per schema and check and claim counts of its dataflow graph.";
+
+using ManifestDatalogFacts = raksha::xform_to_datalog::ManifestDatalogFacts;
+using ManifestFactStats = raksha::xform_to_datalog::ManifestFactStats;
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("report_fact_stats");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::string format = absl::GetFlag(FLAGS_format);
+  if (format != "json" && format != "csv") {
+    LOG(ERROR) << "Unknown report format " << format;
+    return 1;
+  }
+
+  std::filesystem::path manifest_filepath(absl::GetFlag(FLAGS_manifest_proto));
+  std::unique_ptr<raksha::ir::proto::ManifestFile> manifest_file =
+      raksha::ir::proto::ManifestFile::Load(manifest_filepath);
+  if (manifest_file == nullptr) return 1;
+  const arcs::ManifestProto &manifest_proto = manifest_file->manifest_proto();
+
+  std::unique_ptr<raksha::ir::SystemSpec> system_spec =
+      raksha::ir::proto::Decode(
+          manifest_proto,
+          absl::GetFlag(FLAGS_midpoint_default_derivation)
+              ? raksha::ir::ParticleSpec::DefaultDerivationMode::kMidpoint
+              : raksha::ir::ParticleSpec::DefaultDerivationMode::kCartesian);
+  CHECK(system_spec != nullptr);
+  ManifestDatalogFacts manifest_datalog_facts =
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec,
+                                                    manifest_proto);
+  ManifestFactStats stats = ManifestFactStats::Create(
+      manifest_proto, manifest_datalog_facts, absl::GetFlag(FLAGS_top));
+  std::string report = (format == "json") ? stats.ToJson() : stats.ToCsv();
+
+  std::filesystem::path output_filepath(absl::GetFlag(FLAGS_output));
+  if (output_filepath.empty()) {
+    std::cout << report;
+    return 0;
+  }
+  std::ofstream output_file(output_filepath,
+                            std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!output_file) {
+    LOG(ERROR) << "Error creating " << output_filepath << " :"
+               << strerror(errno);
+    return 1;
+  }
+  output_file << report;
+  return 0;
+}
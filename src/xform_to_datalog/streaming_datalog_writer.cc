@@ -0,0 +1,69 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/streaming_datalog_writer.h"
+
+#include <algorithm>
+
+#include "src/common/logging/logging.h"
+#include "src/xform_to_datalog/datalog_facts.h"
+
+namespace raksha::xform_to_datalog {
+
+StreamingDatalogWriter::StreamingDatalogWriter(
+    const ir::SystemSpec &system_spec, ir::DatalogPrintContext &ctxt,
+    std::ostream &output)
+    : system_spec_(system_spec),
+      ctxt_(ctxt),
+      output_(output),
+      file_format_pieces_(DatalogFacts::GetFileFormatPieces()) {
+  CHECK_EQ(file_format_pieces_.size(), 3);
+  output_ << file_format_pieces_[0];
+}
+
+void StreamingDatalogWriter::WriteRecipe(
+    const arcs::RecipeProto &recipe_proto) {
+  ManifestDatalogFacts recipe_facts =
+      ManifestDatalogFacts::CreateFromRecipeProto(
+          system_spec_, recipe_proto,
+          ManifestDatalogFacts::GetRecipeName(recipe_proto,
+                                              num_generated_recipe_names_));
+  ManifestDatalogFacts::SectionSizes recipe_section_sizes;
+  recipe_facts.WriteDatalog(ctxt_, output_, /*separator=*/"\n",
+                            &recipe_section_sizes);
+
+  section_sizes_.claims += recipe_section_sizes.claims;
+  section_sizes_.checks += recipe_section_sizes.checks;
+  section_sizes_.edges += recipe_section_sizes.edges;
+  ManifestDatalogFacts::DuplicateCounts recipe_duplicates =
+      recipe_facts.GetNumDuplicates();
+  num_duplicates_.tag_claims += recipe_duplicates.tag_claims;
+  num_duplicates_.checks += recipe_duplicates.checks;
+  num_duplicates_.edges += recipe_duplicates.edges;
+  ++num_recipes_;
+  max_recipe_particles_ =
+      std::max<uint64_t>(max_recipe_particles_,
+                         recipe_facts.particle_instances().size());
+}
+
+void StreamingDatalogWriter::Finish(
+    const AuthorizationLogicDatalogFacts &auth_logic_datalog_facts) {
+  output_ << file_format_pieces_[1]
+          << auth_logic_datalog_facts.ToDatalog()
+          << file_format_pieces_[2];
+}
+
+}  // namespace raksha::xform_to_datalog
@@ -0,0 +1,85 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_STREAMING_DATALOG_WRITER_H_
+#define SRC_XFORM_TO_DATALOG_STREAMING_DATALOG_WRITER_H_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "src/ir/datalog_print_context.h"
+#include "src/ir/system_spec.h"
+#include "src/xform_to_datalog/authorization_logic_datalog_facts.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+#include "third_party/arcs/proto/manifest.pb.h"
+
+namespace raksha::xform_to_datalog {
+
+// Writes the datalog program of a manifest one recipe at a time, such as
+// while reading a manifest stream, so that only the SystemSpec and the facts
+// of the current recipe are in memory. The facts of each recipe are printed
+// as ManifestDatalogFacts::ToDatalog prints them, under their own headings,
+// and the tag bits of all recipes follow them. For a manifest with a single
+// recipe, the program is the same as that of DatalogFacts.
+class StreamingDatalogWriter {
+ public:
+  // Writes the start of the program to `output`. The arguments must outlive
+  // the writer.
+  StreamingDatalogWriter(const ir::SystemSpec &system_spec,
+                         ir::DatalogPrintContext &ctxt, std::ostream &output);
+
+  StreamingDatalogWriter(const StreamingDatalogWriter &) = delete;
+  StreamingDatalogWriter &operator=(const StreamingDatalogWriter &) = delete;
+
+  // Instantiates the particles of `recipe_proto`, writes their facts and
+  // frees them. Recipes without names are named in the order in which they
+  // are written, as in CreateFromManifestProto.
+  void WriteRecipe(const arcs::RecipeProto &recipe_proto);
+
+  // Writes the authorization logic facts, which end the program.
+  void Finish(const AuthorizationLogicDatalogFacts &auth_logic_datalog_facts);
+
+  // The sizes of the sections of the manifest facts summed over the recipes
+  // written so far. The tag bits are only known once the program finishes.
+  const ManifestDatalogFacts::SectionSizes &section_sizes() const {
+    return section_sizes_;
+  }
+  // The duplicate facts dropped from the recipes written so far.
+  const ManifestDatalogFacts::DuplicateCounts &num_duplicates() const {
+    return num_duplicates_;
+  }
+  uint64_t num_recipes() const { return num_recipes_; }
+  // The number of particles of the largest recipe, which bounds the facts
+  // in memory at any time.
+  uint64_t max_recipe_particles() const { return max_recipe_particles_; }
+
+ private:
+  const ir::SystemSpec &system_spec_;
+  ir::DatalogPrintContext &ctxt_;
+  std::ostream &output_;
+  std::vector<absl::string_view> file_format_pieces_;
+  uint64_t num_generated_recipe_names_ = 0;
+  ManifestDatalogFacts::SectionSizes section_sizes_;
+  ManifestDatalogFacts::DuplicateCounts num_duplicates_;
+  uint64_t num_recipes_ = 0;
+  uint64_t max_recipe_particles_ = 0;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_STREAMING_DATALOG_WRITER_H_
@@ -0,0 +1,152 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/streaming_datalog_writer.h"
+
+#include <google/protobuf/text_format.h>
+
+#include <algorithm>
+#include <sstream>
+
+#include "absl/strings/match.h"
+#include "absl/strings/str_split.h"
+#include "src/common/testing/gtest.h"
+#include "src/ir/proto/system_spec.h"
+#include "src/xform_to_datalog/datalog_facts.h"
+
+namespace raksha::xform_to_datalog {
+
+// A Source particle claims a tag on its output, which a Sink particle
+// checks on its input, in a named and an unnamed recipe.
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Source" connections: [
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: { particle_spec: "Source", handle_connection: "out" } }
+            predicate: { label: { semantic_tag: "tag"} } } } ] },
+    { name: "Sink" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } } ]
+      checks: [
+        { access_path: {
+            handle: { particle_spec: "Sink", handle_connection: "in" } }
+          predicate: { label: { semantic_tag: "tag"} } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Source" connections: [
+              { name: "out" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } } ] } ] },
+      { particles: [
+          { spec_name: "Source" connections: [
+              { name: "out" handle: "h" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h" type: { primitive: TEXT } } ] } ] } ]
+)";
+
+static const char kAuthLogicFacts[] =
+    R"(says_may("EndUser", "Sink", "usage", "tag").)";
+
+class StreamingDatalogWriterTest : public testing::Test {
+ public:
+  StreamingDatalogWriterTest() : auth_logic_facts_(kAuthLogicFacts) {
+    CHECK(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                        &manifest_proto_));
+    system_spec_ = ir::proto::Decode(manifest_proto_);
+    CHECK(system_spec_ != nullptr);
+  }
+
+ protected:
+  // Returns the program of `manifest_proto` as written one recipe at a time.
+  std::string WriteStreaming(const arcs::ManifestProto &manifest_proto,
+                             ir::DatalogPrintContext &ctxt) {
+    std::stringstream output;
+    writer_ = std::make_unique<StreamingDatalogWriter>(*system_spec_, ctxt,
+                                                       output);
+    for (const arcs::RecipeProto &recipe_proto : manifest_proto.recipes()) {
+      writer_->WriteRecipe(recipe_proto);
+    }
+    writer_->Finish(auth_logic_facts_);
+    return output.str();
+  }
+
+  // Returns the program of `manifest_proto` as DatalogFacts writes it.
+  std::string WriteWhole(const arcs::ManifestProto &manifest_proto,
+                         ir::DatalogPrintContext &ctxt,
+                         ManifestDatalogFacts::SectionSizes *section_sizes) {
+    return DatalogFacts(ManifestDatalogFacts::CreateFromManifestProto(
+                            *system_spec_, manifest_proto),
+                        auth_logic_facts_)
+        .ToDatalog(ctxt, section_sizes);
+  }
+
+  // Returns the lines of `datalog` other than comments and blank lines.
+  static std::vector<std::string> GetSortedFacts(absl::string_view datalog) {
+    std::vector<std::string> facts;
+    for (absl::string_view line : absl::StrSplit(datalog, '\n')) {
+      if (line.empty() || absl::StartsWith(line, "//")) continue;
+      facts.push_back(std::string(line));
+    }
+    std::sort(facts.begin(), facts.end());
+    return facts;
+  }
+
+  arcs::ManifestProto manifest_proto_;
+  std::unique_ptr<ir::SystemSpec> system_spec_;
+  AuthorizationLogicDatalogFacts auth_logic_facts_;
+  std::unique_ptr<StreamingDatalogWriter> writer_;
+};
+
+TEST_F(StreamingDatalogWriterTest, WritesTheSameProgramForASingleRecipe) {
+  arcs::ManifestProto single_recipe_manifest_proto = manifest_proto_;
+  single_recipe_manifest_proto.mutable_recipes()->RemoveLast();
+  ir::DatalogPrintContext whole_ctxt;
+  ManifestDatalogFacts::SectionSizes section_sizes;
+  std::string whole_datalog =
+      WriteWhole(single_recipe_manifest_proto, whole_ctxt, &section_sizes);
+
+  ir::DatalogPrintContext streaming_ctxt;
+  EXPECT_EQ(WriteStreaming(single_recipe_manifest_proto, streaming_ctxt),
+            whole_datalog);
+  EXPECT_EQ(writer_->section_sizes().edges, section_sizes.edges);
+}
+
+TEST_F(StreamingDatalogWriterTest, WritesTheSameFactsForManyRecipes) {
+  ir::DatalogPrintContext whole_ctxt;
+  ManifestDatalogFacts::SectionSizes section_sizes;
+  std::string whole_datalog =
+      WriteWhole(manifest_proto_, whole_ctxt, &section_sizes);
+
+  ir::DatalogPrintContext streaming_ctxt;
+  std::string streaming_datalog =
+      WriteStreaming(manifest_proto_, streaming_ctxt);
+  EXPECT_EQ(GetSortedFacts(streaming_datalog), GetSortedFacts(whole_datalog));
+  EXPECT_THAT(streaming_datalog,
+              testing::HasSubstr("GENERATED_RECIPE_NAME0.Sink#2.in"));
+
+  EXPECT_EQ(writer_->num_recipes(), 2);
+  EXPECT_EQ(writer_->max_recipe_particles(), 3);
+  EXPECT_EQ(writer_->section_sizes().claims, section_sizes.claims);
+  EXPECT_EQ(writer_->section_sizes().checks, section_sizes.checks);
+  EXPECT_EQ(writer_->section_sizes().edges, section_sizes.edges);
+}
+
+}  // namespace raksha::xform_to_datalog
@@ -0,0 +1,148 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/transitive_closure.h"
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"
+
+namespace raksha::xform_to_datalog {
+
+namespace {
+
+// Sets `row` to `row | successor_row`. Kept free of branches so that it is
+// vectorized.
+void OrRow(uint64_t *row, const uint64_t *successor_row, uint64_t num_words) {
+  for (uint64_t i = 0; i < num_words; ++i) row[i] |= successor_row[i];
+}
+
+}  // namespace
+
+TransitiveClosure TransitiveClosure::Create(const AccessPathGraph &graph) {
+  StronglyConnectedComponents sccs = GetStronglyConnectedComponents(graph);
+  std::vector<std::vector<uint32_t>> successors =
+      GetComponentSuccessors(graph, sccs);
+  uint64_t num_components = sccs.num_components();
+
+  TransitiveClosure closure;
+  closure.component_of_node_ = sccs.component_of_node;
+  closure.node_offsets_.assign(num_components + 1, 0);
+  for (uint32_t component : closure.component_of_node_) {
+    ++closure.node_offsets_[component + 1];
+  }
+  for (uint64_t component = 0; component < num_components; ++component) {
+    closure.node_offsets_[component + 1] += closure.node_offsets_[component];
+  }
+  closure.nodes_.resize(closure.component_of_node_.size());
+  std::vector<uint64_t> next_node(closure.node_offsets_.begin(),
+                                  closure.node_offsets_.end() - 1);
+  for (uint32_t node = 0; node < closure.component_of_node_.size(); ++node) {
+    closure.nodes_[next_node[closure.component_of_node_[node]]++] = node;
+  }
+
+  // A row starts at the first word of the rows of its successors.
+  closure.first_words_.resize(num_components);
+  closure.row_offsets_.reserve(num_components + 1);
+  closure.row_offsets_.push_back(0);
+  for (uint32_t component = 0; component < num_components; ++component) {
+    uint32_t first_word = component / 64;
+    for (uint32_t successor : successors[component]) {
+      first_word = std::min(first_word, closure.first_words_[successor]);
+    }
+    closure.first_words_[component] = first_word;
+    closure.row_offsets_.push_back(closure.row_offsets_.back() +
+                                   component / 64 - first_word + 1);
+  }
+  closure.words_.assign(closure.row_offsets_.back(), 0);
+
+  for (uint32_t component = 0; component < num_components; ++component) {
+    uint32_t first_word = closure.first_words_[component];
+    uint64_t *row = &closure.words_[closure.row_offsets_[component]];
+    if (sccs.is_cyclic[component]) {
+      row[component / 64 - first_word] |= uint64_t{1} << (component % 64);
+    }
+    // A successor that is reached through a larger successor adds nothing,
+    // so the successors are merged from the largest down, skipping those
+    // that are already set.
+    const std::vector<uint32_t> &component_successors = successors[component];
+    for (auto it = component_successors.rbegin();
+         it != component_successors.rend(); ++it) {
+      uint32_t successor = *it;
+      uint64_t bit = uint64_t{1} << (successor % 64);
+      uint64_t &successor_word = row[successor / 64 - first_word];
+      if (successor_word & bit) continue;
+      uint32_t successor_first_word = closure.first_words_[successor];
+      OrRow(&row[successor_first_word - first_word],
+            &closure.words_[closure.row_offsets_[successor]],
+            successor / 64 - successor_first_word + 1);
+      successor_word |= bit;
+    }
+  }
+  return closure;
+}
+
+bool TransitiveClosure::CanReach(uint32_t from, uint32_t to) const {
+  uint32_t from_component = component_of_node_[from];
+  uint32_t to_component = component_of_node_[to];
+  return to_component <= from_component && HasBit(from_component, to_component);
+}
+
+void TransitiveClosure::ForEachReachedComponent(
+    uint32_t component, absl::FunctionRef<void(uint32_t)> visit) const {
+  for (uint64_t i = row_offsets_[component]; i < row_offsets_[component + 1];
+       ++i) {
+    uint32_t first_component =
+        (first_words_[component] + i - row_offsets_[component]) * 64;
+    for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+      visit(first_component + absl::countr_zero(word));
+    }
+  }
+}
+
+void TransitiveClosure::ForEachReachable(
+    uint32_t from, absl::FunctionRef<void(uint32_t)> visit) const {
+  ForEachReachedComponent(
+      component_of_node_[from], [&](uint32_t reached_component) {
+        for (uint64_t i = node_offsets_[reached_component];
+             i < node_offsets_[reached_component + 1]; ++i) {
+          visit(nodes_[i]);
+        }
+      });
+}
+
+void TransitiveClosure::ForEachPath(
+    absl::FunctionRef<void(uint32_t from, uint32_t to)> visit) const {
+  for (uint32_t from = 0; from < component_of_node_.size(); ++from) {
+    ForEachReachable(from, [&](uint32_t to) { visit(from, to); });
+  }
+}
+
+uint64_t TransitiveClosure::NumPaths() const {
+  uint64_t num_paths = 0;
+  for (uint32_t component = 0; component < num_components(); ++component) {
+    uint64_t num_reached_nodes = 0;
+    ForEachReachedComponent(component, [&](uint32_t reached_component) {
+      num_reached_nodes += node_offsets_[reached_component + 1] -
+                           node_offsets_[reached_component];
+    });
+    num_paths += num_reached_nodes *
+                 (node_offsets_[component + 1] - node_offsets_[component]);
+  }
+  return num_paths;
+}
+
+}  // namespace raksha::xform_to_datalog
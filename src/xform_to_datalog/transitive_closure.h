@@ -0,0 +1,103 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_TRANSITIVE_CLOSURE_H_
+#define SRC_XFORM_TO_DATALOG_TRANSITIVE_CLOSURE_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/functional/function_ref.h"
+#include "src/xform_to_datalog/access_path_graph.h"
+
+namespace raksha::xform_to_datalog {
+
+// The transitive closure of a dataflow graph, as in the path relation of
+// dataflow_graph.dl, held as one row of bits per strongly connected
+// component rather than one tuple per pair of access paths.
+//
+// Components are numbered in reverse topological order, so the row of a
+// component only has bits for itself and the smaller components, and only
+// from the word of the smallest component it reaches. The rows are computed
+// in increasing order, each as the bitwise or of the rows of its
+// successors. The or runs over whole 64-bit words in a plain loop that the
+// compiler vectorizes for the target, be it AVX2 or NEON. As in
+// ReachabilityIndex, the claimNotEdge facts of the authorization logic are
+// not considered.
+//
+// Components are numbered in the order of a depth-first search, so that the
+// rows of separate recipes stay short. At worst, when every component
+// reaches every smaller one, the rows take C^2 / 16 bytes for C components:
+// 625 MB for a pipeline of 100k access paths. Use ReachabilityIndex for
+// single queries on such graphs.
+class TransitiveClosure {
+ public:
+  static TransitiveClosure Create(const AccessPathGraph &graph);
+
+  // Whether there is a path of one or more edges from node `from` to node
+  // `to`.
+  bool CanReach(uint32_t from, uint32_t to) const;
+
+  // Calls `visit` with each node that `from` can reach.
+  void ForEachReachable(uint32_t from,
+                        absl::FunctionRef<void(uint32_t)> visit) const;
+
+  // Calls `visit` with the nodes of each tuple of the path relation. This is
+  // how the relation is preloaded into programs compiled with
+  // `precomputed_paths`.
+  void ForEachPath(
+      absl::FunctionRef<void(uint32_t from, uint32_t to)> visit) const;
+
+  // The number of tuples of the path relation, counted without visiting
+  // them.
+  uint64_t NumPaths() const;
+
+  uint64_t num_nodes() const { return component_of_node_.size(); }
+  uint64_t num_components() const { return row_offsets_.size() - 1; }
+  // The size of the rows.
+  uint64_t num_bytes() const { return words_.size() * sizeof(uint64_t); }
+
+ private:
+  TransitiveClosure() = default;
+
+  bool HasBit(uint32_t component, uint32_t reached_component) const {
+    uint64_t word = reached_component / 64;
+    if (word < first_words_[component]) return false;
+    return (words_[row_offsets_[component] + word - first_words_[component]] >>
+            (reached_component % 64)) &
+           1;
+  }
+
+  // Calls `visit` with each component whose bit is set in the row of
+  // `component`.
+  void ForEachReachedComponent(uint32_t component,
+                               absl::FunctionRef<void(uint32_t)> visit) const;
+
+  std::vector<uint32_t> component_of_node_;
+  // The nodes of component `c` are
+  // nodes_[node_offsets_[c]..node_offsets_[c + 1]).
+  std::vector<uint64_t> node_offsets_;
+  std::vector<uint32_t> nodes_;
+  // The row of component `c` is words_[row_offsets_[c]..row_offsets_[c + 1])
+  // and holds the bits of the components from 64 * first_words_[c] on.
+  std::vector<uint64_t> row_offsets_;
+  std::vector<uint32_t> first_words_;
+  std::vector<uint64_t> words_;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_TRANSITIVE_CLOSURE_H_
@@ -0,0 +1,167 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/transitive_closure.h"
+
+#include <algorithm>
+#include <set>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "src/common/testing/gtest.h"
+
+namespace raksha::xform_to_datalog {
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+// a -> b -> c <-> d -> e, b -> f, and g alone with a self-loop.
+AccessPathGraph MakeGraph() {
+  AccessPathGraph graph;
+  for (absl::string_view name : {"a", "b", "c", "d", "e", "f", "g"}) {
+    graph.GetNode(std::string(name));
+  }
+  auto add_edge = [&graph](absl::string_view from, absl::string_view to) {
+    graph.AddEdge(*graph.FindNode(from), *graph.FindNode(to));
+  };
+  add_edge("a", "b");
+  add_edge("b", "c");
+  add_edge("c", "d");
+  add_edge("d", "c");
+  add_edge("d", "e");
+  add_edge("b", "f");
+  add_edge("g", "g");
+  return graph;
+}
+
+// A graph of `num_nodes` nodes with pseudo-random edges, spanning many words
+// per row, with a few cycles.
+AccessPathGraph MakeLargeGraph(uint32_t num_nodes) {
+  AccessPathGraph graph;
+  for (uint32_t node = 0; node < num_nodes; ++node) {
+    graph.GetNode(absl::StrCat("n", node));
+  }
+  uint64_t state = 1;
+  for (uint32_t i = 0; i < 2 * num_nodes; ++i) {
+    state = state * 6364136223846793005 + 1442695040888963407;
+    uint32_t from = (state >> 33) % num_nodes;
+    uint32_t to = (state >> 13) % num_nodes;
+    // Mostly forward edges, so that most components are single nodes.
+    if (to < from && i % 16 != 0) std::swap(from, to);
+    graph.AddEdge(from, to);
+  }
+  return graph;
+}
+
+// The pairs of the path relation, found by a search from every node.
+std::set<std::pair<uint32_t, uint32_t>> GetPathsBySearch(
+    const AccessPathGraph &graph) {
+  std::set<std::pair<uint32_t, uint32_t>> paths;
+  for (uint32_t from = 0; from < graph.num_nodes(); ++from) {
+    std::vector<uint32_t> stack(graph.successors(from).begin(),
+                                graph.successors(from).end());
+    while (!stack.empty()) {
+      uint32_t node = stack.back();
+      stack.pop_back();
+      if (!paths.insert({from, node}).second) continue;
+      for (uint32_t successor : graph.successors(node)) {
+        stack.push_back(successor);
+      }
+    }
+  }
+  return paths;
+}
+
+std::vector<std::string> GetReachableNames(const AccessPathGraph &graph,
+                                           const TransitiveClosure &closure,
+                                           absl::string_view from) {
+  std::vector<std::string> names;
+  closure.ForEachReachable(*graph.FindNode(from), [&](uint32_t node) {
+    names.push_back(graph.name(node));
+  });
+  std::sort(names.begin(), names.end());
+  return names;
+}
+
+TEST(TransitiveClosureTest, AnswersLikeThePathRelation) {
+  AccessPathGraph graph = MakeGraph();
+  TransitiveClosure closure = TransitiveClosure::Create(graph);
+  EXPECT_EQ(closure.num_nodes(), 7);
+  EXPECT_EQ(closure.num_components(), 6);
+  auto can_reach = [&](absl::string_view from, absl::string_view to) {
+    return closure.CanReach(*graph.FindNode(from), *graph.FindNode(to));
+  };
+  EXPECT_TRUE(can_reach("a", "e"));
+  EXPECT_TRUE(can_reach("a", "f"));
+  EXPECT_TRUE(can_reach("d", "c"));
+  EXPECT_TRUE(can_reach("c", "c"));
+  EXPECT_TRUE(can_reach("g", "g"));
+  EXPECT_FALSE(can_reach("a", "a"));
+  EXPECT_FALSE(can_reach("f", "e"));
+  EXPECT_FALSE(can_reach("e", "a"));
+  EXPECT_FALSE(can_reach("a", "g"));
+}
+
+TEST(TransitiveClosureTest, VisitsReachableNodes) {
+  AccessPathGraph graph = MakeGraph();
+  TransitiveClosure closure = TransitiveClosure::Create(graph);
+  EXPECT_THAT(GetReachableNames(graph, closure, "a"),
+              ElementsAre("b", "c", "d", "e", "f"));
+  EXPECT_THAT(GetReachableNames(graph, closure, "c"),
+              ElementsAre("c", "d", "e"));
+  EXPECT_THAT(GetReachableNames(graph, closure, "g"), ElementsAre("g"));
+  EXPECT_THAT(GetReachableNames(graph, closure, "e"), IsEmpty());
+}
+
+TEST(TransitiveClosureTest, HasThePathsOfASearch) {
+  AccessPathGraph graph = MakeLargeGraph(500);
+  TransitiveClosure closure = TransitiveClosure::Create(graph);
+  EXPECT_GT(closure.num_components(), 64);
+  std::set<std::pair<uint32_t, uint32_t>> paths;
+  closure.ForEachPath([&](uint32_t from, uint32_t to) {
+    EXPECT_TRUE(paths.insert({from, to}).second);
+  });
+  EXPECT_EQ(paths, GetPathsBySearch(graph));
+  EXPECT_EQ(closure.NumPaths(), paths.size());
+}
+
+TEST(TransitiveClosureTest, StoresATriangleOfBitsForAPipeline) {
+  AccessPathGraph graph;
+  for (uint32_t node = 0; node < 130; ++node) {
+    graph.GetNode(absl::StrCat("n", node));
+    if (node > 0) graph.AddEdge(node - 1, node);
+  }
+  TransitiveClosure closure = TransitiveClosure::Create(graph);
+  // Rows of one word for components 0-63, two for 64-127 and three for the
+  // last two.
+  EXPECT_EQ(closure.num_bytes(), (64 * 1 + 64 * 2 + 2 * 3) * 8);
+  EXPECT_EQ(closure.NumPaths(), 130 * 129 / 2);
+}
+
+TEST(TransitiveClosureTest, StoresShortRowsForSeparatePipelines) {
+  AccessPathGraph graph;
+  for (uint32_t node = 0; node < 130; ++node) {
+    graph.GetNode(absl::StrCat("n", node));
+    if (node % 2 == 1) graph.AddEdge(node - 1, node);
+  }
+  TransitiveClosure closure = TransitiveClosure::Create(graph);
+  EXPECT_EQ(closure.num_bytes(), 130 * 8);
+  EXPECT_EQ(closure.NumPaths(), 65);
+  EXPECT_TRUE(closure.CanReach(128, 129));
+  EXPECT_FALSE(closure.CanReach(128, 1));
+}
+
+}  // namespace raksha::xform_to_datalog
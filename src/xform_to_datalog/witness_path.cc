@@ -0,0 +1,237 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/witness_path.h"
+
+#include "absl/strings/str_cat.h"
+#include "src/ir/access_path_root.h"
+#include "src/ir/datalog_print_context.h"
+#include "src/ir/tag_check.h"
+
+namespace raksha::xform_to_datalog {
+
+namespace {
+
+// Returns the handle connection that the root of `access_path` stands for
+// in `particle`, or an empty string if it is a handle.
+std::string GetConnectionName(const ir::AccessPath &access_path,
+                              const ManifestDatalogFacts::Particle &particle) {
+  const ir::AccessPathRoot *root = &access_path.root();
+  auto find_result = particle.instantiation_map().find(*root);
+  if (find_result != particle.instantiation_map().end()) {
+    root = &find_result->second;
+  }
+  if (const auto *connection_root =
+          std::get_if<ir::HandleConnectionAccessPathRoot>(
+              &root->GetRootVariant())) {
+    return connection_root->handle_connection_name();
+  }
+  if (const auto *spec_root =
+          std::get_if<ir::HandleConnectionSpecAccessPathRoot>(
+              &root->GetRootVariant())) {
+    return spec_root->handle_connection_spec_name();
+  }
+  return "";
+}
+
+// Returns the name of `particle` in its recipe, such as "P#2".
+std::string GetParticleName(const ManifestDatalogFacts::Particle &particle) {
+  for (const auto &[spec_root, instance_root] :
+       particle.instantiation_map()) {
+    if (const auto *connection_root =
+            std::get_if<ir::HandleConnectionAccessPathRoot>(
+                &instance_root.GetRootVariant())) {
+      return connection_root->particle_name();
+    }
+  }
+  return particle.spec()->name();
+}
+
+}  // namespace
+
+std::string WitnessPath::ToString() const {
+  std::string result =
+      absl::StrCat(tag, " is claimed on ", claim_access_path, " by ",
+                   claim_recipe, ".", claim_particle, "\n");
+  for (const WitnessEdge &edge : edges) {
+    if (edge.particle.empty()) {
+      absl::StrAppend(&result, "  ", edge.from, " -> ", edge.to,
+                      " (member)\n");
+    } else {
+      absl::StrAppend(&result, "  ", edge.from, " -> ", edge.to, " (",
+                      edge.recipe, ".", edge.particle, ")\n");
+    }
+  }
+  return result;
+}
+
+uint32_t WitnessPathExplainer::GetNode(std::string name,
+                                       std::string connection) {
+  auto insert_result = node_ids_.insert({name, nodes_.size()});
+  if (insert_result.second) {
+    nodes_.push_back(
+        Node{.name = std::move(name),
+             .connection = std::move(connection),
+             .in_edges = {}});
+  }
+  return insert_result.first->second;
+}
+
+uint32_t WitnessPathExplainer::GetTag(absl::string_view tag) {
+  return tag_ids_.insert({std::string(tag), tag_ids_.size()}).first->second;
+}
+
+WitnessPathExplainer WitnessPathExplainer::Create(
+    const ManifestDatalogFacts &manifest_facts) {
+  WitnessPathExplainer explainer;
+  ir::DatalogPrintContext ctxt;
+  auto add_edge = [&](const ir::AccessPath &from, const ir::AccessPath &to,
+                      const ManifestDatalogFacts::Particle &particle,
+                      uint32_t particle_index) {
+    // Number the source first, as the order in which arguments are
+    // evaluated is unspecified.
+    uint32_t from_node = explainer.GetNode(from.ToDatalog(ctxt),
+                                           GetConnectionName(from, particle));
+    uint32_t to_node =
+        explainer.GetNode(to.ToDatalog(ctxt), GetConnectionName(to, particle));
+    explainer.nodes_[to_node].in_edges.push_back(explainer.edges_.size());
+    explainer.edges_.push_back(
+        Edge{.from = from_node, .to = to_node, .particle = particle_index});
+  };
+  for (const auto &particle : manifest_facts.particle_instances()) {
+    ctxt.set_instantiation_map(&particle.instantiation_map());
+    uint32_t particle_index = explainer.particles_.size();
+    explainer.particles_.push_back(Particle{
+        .recipe = particle.recipe_name(), .name = GetParticleName(particle)});
+    for (const ir::Edge &edge : particle.edges()) {
+      add_edge(edge.from(), edge.to(), particle, particle_index);
+    }
+    for (const ir::Edge &edge : particle.spec()->edges()) {
+      add_edge(edge.from(), edge.to(), particle, particle_index);
+    }
+    for (const ir::TagClaim &claim : particle.spec()->tag_claims()) {
+      uint32_t node =
+          explainer.GetNode(claim.access_path().ToDatalog(ctxt),
+                            GetConnectionName(claim.access_path(), particle));
+      uint64_t key = NodeTagKey(node, explainer.GetTag(claim.tag()));
+      if (claim.claim_tag_is_present()) {
+        explainer.has_tag_claims_.insert(
+            {key, Claim{.node = node, .particle = particle_index}});
+      } else {
+        explainer.remove_tag_claims_.insert(key);
+      }
+    }
+    // The access paths of checks need not be on any edge, yet their members
+    // may be.
+    for (const ir::TagCheck &check : particle.spec()->checks()) {
+      explainer.GetNode(check.access_path().ToDatalog(ctxt),
+                        GetConnectionName(check.access_path(), particle));
+    }
+  }
+  // Link every access path to the ones it is a member of, which are its
+  // prefixes up to a '.', as isMemberOf of taint.dl does.
+  for (uint32_t member = 0; member < explainer.nodes_.size(); ++member) {
+    absl::string_view name = explainer.nodes_[member].name;
+    for (size_t dot = name.find('.'); dot != absl::string_view::npos;
+         dot = name.find('.', dot + 1)) {
+      auto find_result = explainer.node_ids_.find(name.substr(0, dot));
+      if (find_result == explainer.node_ids_.end()) continue;
+      uint32_t base = find_result->second;
+      explainer.nodes_[base].member_edges.push_back(explainer.edges_.size());
+      explainer.edges_.push_back(
+          Edge{.from = member, .to = base, .particle = kNoParticle});
+    }
+  }
+  return explainer;
+}
+
+std::optional<WitnessPath> WitnessPathExplainer::Explain(
+    absl::string_view access_path, absl::string_view tag,
+    const WitnessSearchLimits &limits) const {
+  auto node_result = node_ids_.find(access_path);
+  auto tag_result = tag_ids_.find(tag);
+  if (node_result == node_ids_.end() || tag_result == tag_ids_.end()) {
+    return std::nullopt;
+  }
+  uint32_t tag_id = tag_result->second;
+
+  // A breadth-first search backwards along the edges, so that the first
+  // claim found is one of the nearest. `next_edges` maps each visited
+  // access path to the edge it was reached from, which leads towards
+  // `access_path`.
+  constexpr uint32_t kNoEdge = ~uint32_t{0};
+  absl::flat_hash_map<uint32_t, uint32_t> next_edges = {
+      {node_result->second, kNoEdge}};
+  std::vector<uint32_t> frontier = {node_result->second};
+  std::vector<uint32_t> next_frontier;
+  const Claim *claim = nullptr;
+  for (uint64_t num_edges = 0;; ++num_edges) {
+    for (uint32_t node : frontier) {
+      auto find_result = has_tag_claims_.find(NodeTagKey(node, tag_id));
+      if (find_result != has_tag_claims_.end()) {
+        claim = &find_result->second;
+        break;
+      }
+    }
+    if (claim != nullptr) break;
+    if (frontier.empty() || num_edges == limits.max_edges) return std::nullopt;
+    next_frontier.clear();
+    auto visit = [&](uint32_t edge_index) {
+      if (!next_edges.insert({edges_[edge_index].from, edge_index}).second) {
+        return true;
+      }
+      next_frontier.push_back(edges_[edge_index].from);
+      return next_edges.size() <= limits.max_visited;
+    };
+    for (uint32_t node : frontier) {
+      for (uint32_t edge_index : nodes_[node].member_edges) {
+        if (!visit(edge_index)) return std::nullopt;
+      }
+      // A removed tag does not flow into the access path along edges.
+      if (remove_tag_claims_.contains(NodeTagKey(node, tag_id))) continue;
+      for (uint32_t edge_index : nodes_[node].in_edges) {
+        if (!visit(edge_index)) return std::nullopt;
+      }
+    }
+    std::swap(frontier, next_frontier);
+  }
+
+  const Particle &claim_particle = particles_[claim->particle];
+  WitnessPath path{.tag = std::string(tag),
+                   .claim_access_path = nodes_[claim->node].name,
+                   .claim_recipe = claim_particle.recipe,
+                   .claim_particle = claim_particle.name,
+                   .claim_connection = nodes_[claim->node].connection,
+                   .edges = {}};
+  for (uint32_t edge_index = next_edges.at(claim->node); edge_index != kNoEdge;
+       edge_index = next_edges.at(edges_[edge_index].to)) {
+    const Edge &edge = edges_[edge_index];
+    WitnessEdge witness_edge{.from = nodes_[edge.from].name,
+                             .to = nodes_[edge.to].name,
+                             .recipe = "",
+                             .particle = "",
+                             .from_connection = nodes_[edge.from].connection,
+                             .to_connection = nodes_[edge.to].connection};
+    if (edge.particle != kNoParticle) {
+      witness_edge.recipe = particles_[edge.particle].recipe;
+      witness_edge.particle = particles_[edge.particle].name;
+    }
+    path.edges.push_back(std::move(witness_edge));
+  }
+  return path;
+}
+
+}  // namespace raksha::xform_to_datalog
@@ -0,0 +1,161 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#ifndef SRC_XFORM_TO_DATALOG_WITNESS_PATH_H_
+#define SRC_XFORM_TO_DATALOG_WITNESS_PATH_H_
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/flat_hash_set.h"
+#include "absl/strings/string_view.h"
+#include "src/xform_to_datalog/manifest_datalog_facts.h"
+
+namespace raksha::xform_to_datalog {
+
+// A dataflow edge of a witness path, or a step from a member of an access
+// path to the access path, to which taint.dl lifts the tags of its members.
+struct WitnessEdge {
+  std::string from;
+  std::string to;
+  // The particle whose handle connections or flows the edge comes from.
+  // Both are empty for a step from a member to its base.
+  std::string recipe;
+  std::string particle;
+  // The handle connections of the particle at the ends of the edge. They
+  // are empty for the ends that are handles.
+  std::string from_connection;
+  std::string to_connection;
+
+  bool operator==(const WitnessEdge &other) const {
+    return from == other.from && to == other.to && recipe == other.recipe &&
+           particle == other.particle &&
+           from_connection == other.from_connection &&
+           to_connection == other.to_connection;
+  }
+};
+
+// How a tag may reach an access path: the claim that adds the tag, and the
+// edges that it flows along from the claimed access path to the given one.
+struct WitnessPath {
+  std::string tag;
+  std::string claim_access_path;
+  std::string claim_recipe;
+  std::string claim_particle;
+  std::string claim_connection;
+  // In the direction of the flow. Empty if the tag is claimed on the given
+  // access path itself.
+  std::vector<WitnessEdge> edges;
+
+  // Returns the path as text, with the claim on the first line and one edge
+  // per line after it.
+  std::string ToString() const;
+};
+
+// Bounds on the search for a witness path.
+struct WitnessSearchLimits {
+  // The most edges of a returned path.
+  uint64_t max_edges = 1000;
+  // The most access paths to visit before giving up.
+  uint64_t max_visited = 1000000;
+};
+
+// Explains the mayHaveTag tuples behind failed checks without running the
+// analysis in provenance mode. It searches the instantiated dataflow graph
+// backwards from an access path for the nearest says_hasTag claim of a tag,
+// not passing through access paths with a says_removeTag claim of it, as
+// the rules of taint.dl propagate tags. As in taint.dl, an access path may
+// also have a tag that one of its members, such as a field, may have.
+//
+// The facts of the authorization logic, such as ownership, delegation and
+// claimNotEdge, are not considered: a witness path is the shortest path
+// that the analysis may have used, if the claims on it are believed for the
+// owner in question.
+class WitnessPathExplainer {
+ public:
+  static WitnessPathExplainer Create(
+      const ManifestDatalogFacts &manifest_facts);
+
+  // Returns the shortest witness path of `tag` reaching `access_path`, as
+  // printed in the isCheck fact of a check, or std::nullopt if there is
+  // none within `limits`.
+  std::optional<WitnessPath> Explain(
+      absl::string_view access_path, absl::string_view tag,
+      const WitnessSearchLimits &limits = WitnessSearchLimits()) const;
+
+  uint64_t num_access_paths() const { return nodes_.size(); }
+  uint64_t num_edges() const { return edges_.size(); }
+
+ private:
+  struct Node {
+    std::string name;
+    // The handle connection of the access path, or empty for handles.
+    std::string connection;
+    // The indices in edges_ of the edges into the access path.
+    std::vector<uint32_t> in_edges;
+    // The indices in edges_ of the steps from the members of the access
+    // path. Unlike edges, they carry tags that are removed from the access
+    // path itself.
+    std::vector<uint32_t> member_edges;
+  };
+
+  struct Edge {
+    uint32_t from;
+    uint32_t to;
+    // The index of the particle in particles_, or kNoParticle for the step
+    // from a member to its base.
+    uint32_t particle;
+  };
+
+  static constexpr uint32_t kNoParticle = ~uint32_t{0};
+
+  struct Particle {
+    std::string recipe;
+    std::string name;
+  };
+
+  // A says_hasTag claim.
+  struct Claim {
+    uint32_t node;
+    uint32_t particle;
+  };
+
+  WitnessPathExplainer() = default;
+
+  uint32_t GetNode(std::string name, std::string connection);
+  // Returns the id of `tag`, adding it if it is new.
+  uint32_t GetTag(absl::string_view tag);
+
+  static uint64_t NodeTagKey(uint32_t node, uint32_t tag) {
+    return (static_cast<uint64_t>(node) << 32) | tag;
+  }
+
+  std::vector<Node> nodes_;
+  absl::flat_hash_map<std::string, uint32_t> node_ids_;
+  std::vector<Edge> edges_;
+  std::vector<Particle> particles_;
+  absl::flat_hash_map<std::string, uint32_t> tag_ids_;
+  // The claims by the keys of their access paths and tags.
+  absl::flat_hash_map<uint64_t, Claim> has_tag_claims_;
+  absl::flat_hash_set<uint64_t> remove_tag_claims_;
+};
+
+}  // namespace raksha::xform_to_datalog
+
+#endif  // SRC_XFORM_TO_DATALOG_WITNESS_PATH_H_
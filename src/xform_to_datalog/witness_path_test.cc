@@ -0,0 +1,236 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+
+#include "src/xform_to_datalog/witness_path.h"
+
+#include <google/protobuf/text_format.h>
+
+#include "src/common/testing/gtest.h"
+#include "src/ir/proto/system_spec.h"
+
+namespace raksha::xform_to_datalog {
+
+// In recipe R, a tag claimed by a Source reaches a Sink through a Relay. In
+// recipe C, a Cleaner removes it on the way.
+static const char kManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "Source" connections: [
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: { particle_spec: "Source", handle_connection: "out" } }
+            predicate: { label: { semantic_tag: "tag"} } } } ] },
+    { name: "Relay" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } },
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ] },
+    { name: "Cleaner" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } },
+        { name: "out" direction: WRITES type: { primitive: TEXT } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: { particle_spec: "Cleaner", handle_connection: "out" } }
+            predicate: { not: { predicate: {
+              label: { semantic_tag: "tag"} } } } } } ] },
+    { name: "Sink" connections: [
+        { name: "in" direction: READS type: { primitive: TEXT } } ] } ]
+    recipes: [
+      { name: "R"
+        particles: [
+          { spec_name: "Source" connections: [
+              { name: "out" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Relay" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } },
+              { name: "out" handle: "h2" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h2" type: { primitive: TEXT } } ] } ] },
+      { name: "C"
+        particles: [
+          { spec_name: "Source" connections: [
+              { name: "out" handle: "h1" type: { primitive: TEXT } } ] },
+          { spec_name: "Cleaner" connections: [
+              { name: "in" handle: "h1" type: { primitive: TEXT } },
+              { name: "out" handle: "h2" type: { primitive: TEXT } } ] },
+          { spec_name: "Sink" connections: [
+              { name: "in" handle: "h2" type: { primitive: TEXT } } ] } ] } ]
+)";
+
+class WitnessPathExplainerTest : public testing::Test {
+ public:
+  WitnessPathExplainerTest() {
+    arcs::ManifestProto manifest_proto;
+    CHECK(google::protobuf::TextFormat::ParseFromString(kManifestTextproto,
+                                                        &manifest_proto));
+    system_spec_ = ir::proto::Decode(manifest_proto);
+    CHECK(system_spec_ != nullptr);
+    explainer_.emplace(WitnessPathExplainer::Create(
+        ManifestDatalogFacts::CreateFromManifestProto(*system_spec_,
+                                                      manifest_proto)));
+  }
+
+ protected:
+  std::unique_ptr<ir::SystemSpec> system_spec_;
+  std::optional<WitnessPathExplainer> explainer_;
+};
+
+TEST_F(WitnessPathExplainerTest, FindsTheEdgesFromTheClaim) {
+  std::optional<WitnessPath> path = explainer_->Explain("R.Sink#2.in", "tag");
+  ASSERT_TRUE(path.has_value());
+  EXPECT_EQ(path->tag, "tag");
+  EXPECT_EQ(path->claim_access_path, "R.Source#0.out");
+  EXPECT_EQ(path->claim_recipe, "R");
+  EXPECT_EQ(path->claim_particle, "Source#0");
+  EXPECT_EQ(path->claim_connection, "out");
+  EXPECT_THAT(
+      path->edges,
+      testing::ElementsAre(
+          WitnessEdge{.from = "R.Source#0.out",
+                      .to = "R.h1",
+                      .recipe = "R",
+                      .particle = "Source#0",
+                      .from_connection = "out",
+                      .to_connection = ""},
+          WitnessEdge{.from = "R.h1",
+                      .to = "R.Relay#1.in",
+                      .recipe = "R",
+                      .particle = "Relay#1",
+                      .from_connection = "",
+                      .to_connection = "in"},
+          WitnessEdge{.from = "R.Relay#1.in",
+                      .to = "R.Relay#1.out",
+                      .recipe = "R",
+                      .particle = "Relay#1",
+                      .from_connection = "in",
+                      .to_connection = "out"},
+          WitnessEdge{.from = "R.Relay#1.out",
+                      .to = "R.h2",
+                      .recipe = "R",
+                      .particle = "Relay#1",
+                      .from_connection = "out",
+                      .to_connection = ""},
+          WitnessEdge{.from = "R.h2",
+                      .to = "R.Sink#2.in",
+                      .recipe = "R",
+                      .particle = "Sink#2",
+                      .from_connection = "",
+                      .to_connection = "in"}));
+}
+
+TEST_F(WitnessPathExplainerTest, ExplainsAClaimOnTheAccessPath) {
+  std::optional<WitnessPath> path =
+      explainer_->Explain("R.Source#0.out", "tag");
+  ASSERT_TRUE(path.has_value());
+  EXPECT_EQ(path->claim_access_path, "R.Source#0.out");
+  EXPECT_TRUE(path->edges.empty());
+}
+
+TEST_F(WitnessPathExplainerTest, DoesNotPassRemovedTags) {
+  std::optional<WitnessPath> path = explainer_->Explain("C.Cleaner#1.in", "tag");
+  ASSERT_TRUE(path.has_value());
+  EXPECT_EQ(path->edges.size(), 2);
+  EXPECT_EQ(explainer_->Explain("C.Cleaner#1.out", "tag"), std::nullopt);
+  EXPECT_EQ(explainer_->Explain("C.Sink#2.in", "tag"), std::nullopt);
+}
+
+TEST_F(WitnessPathExplainerTest, StopsAtTheLimits) {
+  EXPECT_EQ(explainer_->Explain("R.Sink#2.in", "tag",
+                                WitnessSearchLimits{.max_edges = 4}),
+            std::nullopt);
+  EXPECT_TRUE(explainer_
+                  ->Explain("R.Sink#2.in", "tag",
+                            WitnessSearchLimits{.max_edges = 5})
+                  .has_value());
+  EXPECT_EQ(explainer_->Explain("R.Sink#2.in", "tag",
+                                WitnessSearchLimits{.max_visited = 2}),
+            std::nullopt);
+}
+
+TEST_F(WitnessPathExplainerTest, DoesNotExplainUnknownPathsOrTags) {
+  EXPECT_EQ(explainer_->Explain("R.Unknown#9.in", "tag"), std::nullopt);
+  EXPECT_EQ(explainer_->Explain("R.Sink#2.in", "other"), std::nullopt);
+}
+
+TEST_F(WitnessPathExplainerTest, PrintsThePath) {
+  std::optional<WitnessPath> path =
+      explainer_->Explain("R.Relay#1.in", "tag");
+  ASSERT_TRUE(path.has_value());
+  EXPECT_EQ(path->ToString(),
+            "tag is claimed on R.Source#0.out by R.Source#0\n"
+            "  R.Source#0.out -> R.h1 (R.Source#0)\n"
+            "  R.h1 -> R.Relay#1.in (R.Relay#1)\n");
+}
+
+// A tag claimed on a field of the output of a FieldSource reaches the same
+// field of the input of a FieldSink, whose check is on the whole input.
+static const char kFieldManifestTextproto[] = R"(
+    particle_specs: [
+    { name: "FieldSource" connections: [
+        { name: "out" direction: WRITES type: { entity: { schema: { fields: [
+            { key: "secret", value: { primitive: TEXT } } ] } } } } ]
+      claims: [
+        { assume: {
+            access_path: {
+              handle: {
+                particle_spec: "FieldSource", handle_connection: "out" }
+              selectors: [ { field: "secret" } ] }
+            predicate: { label: { semantic_tag: "tag"} } } } ] },
+    { name: "FieldSink" connections: [
+        { name: "in" direction: READS type: { entity: { schema: { fields: [
+            { key: "secret", value: { primitive: TEXT } } ] } } } } ]
+      checks: [
+        { access_path: {
+            handle: { particle_spec: "FieldSink", handle_connection: "in" } }
+          predicate: { label: { semantic_tag: "tag"} } } ] } ]
+    recipes: [
+      { name: "F"
+        particles: [
+          { spec_name: "FieldSource" connections: [
+              { name: "out" handle: "h" type: { entity: { schema: { fields: [
+                  { key: "secret", value: { primitive: TEXT } } ] } } } } ] },
+          { spec_name: "FieldSink" connections: [
+              { name: "in" handle: "h" type: { entity: { schema: { fields: [
+                  { key: "secret", value: { primitive: TEXT } } ] } } } } ] }
+        ] } ]
+)";
+
+TEST(WitnessPathExplainerFieldTest, LiftsTagsFromMembers) {
+  arcs::ManifestProto manifest_proto;
+  ASSERT_TRUE(google::protobuf::TextFormat::ParseFromString(
+      kFieldManifestTextproto, &manifest_proto));
+  std::unique_ptr<ir::SystemSpec> system_spec =
+      ir::proto::Decode(manifest_proto);
+  WitnessPathExplainer explainer = WitnessPathExplainer::Create(
+      ManifestDatalogFacts::CreateFromManifestProto(*system_spec,
+                                                    manifest_proto));
+  std::optional<WitnessPath> path =
+      explainer.Explain("F.FieldSink#1.in", "tag");
+  ASSERT_TRUE(path.has_value());
+  EXPECT_EQ(path->claim_access_path, "F.FieldSource#0.out.secret");
+  ASSERT_FALSE(path->edges.empty());
+  EXPECT_EQ(path->edges.back(),
+            (WitnessEdge{.from = "F.FieldSink#1.in.secret",
+                         .to = "F.FieldSink#1.in",
+                         .recipe = "",
+                         .particle = "",
+                         .from_connection = "in",
+                         .to_connection = "in"}));
+  EXPECT_THAT(path->ToString(),
+              testing::EndsWith(
+                  "  F.FieldSink#1.in.secret -> F.FieldSink#1.in (member)\n"));
+}
+
+}  // namespace raksha::xform_to_datalog
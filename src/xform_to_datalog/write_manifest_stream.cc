@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+// Copyright 2021 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//-----------------------------------------------------------------------------
+// Tool that converts a manifest proto to a manifest stream, which
+// generate_datalog_program reads with --manifest_stream one recipe at a
+// time. Producers of very large manifests should write manifest streams
+// directly rather than converting them, as this tool needs the whole
+// manifest in memory.
+
+#include <filesystem>
+#include <fstream>
+
+#include "absl/flags/flag.h"
+#include "absl/flags/parse.h"
+#include "absl/flags/usage.h"
+#include "src/common/logging/logging.h"
+#include "src/ir/proto/manifest_file.h"
+#include "src/ir/proto/manifest_stream.h"
+
+ABSL_FLAG(std::string, manifest_proto, "", "The manifest proto file.");
+ABSL_FLAG(std::string, manifest_stream, "",
+          "The manifest stream file to write.");
+
+constexpr char kUsageMessage[] =
+    "This tool converts a manifest proto to a manifest stream of "
+    "length-delimited records: the particle specs, then one recipe per "
+    "record.";
+
+int main(int argc, char *argv[]) {
+  google::InitGoogleLogging("write_manifest_stream");
+  absl::SetProgramUsageMessage(kUsageMessage);
+  absl::ParseCommandLine(argc, argv);
+
+  std::filesystem::path manifest_filepath(absl::GetFlag(FLAGS_manifest_proto));
+  std::unique_ptr<raksha::ir::proto::ManifestFile> manifest_file =
+      raksha::ir::proto::ManifestFile::Load(manifest_filepath);
+  if (manifest_file == nullptr) return 1;
+
+  std::filesystem::path manifest_stream_filepath(
+      absl::GetFlag(FLAGS_manifest_stream));
+  std::ofstream manifest_stream(
+      manifest_stream_filepath,
+      std::ios::out | std::ios::trunc | std::ios::binary);
+  if (!manifest_stream ||
+      !raksha::ir::proto::WriteManifestStream(manifest_file->manifest_proto(),
+                                              manifest_stream)) {
+    LOG(ERROR) << "Error writing " << manifest_stream_filepath << " :"
+               << strerror(errno);
+    return 1;
+  }
+  return 0;
+}